@@ -7,10 +7,10 @@ namespace pe_bliss
 //Calculates entropy for PE image section
 double entropy_calculator::calculate_entropy(const section& s)
 {
-	if(s.get_raw_data().empty()) //Don't count entropy for empty sections
+	if(s.get_raw_data_length() == 0) //Don't count entropy for empty sections
 		throw pe_exception("Section is empty", pe_exception::section_is_empty);
 
-	return calculate_entropy(s.get_raw_data().data(), s.get_raw_data().length());
+	return calculate_entropy(s.get_raw_data_ptr(), s.get_raw_data_length());
 }
 
 //Calculates entropy for istream (from current position of stream)
@@ -63,8 +63,8 @@ double entropy_calculator::calculate_entropy(const pe_base& pe)
 	//Count bytes for each section
 	for(section_list::const_iterator it = pe.get_image_sections().begin(); it != pe.get_image_sections().end(); ++it)
 	{
-		const std::string& data = (*it).get_raw_data();
-		size_t length = data.length();
+		const char* data = (*it).get_raw_data_ptr();
+		size_t length = (*it).get_raw_data_length();
 		total_data_length += length;
 		for(size_t i = 0; i != length; ++i)
 			++byte_count[static_cast<unsigned char>(data[i])];
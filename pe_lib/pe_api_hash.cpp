@@ -0,0 +1,339 @@
+#include <algorithm>
+#include "pe_api_hash.h"
+#include "utils.h"
+
+namespace pe_bliss
+{
+//Default constructor
+api_hash_match::api_hash_match()
+	:query_index_(0), hash_(0), algorithm_(0), module_index_(0), ordinal_(0), name_offset_(0)
+{}
+
+//Returns index of looked up hash in batch (zero for single lookups)
+std::size_t api_hash_match::get_query_index() const
+{
+	return query_index_;
+}
+
+//Returns hash
+uint32_t api_hash_match::get_hash() const
+{
+	return hash_;
+}
+
+//Returns algorithm, which produced hash
+uint32_t api_hash_match::get_algorithm() const
+{
+	return algorithm_;
+}
+
+//Returns index of module, which exports function
+uint16_t api_hash_match::get_module_index() const
+{
+	return module_index_;
+}
+
+//Returns ordinal of function
+uint16_t api_hash_match::get_ordinal() const
+{
+	return ordinal_;
+}
+
+//Returns offset of function name in names of table
+uint32_t api_hash_match::get_name_offset() const
+{
+	return name_offset_;
+}
+
+//Sets index of looked up hash in batch
+void api_hash_match::set_query_index(std::size_t index)
+{
+	query_index_ = index;
+}
+
+//Sets hash and algorithm
+void api_hash_match::set_hash(uint32_t hash, uint32_t algorithm)
+{
+	hash_ = hash;
+	algorithm_ = algorithm;
+}
+
+//Sets module index, function ordinal and name offset
+void api_hash_match::set_function(uint16_t module_index, uint16_t ordinal, uint32_t name_offset)
+{
+	module_index_ = module_index;
+	ordinal_ = ordinal;
+	name_offset_ = name_offset;
+}
+
+bool api_hash_table::entry::operator<(const entry& other) const
+{
+	return hash < other.hash;
+}
+
+//Helper: rotates value right by 13 bits
+inline uint32_t ror13(uint32_t value)
+{
+	return (value >> 13) | (value << 19);
+}
+
+//Helper: computes reflected CRC-32 with polynomial "polynomial"
+uint32_t crc32_reflected(const char* data, std::size_t length, uint32_t polynomial)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for(std::size_t i = 0; i != length; ++i)
+	{
+		crc ^= static_cast<uint8_t>(data[i]);
+		for(int bit = 0; bit != 8; ++bit)
+			crc = (crc >> 1) ^ (polynomial & (0 - (crc & 1)));
+	}
+
+	return ~crc;
+}
+
+//Returns hash of name with "length" bytes
+uint32_t api_hash_table::hash(hash_algorithm algorithm, const char* name, std::size_t length, const char* module_name, std::size_t module_name_length)
+{
+	uint32_t ret = 0;
+	switch(algorithm)
+	{
+	case hash_ror13:
+		for(std::size_t i = 0; i != length; ++i)
+			ret = ror13(ret) + static_cast<uint8_t>(name[i]);
+		break;
+
+	case hash_ror13_module:
+		{
+			//Module name is hashed as upper case UTF-16 string with terminating null
+			uint32_t module_hash = 0;
+			for(std::size_t i = 0; i != module_name_length; ++i)
+			{
+				uint8_t c = static_cast<uint8_t>(module_name[i]);
+				if(c >= 'a')
+					c -= 0x20;
+
+				module_hash = ror13(ror13(module_hash) + c);
+			}
+
+			module_hash = ror13(ror13(module_hash));
+			ret = module_hash + hash(hash_ror13, name, length);
+		}
+		break;
+
+	case hash_crc32:
+		ret = crc32_reflected(name, length, 0xEDB88320);
+		break;
+
+	case hash_crc32c:
+		ret = crc32_reflected(name, length, 0x82F63B78);
+		break;
+
+	case hash_djb2:
+		ret = 5381;
+		for(std::size_t i = 0; i != length; ++i)
+			ret = ret * 33 + static_cast<uint8_t>(name[i]);
+		break;
+
+	case hash_fnv1a:
+		ret = 2166136261u;
+		for(std::size_t i = 0; i != length; ++i)
+		{
+			ret ^= static_cast<uint8_t>(name[i]);
+			ret *= 16777619u;
+		}
+		break;
+
+	default:
+		throw pe_exception("Unknown hash algorithm", pe_exception::unknown_error);
+	}
+
+	return ret;
+}
+
+//Constructor
+api_hash_table::api_hash_table(uint32_t algorithms)
+	:algorithms_(algorithms & all_hash_algorithms), sorted_count_(0)
+{}
+
+//Adds names of exported functions of module "module_name"
+uint16_t api_hash_table::add_module(const std::string& module_name, const exported_functions_list& exports)
+{
+	if(modules_.size() > pe_utils::max_word)
+		throw pe_exception("Too many modules", pe_exception::unknown_error);
+
+	uint16_t module_index = static_cast<uint16_t>(modules_.size());
+
+	//New entries are hashed and appended to table, they are sorted once by finalize()
+	std::size_t entries_size = entries_.size();
+	std::size_t names_length = names_.length();
+	try
+	{
+		for(exported_functions_list::const_iterator it = exports.begin(); it != exports.end(); ++it)
+		{
+			if(!(*it).has_name())
+				continue;
+
+			const std::string& name = (*it).get_name();
+			if(names_.length() > static_cast<uint32_t>(-1) - name.length() - 1)
+				throw pe_exception("Too many names", pe_exception::unknown_error);
+
+			entry e;
+			e.name_offset = static_cast<uint32_t>(names_.length());
+			e.module_index = module_index;
+			e.ordinal = (*it).get_ordinal();
+			names_.append(name);
+			names_.push_back('\0');
+
+			for(uint32_t algorithm = 1; algorithm <= all_hash_algorithms; algorithm <<= 1)
+			{
+				if(!(algorithms_ & algorithm))
+					continue;
+
+				e.algorithm = algorithm;
+				e.hash = hash(static_cast<hash_algorithm>(algorithm), name.c_str(),
+					name.length() + (algorithm == hash_ror13_module ? 1 : 0),
+					module_name.data(), module_name.length());
+				entries_.push_back(e);
+			}
+		}
+
+		modules_.push_back(module_name);
+	}
+	catch(...)
+	{
+		//Table stays correct if exception was thrown
+		entries_.resize(entries_size);
+		names_.resize(names_length);
+		throw;
+	}
+
+	return module_index;
+}
+
+//Adds names of exported functions of image, module name is taken from export directory
+uint16_t api_hash_table::add_module(const pe_base& image)
+{
+	export_info info;
+	exported_functions_list exports(get_exported_functions(image, info));
+	return add_module(info.get_name(), exports);
+}
+
+//Sorts hashes of added modules and merges them with sorted hashes
+void api_hash_table::finalize()
+{
+	if(sorted_count_ == entries_.size())
+		return;
+
+	std::vector<entry>::iterator middle = entries_.begin() + sorted_count_;
+	std::stable_sort(middle, entries_.end());
+	std::inplace_merge(entries_.begin(), middle, entries_.end());
+	sorted_count_ = entries_.size();
+}
+
+//Throws an exception if there are entries, which were not sorted by finalize()
+void api_hash_table::check_finalized() const
+{
+	if(sorted_count_ != entries_.size())
+		throw pe_exception("API hash table is not finalized", pe_exception::unknown_error);
+}
+
+//Returns hash algorithms of table
+uint32_t api_hash_table::get_algorithms() const
+{
+	return algorithms_;
+}
+
+//Returns number of modules
+std::size_t api_hash_table::get_module_count() const
+{
+	return modules_.size();
+}
+
+//Returns name of module
+const std::string& api_hash_table::get_module_name(uint16_t index) const
+{
+	return modules_.at(index);
+}
+
+//Returns number of hashes in table
+std::size_t api_hash_table::get_hash_count() const
+{
+	return entries_.size();
+}
+
+//Returns function name by its offset
+const char* api_hash_table::get_function_name(uint32_t name_offset) const
+{
+	if(name_offset >= names_.length())
+		throw pe_exception("Incorrect name offset", pe_exception::unknown_error);
+
+	return names_.c_str() + name_offset;
+}
+
+//Saves hash entry to match
+void api_hash_table::make_match(const entry& e, std::size_t query_index, api_hash_match& match)
+{
+	match.set_query_index(query_index);
+	match.set_hash(e.hash, e.algorithm);
+	match.set_function(e.module_index, e.ordinal, e.name_offset);
+}
+
+//Returns all matches of hash
+api_hash_match_list api_hash_table::find(uint32_t hash) const
+{
+	check_finalized();
+
+	entry key;
+	key.hash = hash;
+
+	api_hash_match_list ret;
+	std::pair<std::vector<entry>::const_iterator, std::vector<entry>::const_iterator> range = std::equal_range(entries_.begin(), entries_.end(), key);
+	for(std::vector<entry>::const_iterator it = range.first; it != range.second; ++it)
+	{
+		ret.push_back(api_hash_match());
+		make_match(*it, 0, ret.back());
+	}
+
+	return ret;
+}
+
+//Helper: hash to look up and its index in batch
+typedef std::pair<uint32_t, std::size_t> api_hash_query;
+
+//Finds matches of all hashes "hashes"
+api_hash_match_list api_hash_table::find(const std::vector<uint32_t>& hashes) const
+{
+	check_finalized();
+
+	std::vector<api_hash_query> queries;
+	queries.reserve(hashes.size());
+	for(std::size_t i = 0; i != hashes.size(); ++i)
+		queries.push_back(api_hash_query(hashes[i], i));
+
+	std::sort(queries.begin(), queries.end());
+
+	//Merge sorted queries with sorted table
+	api_hash_match_list ret;
+	std::vector<entry>::const_iterator it = entries_.begin();
+	for(std::vector<api_hash_query>::const_iterator query = queries.begin(); query != queries.end() && it != entries_.end(); ++query)
+	{
+		entry key;
+		key.hash = (*query).first;
+
+		//Skip table entries with smaller hashes by galloping from current position,
+		//so a small batch doesn't walk the whole table
+		std::size_t step = 1;
+		while(static_cast<std::size_t>(entries_.end() - it) > step && (*(it + step)).hash < key.hash)
+			step <<= 1;
+
+		it = std::lower_bound(it, it + std::min(step + 1, static_cast<std::size_t>(entries_.end() - it)), key);
+		for(std::vector<entry>::const_iterator match = it; match != entries_.end() && (*match).hash == key.hash; ++match)
+		{
+			ret.push_back(api_hash_match());
+			make_match(*match, (*query).second, ret.back());
+		}
+	}
+
+	return ret;
+}
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "pe_structures.h"
+#include "pe_base.h"
+#include "pe_exports.h"
+
+namespace pe_bliss
+{
+//Match of API hash
+class api_hash_match
+{
+public:
+	//Default constructor
+	api_hash_match();
+
+	//Returns index of looked up hash in batch (zero for single lookups)
+	std::size_t get_query_index() const;
+	//Returns hash
+	uint32_t get_hash() const;
+	//Returns algorithm, which produced hash (see api_hash_table::hash_algorithm)
+	uint32_t get_algorithm() const;
+	//Returns index of module, which exports function
+	uint16_t get_module_index() const;
+	//Returns ordinal of function
+	uint16_t get_ordinal() const;
+	//Returns offset of function name in names of table (see api_hash_table::get_function_name)
+	uint32_t get_name_offset() const;
+
+public: //Setters, they are used by hash table
+	//Sets index of looked up hash in batch
+	void set_query_index(std::size_t index);
+	//Sets hash and algorithm
+	void set_hash(uint32_t hash, uint32_t algorithm);
+	//Sets module index, function ordinal and name offset
+	void set_function(uint16_t module_index, uint16_t ordinal, uint32_t name_offset);
+
+private:
+	std::size_t query_index_;
+	uint32_t hash_;
+	uint32_t algorithm_;
+	uint16_t module_index_;
+	uint16_t ordinal_;
+	uint32_t name_offset_;
+};
+
+typedef std::vector<api_hash_match> api_hash_match_list;
+
+//Table of hashes of exported function names, which shellcode uses to find API functions
+//Hashes are computed once for chosen algorithms, table is a sorted flat array,
+//so lookups are binary searches and batch lookups are merges of sorted arrays
+//Added modules are appended to table, which is sorted once by finalize(), lookups throw an exception before it
+//Lookups can be done from several threads, if modules are not added at the same time
+class api_hash_table
+{
+public:
+	//Hash algorithms (flags)
+	enum hash_algorithm
+	{
+		hash_ror13 = 1, //Rotate right by 13 and add
+		hash_ror13_module = 2, //Metasploit block_api: ror13 of upper case UTF-16 module name (with terminating null) plus ror13 of function name with terminating null
+		hash_crc32 = 4, //CRC-32 (IEEE 802.3)
+		hash_crc32c = 8, //CRC-32C (Castagnoli, computed by SSE 4.2 crc32 instruction), initial value and final xor are 0xFFFFFFFF
+		hash_djb2 = 16, //h = h * 33 + c, initial value is 5381
+		hash_fnv1a = 32, //32-bit FNV-1a
+		all_hash_algorithms = 63
+	};
+
+public:
+	//Constructor, "algorithms" are hash_algorithm flags
+	explicit api_hash_table(uint32_t algorithms = all_hash_algorithms);
+
+	//Adds names of exported functions of module "module_name"
+	//Functions exported only by ordinal are skipped
+	//Returns index of module
+	uint16_t add_module(const std::string& module_name, const exported_functions_list& exports);
+	//Adds names of exported functions of image, module name is taken from export directory
+	uint16_t add_module(const pe_base& image);
+	//Sorts hashes of added modules, it must be called before lookups
+	void finalize();
+
+	//Returns hash algorithms of table
+	uint32_t get_algorithms() const;
+	//Returns number of modules
+	std::size_t get_module_count() const;
+	//Returns name of module
+	const std::string& get_module_name(uint16_t index) const;
+	//Returns number of hashes in table
+	std::size_t get_hash_count() const;
+	//Returns function name by its offset (see api_hash_match::get_name_offset)
+	const char* get_function_name(uint32_t name_offset) const;
+
+	//Returns all matches of hash (throws an exception if table was not finalized)
+	api_hash_match_list find(uint32_t hash) const;
+	//Finds matches of all hashes "hashes", query index of each match is index of its hash
+	//Matches are sorted by hash, hashes are processed in one pass over table
+	api_hash_match_list find(const std::vector<uint32_t>& hashes) const;
+
+	//Returns hash of name with "length" bytes, module name is used only by hash_ror13_module
+	static uint32_t hash(hash_algorithm algorithm, const char* name, std::size_t length, const char* module_name = 0, std::size_t module_name_length = 0);
+
+private:
+	//Hash entry
+	struct entry
+	{
+		uint32_t hash;
+		uint32_t algorithm;
+		uint32_t name_offset;
+		uint16_t module_index;
+		uint16_t ordinal;
+
+		bool operator<(const entry& other) const;
+	};
+
+	uint32_t algorithms_;
+	std::vector<std::string> modules_;
+	//Entries up to sorted_count_ are sorted by hash, entries of added modules follow them
+	std::vector<entry> entries_;
+	std::size_t sorted_count_;
+	//Null-terminated function names
+	std::string names_;
+
+	//Saves hash entry to match
+	static void make_match(const entry& e, std::size_t query_index, api_hash_match& match);
+	//Throws an exception if there are entries, which were not sorted by finalize()
+	void check_finalized() const;
+};
+}
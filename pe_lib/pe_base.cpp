@@ -18,6 +18,45 @@ pe_base::pe_base(std::istream& file, const pe_properties& props, bool read_debug
 {
 	props_ = props.duplicate().release();
 
+	try
+	{
+		read_image(file, read_debug_raw_data, 0, true);
+	}
+	catch(...)
+	{
+		delete props_;
+		throw;
+	}
+}
+
+//Constructor from data source (for example, memory-mapped file)
+//Section raw data will reference data source and will be copied only when requested for changing
+//(or loaded on first access, if data source is not stored in memory)
+//If read_section_data = false, only headers and section table are read
+pe_base::pe_base(const data_source_holder& source, const pe_properties& props, bool read_debug_raw_data, bool read_section_data)
+{
+	if(!source.get())
+		throw pe_exception("No data source", pe_exception::error_reading_file);
+
+	props_ = props.duplicate().release();
+
+	try
+	{
+		//Headers are read through istream, section data only references the source
+		data_source_streambuf buf(*source.get());
+		std::istream file(&buf);
+		read_image(file, read_debug_raw_data, &source, read_section_data);
+	}
+	catch(...)
+	{
+		delete props_;
+		throw;
+	}
+}
+
+//Reads DOS header, PE headers and section data, restores istream state
+void pe_base::read_image(std::istream& file, bool read_debug_raw_data, const data_source_holder* source, bool read_section_data)
+{
 	//Save istream state
 	std::ios_base::iostate state = file.exceptions();
 	std::streamoff old_offset = file.tellg();
@@ -27,7 +66,7 @@ pe_base::pe_base(std::istream& file, const pe_properties& props, bool read_debug
 		file.exceptions(std::ios::goodbit);
 		//Read DOS header, PE headers and section data
 		read_dos_header(file);
-		read_pe(file, read_debug_raw_data);
+		read_pe(file, read_debug_raw_data, source, read_section_data);
 	}
 	catch(const std::exception&)
 	{
@@ -101,6 +140,32 @@ pe_base& pe_base::operator=(const pe_base& pe)
 	return *this;
 }
 
+#ifdef PE_BLISS_MOVE_SEMANTICS
+pe_base::pe_base(pe_base&& pe) PE_BLISS_NOEXCEPT
+	:has_overlay_(false), props_(0)
+{
+	swap(pe);
+}
+
+pe_base& pe_base::operator=(pe_base&& pe) PE_BLISS_NOEXCEPT
+{
+	swap(pe);
+	return *this;
+}
+#endif
+
+//Exchanges contents of two images without copying
+void pe_base::swap(pe_base& pe)
+{
+	std::swap(dos_header_, pe.dos_header_);
+	rich_overlay_.swap(pe.rich_overlay_);
+	sections_.swap(pe.sections_);
+	std::swap(has_overlay_, pe.has_overlay_);
+	full_headers_data_.swap(pe.full_headers_data_);
+	debug_data_.swap(pe.debug_data_);
+	std::swap(props_, pe.props_);
+}
+
 pe_base::~pe_base()
 {
 	delete props_;
@@ -292,31 +357,47 @@ void pe_base::set_characteristics(uint16_t ch)
 //Returns section from RVA
 section& pe_base::section_from_rva(uint32_t rva)
 {
-	//Search for section
-	for(section_list::iterator i = sections_.begin(); i != sections_.end(); ++i)
-	{
-		section& s = *i;
-		//Return section if found
-		if(rva >= s.get_virtual_address() && rva < s.get_virtual_address() + s.get_aligned_virtual_size(get_section_alignment()))
-			return s;
-	}
+	section_list::const_iterator it = rva_to_section(rva);
+	if(it == sections_.end())
+		throw pe_exception("No section found by presented address", pe_exception::no_section_found);
 
-	throw pe_exception("No section found by presented address", pe_exception::no_section_found);
+	return sections_[it - sections_.begin()];
 }
 
 //Returns section from RVA
 const section& pe_base::section_from_rva(uint32_t rva) const
 {
-	//Search for section
-	for(section_list::const_iterator i = sections_.begin(); i != sections_.end(); ++i)
+	section_list::const_iterator it = rva_to_section(rva);
+	if(it == sections_.end())
+		throw pe_exception("No section found by presented address", pe_exception::no_section_found);
+
+	return *it;
+}
+
+//RVA to section convertion helper, returns sections_.end() if section is not found
+section_list::const_iterator pe_base::rva_to_section(uint32_t rva) const
+{
+	uint32_t section_alignment = get_section_alignment();
+
+	//Sections of image are sorted by virtual addresses and don't overlap (this is checked when image is read
+	//and kept when sections are added), so the section is found by binary search
+	section_list::const_iterator it = std::upper_bound(sections_.begin(), sections_.end(), rva, section_virtual_address_less());
+	if(it != sections_.begin())
 	{
-		const section& s = *i;
-		//Return section if found
-		if(rva >= s.get_virtual_address() && rva < s.get_virtual_address() + s.get_aligned_virtual_size(get_section_alignment()))
-			return s;
+		const section& s = *(it - 1);
+		if(rva >= s.get_virtual_address() && rva < s.get_virtual_address() + s.get_aligned_virtual_size(section_alignment))
+			return it - 1;
 	}
 
-	throw pe_exception("No section found by presented address", pe_exception::no_section_found);
+	//Section list could be changed arbitrarily, so search all sections, if binary search failed
+	for(it = sections_.begin(); it != sections_.end(); ++it)
+	{
+		const section& s = *it;
+		if(rva >= s.get_virtual_address() && rva < s.get_virtual_address() + s.get_aligned_virtual_size(section_alignment))
+			return it;
+	}
+
+	return sections_.end();
 }
 
 //Returns section from directory ID
@@ -437,7 +518,7 @@ void pe_base::set_machine(uint16_t machine)
 void pe_base::prepare_section(section& s)
 {
 	//Calculate its size of raw data
-	s.set_size_of_raw_data(static_cast<uint32_t>(pe_utils::align_up(s.get_raw_data().length(), get_file_alignment())));
+	s.set_size_of_raw_data(static_cast<uint32_t>(pe_utils::align_up(s.get_raw_data_length(), get_file_alignment())));
 
 	//Check section virtual and raw size
 	if(!s.get_size_of_raw_data() && !s.get_virtual_size())
@@ -473,7 +554,7 @@ section& pe_base::add_section(section s)
 
 		//We should align last section raw size, if it wasn't aligned
 		section& last = sections_.back();
-		last.set_size_of_raw_data(static_cast<uint32_t>(pe_utils::align_up(last.get_raw_data().length(), get_file_alignment())));
+		last.set_size_of_raw_data(static_cast<uint32_t>(pe_utils::align_up(last.get_raw_data_length(), get_file_alignment())));
 	}
 	else
 	{
@@ -635,7 +716,7 @@ const char* pe_base::section_data_from_rva(const section& s, uint32_t rva, secti
 {
 	//Check if RVA is inside section "s"
 	if(rva >= s.get_virtual_address() && rva < s.get_virtual_address() + s.get_aligned_virtual_size(get_section_alignment()))
-		return (datatype == section_data_raw ? s.get_raw_data().data() : s.get_virtual_data(get_section_alignment()).c_str()) + rva - s.get_virtual_address();
+		return (datatype == section_data_raw ? s.get_raw_data_ptr() : s.get_virtual_data(get_section_alignment()).c_str()) + rva - s.get_virtual_address();
 
 	throw pe_exception("RVA not found inside section", pe_exception::rva_not_exists);
 }
@@ -648,7 +729,7 @@ uint32_t pe_base::section_data_length_from_rva(uint32_t rva, section_data_type d
 		return static_cast<unsigned long>(full_headers_data_.length());
 
 	const section& s = section_from_rva(rva);
-	return static_cast<unsigned long>(datatype == section_data_raw ? s.get_raw_data().length() /* instead of SizeOfRawData */ : s.get_aligned_virtual_size(get_section_alignment()));
+	return static_cast<unsigned long>(datatype == section_data_raw ? s.get_raw_data_length() /* instead of SizeOfRawData */ : s.get_aligned_virtual_size(get_section_alignment()));
 }
 
 //Returns section TOTAL RAW/VIRTUAL data length from VA inside section for PE32
@@ -675,7 +756,7 @@ uint32_t pe_base::section_data_length_from_rva(uint32_t rva, uint32_t rva_inside
 		throw pe_exception("RVA not found inside section", pe_exception::rva_not_exists);
 
 	//Calculate remaining length of section data from "rva" address
-	long length = static_cast<long>(datatype == section_data_raw ? s.get_raw_data().length() /* instead of SizeOfRawData */ : s.get_aligned_virtual_size(get_section_alignment()))
+	long length = static_cast<long>(datatype == section_data_raw ? s.get_raw_data_length() /* instead of SizeOfRawData */ : s.get_aligned_virtual_size(get_section_alignment()))
 		+ s.get_virtual_address() - rva_inside;
 
 	if(length < 0)
@@ -703,7 +784,7 @@ uint32_t pe_base::section_data_length_from_rva(const section& s, uint32_t rva_in
 	if(rva_inside >= s.get_virtual_address() && rva_inside < s.get_virtual_address() + s.get_aligned_virtual_size(get_section_alignment()))
 	{
 		//Calculate remaining length of section data from "rva" address
-		int32_t length = static_cast<int32_t>(datatype == section_data_raw ? s.get_raw_data().length() /* instead of SizeOfRawData */ : s.get_aligned_virtual_size(get_section_alignment()))
+		int32_t length = static_cast<int32_t>(datatype == section_data_raw ? s.get_raw_data_length() /* instead of SizeOfRawData */ : s.get_aligned_virtual_size(get_section_alignment()))
 			+ s.get_virtual_address() - rva_inside;
 
 		if(length < 0)
@@ -750,7 +831,7 @@ const char* pe_base::section_data_from_rva(uint32_t rva, section_data_type datat
 		return &full_headers_data_[rva];
 
 	const section& s = section_from_rva(rva);
-	return (datatype == section_data_raw ? s.get_raw_data().data() : s.get_virtual_data(get_section_alignment()).c_str()) + rva - s.get_virtual_address();
+	return (datatype == section_data_raw ? s.get_raw_data_ptr() : s.get_virtual_data(get_section_alignment()).c_str()) + rva - s.get_virtual_address();
 }
 
 //Reads DOS headers from istream
@@ -777,7 +858,7 @@ void pe_base::read_dos_header(std::istream& file)
 }
 
 //Reads PE image from istream
-void pe_base::read_pe(std::istream& file, bool read_debug_raw_data)
+void pe_base::read_pe(std::istream& file, bool read_debug_raw_data, const data_source_holder* source, bool read_section_data)
 {
 	//Get istream size
 	std::streamoff filesize = pe_utils::get_file_size(file);
@@ -896,16 +977,28 @@ void pe_base::read_pe(std::istream& file, bool read_debug_raw_data)
 				pe_utils::align_down(s.get_pointer_to_raw_data(), get_file_alignment()) + s.get_size_of_raw_data() > static_cast<uint32_t>(filesize))
 				throw pe_exception("Incorrect section address or size", pe_exception::section_incorrect_addr_or_size);
 
-			//Seek to section raw data
-			file.seekg(pe_utils::align_down(s.get_pointer_to_raw_data(), get_file_alignment()));
-			if(file.bad() || file.fail())
-				throw pe_exception("Cannot reach section data", pe_exception::image_section_data_not_found);
-
-			//Read section raw data
-			s.get_raw_data().resize(s.get_size_of_raw_data());
-			file.read(&s.get_raw_data()[0], s.get_size_of_raw_data());
-			if(file.bad() || file.fail())
-				throw pe_exception("Error reading section data", pe_exception::image_section_data_not_found);
+			if(!read_section_data)
+			{
+				//Section data is not needed, leave section empty
+			}
+			else if(source)
+			{
+				//Reference section raw data inside data source, don't copy it
+				s.set_raw_data(*source, pe_utils::align_down(s.get_pointer_to_raw_data(), get_file_alignment()), s.get_size_of_raw_data());
+			}
+			else
+			{
+				//Seek to section raw data
+				file.seekg(pe_utils::align_down(s.get_pointer_to_raw_data(), get_file_alignment()));
+				if(file.bad() || file.fail())
+					throw pe_exception("Cannot reach section data", pe_exception::image_section_data_not_found);
+
+				//Read section raw data
+				s.get_raw_data().resize(s.get_size_of_raw_data());
+				file.read(&s.get_raw_data()[0], s.get_size_of_raw_data());
+				if(file.bad() || file.fail())
+					throw pe_exception("Error reading section data", pe_exception::image_section_data_not_found);
+			}
 		}
 
 		//Check virtual address and size of section
@@ -946,7 +1039,7 @@ void pe_base::read_pe(std::istream& file, bool read_debug_raw_data)
 		{
 			for(section_list::const_iterator i = sections_.begin(); i != sections_.end(); ++i)
 			{
-				if(!(*i).empty())
+				if((*i).get_size_of_raw_data())
 				{
 					size_of_headers = std::min<uint32_t>(get_size_of_headers(), (*i).get_pointer_to_raw_data());
 					break;
@@ -1273,12 +1366,63 @@ const section& pe_base::section_from_file_offset(uint32_t offset) const
 }
 
 //Returns section and offset (raw data only) from its start from RVA
-const std::pair<uint32_t, const section*> pe_base::section_and_offset_from_rva(uint32_t rva) const
+std::pair<uint32_t, const section*> pe_base::section_and_offset_from_rva(uint32_t rva) const
 {
 	const section& s = section_from_rva(rva);
 	return std::make_pair(rva - s.get_virtual_address(), &s);
 }
 
+//Reads null-terminated string from section virtual data by RVA
+//Part of section, which has no raw data, is treated as zero-filled, so section raw data is never copied
+//Returns false if string is not null-terminated inside section (or headers)
+bool pe_base::read_string_from_rva(uint32_t rva, std::string& str, bool include_headers) const
+{
+	name_view view;
+	if(!read_string_from_rva(rva, view, include_headers))
+		return false;
+
+	str.assign(view.get_data(), view.get_length());
+	return true;
+}
+
+//Finds null-terminated string in section virtual data by RVA, doesn't copy it
+//Returns false if string is not null-terminated inside section (or headers)
+bool pe_base::read_string_from_rva(uint32_t rva, name_view& str, bool include_headers) const
+{
+	//if RVA is inside of headers and we're searching them too...
+	if(include_headers && rva < full_headers_data_.length())
+	{
+		const char* data = full_headers_data_.data() + rva;
+		const char* end = static_cast<const char*>(memchr(data, 0, full_headers_data_.length() - rva));
+		if(!end)
+			return false;
+
+		str = name_view(data, static_cast<uint32_t>(end - data));
+		return true;
+	}
+
+	const section& s = section_from_rva(rva);
+	return s.get_virtual_view(get_section_alignment()).read_string(rva - s.get_virtual_address(), str);
+}
+
+//Copies "size" bytes of section virtual data from RVA to "data" (checks sizes)
+//Part of section, which has no raw data, is treated as zero-filled, so section raw data is never copied
+void pe_base::read_data_from_rva(uint32_t rva, char* data, uint32_t size, bool include_headers) const
+{
+	if(section_data_length_from_rva(rva, rva, section_data_virtual, include_headers) < size)
+		throw pe_exception("RVA and requested data size does not exist inside section", pe_exception::rva_not_exists);
+
+	//if RVA is inside of headers and we're searching them too...
+	if(include_headers && rva < full_headers_data_.length())
+	{
+		memcpy(data, full_headers_data_.data() + rva, size);
+		return;
+	}
+
+	const section& s = section_from_rva(rva);
+	s.get_virtual_view(get_section_alignment()).read_data(rva - s.get_virtual_address(), data, size);
+}
+
 //Returns DLL Characteristics
 uint16_t pe_base::get_dll_characteristics() const
 {
@@ -1585,6 +1729,12 @@ const pe_base::debug_data_list& pe_base::get_raw_debug_data_list() const
 	return debug_data_;
 }
 
+//Sets raw list of debug data (PointerToRawData - data)
+void pe_base::set_raw_debug_data_list(const debug_data_list& data)
+{
+	debug_data_ = data;
+}
+
 //Sets number of sections
 void pe_base::set_number_of_sections(uint16_t number)
 {
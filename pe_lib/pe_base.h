@@ -4,11 +4,13 @@
 #include <istream>
 #include <ostream>
 #include <map>
+#include <string.h>
 #include "pe_exception.h"
 #include "pe_structures.h"
 #include "utils.h"
 #include "pe_section.h"
 #include "pe_properties.h"
+#include "pe_data_source.h"
 
 //Please don't remove this information from header
 //PEBliss 1.0.0
@@ -34,6 +36,11 @@ class pe_base
 public: //CONSTRUCTORS
 	//Constructor from stream
 	pe_base(std::istream& file, const pe_properties& props, bool read_debug_raw_data = true);
+	//Constructor from data source (for example, memory-mapped file)
+	//Section raw data will reference data source and will be copied only when requested for changing
+	//(or loaded on first access, if data source is not stored in memory)
+	//If read_section_data = false, only headers and section table are read, sections will have no data
+	pe_base(const data_source_holder& source, const pe_properties& props, bool read_debug_raw_data = true, bool read_section_data = true);
 
 	//Constructor of empty PE-file
 	explicit pe_base(const pe_properties& props, uint32_t section_alignment = 0x1000, bool dll = false, uint16_t subsystem = pe_win::image_subsystem_windows_gui);
@@ -41,6 +48,16 @@ public: //CONSTRUCTORS
 	pe_base(const pe_base& pe);
 	pe_base& operator=(const pe_base& pe);
 
+#ifdef PE_BLISS_MOVE_SEMANTICS
+	//Move constructor and move assignment operator
+	//Moved-from image can only be destroyed or assigned
+	pe_base(pe_base&& pe) PE_BLISS_NOEXCEPT;
+	pe_base& operator=(pe_base&& pe) PE_BLISS_NOEXCEPT;
+#endif
+
+	//Exchanges contents of two images without copying
+	void swap(pe_base& pe);
+
 public:
 	~pe_base();
 
@@ -247,6 +264,9 @@ public: //PE HEADER
 	typedef std::multimap<uint32_t, std::string> debug_data_list;
 	//Returns raw list of debug data
 	const debug_data_list& get_raw_debug_data_list() const;
+	//Sets raw list of debug data (PointerToRawData - data)
+	//Used by parsers, which receive raw debug data separately
+	void set_raw_debug_data_list(const debug_data_list& data);
 	
 	//Reads and checks DOS header
 	static void read_dos_header(std::istream& file, pe_win::image_dos_header& header);
@@ -349,6 +369,7 @@ public: //IMAGE SECTIONS
 	//If include_headers = true, data from the beginning of PE file to SizeOfHeaders will be searched, too
 	//Returns corresponding section data pointer from RVA inside section
 	char* section_data_from_rva(uint32_t rva, bool include_headers = false);
+	//Virtual data of section, which is larger than raw data, is copied once (use section::get_virtual_view to avoid it)
 	const char* section_data_from_rva(uint32_t rva, section_data_type datatype = section_data_raw, bool include_headers = false) const;
 	//Returns corresponding section data pointer from VA inside section for PE32 and PE64 respectively
 	char* section_data_from_va(uint32_t va, bool include_headers = false);
@@ -370,14 +391,7 @@ public: //IMAGE SECTIONS
 	T section_data_from_rva(const section& s, uint32_t rva, section_data_type datatype = section_data_raw) const
 	{
 		if(rva >= s.get_virtual_address() && rva < s.get_virtual_address() + s.get_aligned_virtual_size(get_section_alignment()) && pe_utils::is_sum_safe(rva, sizeof(T)))
-		{
-			const std::string& data = datatype == section_data_raw ? s.get_raw_data() : s.get_virtual_data(get_section_alignment());
-			//Don't check for underflow here, comparsion is unsigned
-			if(data.size() < rva - s.get_virtual_address() + sizeof(T))
-				throw pe_exception("RVA and requested data size does not exist inside section", pe_exception::rva_not_exists);
-
-			return *reinterpret_cast<const T*>(data.data() + rva - s.get_virtual_address());
-		}
+			return section_data_from_offset<T>(s, rva - s.get_virtual_address(), datatype);
 
 		throw pe_exception("RVA not found inside section", pe_exception::rva_not_exists);
 	}
@@ -392,12 +406,7 @@ public: //IMAGE SECTIONS
 			return *reinterpret_cast<const T*>(&full_headers_data_[rva]);
 
 		const section& s = section_from_rva(rva);
-		const std::string& data = datatype == section_data_raw ? s.get_raw_data() : s.get_virtual_data(get_section_alignment());
-		//Don't check for underflow here, comparsion is unsigned
-		if(data.size() < rva - s.get_virtual_address() + sizeof(T))
-			throw pe_exception("RVA and requested data size does not exist inside section", pe_exception::rva_not_exists);
-
-		return *reinterpret_cast<const T*>(data.data() + rva - s.get_virtual_address());
+		return section_data_from_offset<T>(s, rva - s.get_virtual_address(), datatype);
 	}
 
 	//Returns corresponding section data pointer from VA inside section "s" (checks bounds, checks sizes, the most safe function)
@@ -428,7 +437,21 @@ public: //IMAGE SECTIONS
 	}
 
 	//Returns section and offset (raw data only) from its start from RVA
-	const std::pair<uint32_t, const section*> section_and_offset_from_rva(uint32_t rva) const;
+	std::pair<uint32_t, const section*> section_and_offset_from_rva(uint32_t rva) const;
+
+	//Reads null-terminated string from section virtual data by RVA
+	//If include_headers = true, data from the beginning of PE file to SizeOfHeaders will be searched, too
+	//Part of section, which has no raw data, is treated as zero-filled, so section raw data is never copied
+	//Returns false if string is not null-terminated inside section (or headers)
+	bool read_string_from_rva(uint32_t rva, std::string& str, bool include_headers = false) const;
+	//Finds null-terminated string in section virtual data by RVA, doesn't copy it
+	//Returned string references image data, it is valid while image exists and its data is not changed
+	//Returns false if string is not null-terminated inside section (or headers)
+	bool read_string_from_rva(uint32_t rva, name_view& str, bool include_headers = false) const;
+	//Copies "size" bytes of section virtual data from RVA to "data" (checks sizes)
+	//If include_headers = true, data from the beginning of PE file to SizeOfHeaders will be searched, too
+	//Part of section, which has no raw data, is treated as zero-filled, so section raw data is never copied
+	void read_data_from_rva(uint32_t rva, char* data, uint32_t size, bool include_headers = false) const;
 
 	//Sets virtual size of section "s"
 	//Section must be free (not bound to any image)
@@ -498,7 +521,12 @@ private:
 	void read_dos_header(std::istream& file);
 
 	//Reads and checks PE headers and section headers, data
-	void read_pe(std::istream& file, bool read_debug_raw_data);
+	//If source is not zero, section data will reference it instead of being read from "file"
+	//If read_section_data = false, section data is not read at all
+	void read_pe(std::istream& file, bool read_debug_raw_data, const data_source_holder* source, bool read_section_data);
+
+	//Reads DOS header, PE headers and section data, restores istream state
+	void read_image(std::istream& file, bool read_debug_raw_data, const data_source_holder* source, bool read_section_data);
 
 	//Sets number of sections
 	void set_number_of_sections(uint16_t number);
@@ -515,9 +543,30 @@ private:
 	static const uint16_t maximum_number_of_sections = 0x60;
 	static const uint32_t minimum_file_alignment = 512;
 
+private:
+	//Returns data of type T from section "s" at offset "offset" (checks sizes)
+	//Part of virtual section data, which is not present in raw data, is zero-filled
+	template<typename T>
+	T section_data_from_offset(const section& s, uint32_t offset, section_data_type datatype) const
+	{
+		if(datatype == section_data_raw)
+		{
+			//Don't check for underflow here, comparsion is unsigned
+			if(s.get_raw_data_length() >= offset + sizeof(T))
+				return *reinterpret_cast<const T*>(s.get_raw_data_ptr() + offset);
+
+			throw pe_exception("RVA and requested data size does not exist inside section", pe_exception::rva_not_exists);
+		}
+
+		return s.get_virtual_view(get_section_alignment()).get<T>(offset);
+	}
+
 private:
 	//RAW file offset to section convertion helpers (4gb max)
 	section_list::const_iterator file_offset_to_section(uint32_t offset) const;
 	section_list::iterator file_offset_to_section(uint32_t offset);
+
+	//RVA to section convertion helper, returns sections_.end() if section is not found
+	section_list::const_iterator rva_to_section(uint32_t rva) const;
 };
 }
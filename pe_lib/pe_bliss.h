@@ -2,12 +2,20 @@
 #include "pe_base.h"
 #include "pe_rebuilder.h"
 #include "pe_factory.h"
+#include "pe_stream_parser.h"
+#include "pe_threads.h"
 #include "pe_bound_import.h"
 #include "pe_debug.h"
 #include "pe_dotnet.h"
 #include "pe_exception_directory.h"
 #include "pe_exports.h"
 #include "pe_imports.h"
+#include "pe_import_resolver.h"
+#include "pe_dependency_graph.h"
+#include "pe_ordinal_names.h"
+#include "pe_api_hash.h"
+#include "pe_md5.h"
+#include "pe_imphash.h"
 #include "pe_load_config.h"
 #include "pe_relocations.h"
 #include "pe_resources.h"
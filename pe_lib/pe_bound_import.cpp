@@ -105,7 +105,7 @@ void bound_import::set_timestamp(uint32_t timestamp)
 	timestamp_ = timestamp;
 }
 
-const bound_import_module_list get_bound_import_module_list(const pe_base& pe)
+bound_import_module_list get_bound_import_module_list(const pe_base& pe)
 {
 	//Returned bound import modules list
 	bound_import_module_list ret;
@@ -200,7 +200,7 @@ const bound_import_module_list get_bound_import_module_list(const pe_base& pe)
 //offset_from_section_start - offset from imports_section raw data start
 //save_to_pe_headers - if true, new bound import directory information will be saved to PE image headers
 //auto_strip_last_section - if true and bound imports are placed in the last section, it will be automatically stripped
-const image_directory rebuild_bound_imports(pe_base& pe, const bound_import_module_list& imports, section& imports_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
+image_directory rebuild_bound_imports(pe_base& pe, const bound_import_module_list& imports, section& imports_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
 {
 	//Check that exports_section is attached to this PE image
 	if(!pe.section_attached(imports_section))
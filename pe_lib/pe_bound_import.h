@@ -76,12 +76,12 @@ private:
 typedef std::vector<bound_import> bound_import_module_list;
 
 //Returns bound import information
-const bound_import_module_list get_bound_import_module_list(const pe_base& pe);//Export directory rebuilder
+bound_import_module_list get_bound_import_module_list(const pe_base& pe);//Export directory rebuilder
 
 //imports - bound imported modules list
 //imports_section - section where export directory will be placed (must be attached to PE image)
 //offset_from_section_start - offset from imports_section raw data start
 //save_to_pe_headers - if true, new bound import directory information will be saved to PE image headers
 //auto_strip_last_section - if true and bound imports are placed in the last section, it will be automatically stripped
-const image_directory rebuild_bound_imports(pe_base& pe, const bound_import_module_list& imports, section& imports_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_bound_imports(pe_base& pe, const bound_import_module_list& imports, section& imports_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 }
@@ -0,0 +1,402 @@
+#include <string.h>
+#include <algorithm>
+#include "pe_data_source.h"
+#include "pe_exception.h"
+
+#ifdef PE_BLISS_WINDOWS
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace pe_bliss
+{
+//Default constructor
+data_source::data_source()
+	:ref_count_(0)
+{}
+
+//Destructor
+data_source::~data_source()
+{}
+
+//Increments reference counter
+void data_source::add_ref() const
+{
+#ifdef PE_BLISS_WINDOWS
+	InterlockedIncrement(&ref_count_);
+#else
+	__sync_add_and_fetch(&ref_count_, 1);
+#endif
+}
+
+//Decrements reference counter, deletes source if it is not referenced anymore
+void data_source::release() const
+{
+#ifdef PE_BLISS_WINDOWS
+	if(InterlockedDecrement(&ref_count_) == 0)
+#else
+	if(__sync_sub_and_fetch(&ref_count_, 1) == 0)
+#endif
+		delete this;
+}
+
+//Returns true if source is referenced more than once
+bool data_source::is_shared() const
+{
+	return ref_count_ > 1;
+}
+
+//Copies "size" bytes from offset "offset" of source data to "data" (checks bounds)
+void data_source::read_data(std::size_t offset, char* data, std::size_t size) const
+{
+	if(offset > get_size() || size > get_size() - offset)
+		throw pe_exception("Error reading data source", pe_exception::error_reading_file);
+
+	if(size)
+		memcpy(data, get_data() + offset, size);
+}
+
+//Constructor (references source, if it is not zero)
+data_source_holder::data_source_holder(const data_source* source)
+	:source_(source)
+{
+	if(source_)
+		source_->add_ref();
+}
+
+//Copy constructor
+data_source_holder::data_source_holder(const data_source_holder& other)
+	:source_(other.source_)
+{
+	if(source_)
+		source_->add_ref();
+}
+
+//Copy assignment operator
+data_source_holder& data_source_holder::operator=(const data_source_holder& other)
+{
+	reset(other.source_);
+	return *this;
+}
+
+//Destructor
+data_source_holder::~data_source_holder()
+{
+	if(source_)
+		source_->release();
+}
+
+//Returns held data source (or zero)
+const data_source* data_source_holder::get() const
+{
+	return source_;
+}
+
+//Releases held data source and references "source" (if it is not zero)
+void data_source_holder::reset(const data_source* source)
+{
+	//Reference new source first, it can be the same as held one
+	if(source)
+		source->add_ref();
+
+	if(source_)
+		source_->release();
+
+	source_ = source;
+}
+
+//Exchanges held data sources without changing reference counters
+void data_source_holder::swap(data_source_holder& other)
+{
+	std::swap(source_, other.source_);
+}
+
+//Opens and maps file with name "file_name"
+mapped_file_source::mapped_file_source(const std::string& file_name)
+	:data_(0), size_(0)
+{
+#ifdef PE_BLISS_WINDOWS
+	file_ = 0;
+	mapping_ = 0;
+
+	HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if(file == INVALID_HANDLE_VALUE)
+		throw pe_exception("Cannot open file", pe_exception::error_reading_file);
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.HighPart)
+	{
+		CloseHandle(file);
+		throw pe_exception("Cannot map file", pe_exception::error_reading_file);
+	}
+
+	size_ = static_cast<std::size_t>(size.LowPart);
+	file_ = file;
+
+	//Empty files can't be mapped
+	if(!size_)
+		return;
+
+	mapping_ = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	if(!mapping_)
+	{
+		CloseHandle(file);
+		throw pe_exception("Cannot map file", pe_exception::error_reading_file);
+	}
+
+	data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if(!data_)
+	{
+		CloseHandle(mapping_);
+		CloseHandle(file);
+		throw pe_exception("Cannot map file", pe_exception::error_reading_file);
+	}
+#else
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if(fd == -1)
+		throw pe_exception("Cannot open file", pe_exception::error_reading_file);
+
+	struct stat st;
+	if(fstat(fd, &st) == -1 || static_cast<uint64_t>(st.st_size) > static_cast<uint32_t>(-1))
+	{
+		close(fd);
+		throw pe_exception("Cannot map file", pe_exception::error_reading_file);
+	}
+
+	size_ = static_cast<std::size_t>(st.st_size);
+
+	//Empty files can't be mapped
+	if(size_)
+	{
+		void* data = mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data == MAP_FAILED)
+		{
+			close(fd);
+			throw pe_exception("Cannot map file", pe_exception::error_reading_file);
+		}
+
+		data_ = static_cast<const char*>(data);
+	}
+
+	//Mapping stays valid after descriptor is closed
+	close(fd);
+#endif
+}
+
+//Destructor (unmaps file)
+mapped_file_source::~mapped_file_source()
+{
+#ifdef PE_BLISS_WINDOWS
+	if(data_)
+		UnmapViewOfFile(data_);
+	if(mapping_)
+		CloseHandle(mapping_);
+	if(file_)
+		CloseHandle(file_);
+#else
+	if(data_)
+		munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+//Returns pointer to mapped file contents
+const char* mapped_file_source::get_data() const
+{
+	return data_;
+}
+
+//Returns mapped file size
+std::size_t mapped_file_source::get_size() const
+{
+	return size_;
+}
+
+//Constructor from data
+memory_data_source::memory_data_source(const std::string& data)
+	:data_(data)
+{}
+
+//Returns pointer to data
+const char* memory_data_source::get_data() const
+{
+	return data_.data();
+}
+
+//Returns size of data
+std::size_t memory_data_source::get_size() const
+{
+	return data_.length();
+}
+
+//Returns stored data
+const std::string& memory_data_source::get_string() const
+{
+	return data_;
+}
+
+//Returns stored data for changing
+std::string& memory_data_source::get_string()
+{
+	return data_;
+}
+
+//Constructor from stream (determines stream size)
+stream_data_source::stream_data_source(std::istream& file)
+	:file_(file), size_(0)
+{
+	std::ios_base::iostate state = file_.exceptions();
+	std::streamoff old_offset = file_.tellg();
+	file_.exceptions(std::ios::goodbit);
+
+	file_.seekg(0, std::ios::end);
+	std::streamoff size = file_.tellg();
+	bool failed = file_.bad() || file_.fail() || size < 0 || static_cast<uint64_t>(size) > static_cast<uint32_t>(-1);
+
+	//Restore stream state
+	file_.clear();
+	file_.seekg(old_offset);
+	file_.exceptions(state);
+
+	if(failed)
+		throw pe_exception("Cannot determine stream size", pe_exception::error_reading_file);
+
+	size_ = static_cast<std::size_t>(size);
+}
+
+//Returns zero, stream data is not stored in memory
+const char* stream_data_source::get_data() const
+{
+	return 0;
+}
+
+//Returns stream size
+std::size_t stream_data_source::get_size() const
+{
+	return size_;
+}
+
+//Reads "size" bytes from offset "offset" of stream to "data", restores stream state
+void stream_data_source::read_data(std::size_t offset, char* data, std::size_t size) const
+{
+	if(offset > size_ || size > size_ - offset)
+		throw pe_exception("Error reading data source", pe_exception::error_reading_file);
+
+	if(!size)
+		return;
+
+	pe_lock lock(mutex_);
+
+	//Headers are read by one block once
+	std::size_t cache_size = std::min(header_cache_size, size_);
+	if(offset + size <= cache_size)
+	{
+		if(header_cache_.empty())
+		{
+			std::string cache(cache_size, 0);
+			read_stream(0, &cache[0], cache_size);
+			header_cache_.swap(cache);
+		}
+
+		memcpy(data, header_cache_.data() + offset, size);
+		return;
+	}
+
+	read_stream(offset, data, size);
+}
+
+//Reads "size" bytes from offset "offset" of stream to "data" without bounds checks, restores stream state
+void stream_data_source::read_stream(std::size_t offset, char* data, std::size_t size) const
+{
+	std::ios_base::iostate state = file_.exceptions();
+	std::streamoff old_offset = file_.tellg();
+	file_.exceptions(std::ios::goodbit);
+	file_.clear();
+
+	file_.seekg(offset);
+	file_.read(data, size);
+	bool failed = file_.bad() || file_.fail();
+
+	//Restore stream state
+	file_.clear();
+	file_.seekg(old_offset);
+	file_.exceptions(state);
+
+	if(failed)
+		throw pe_exception("Error reading data source", pe_exception::error_reading_file);
+}
+
+//Constructor from data source
+data_source_streambuf::data_source_streambuf(const data_source& source)
+	:source_(source), buffer_offset_(0)
+{
+	if(source_.get_data())
+	{
+		//Whole source data is in memory, use it as buffer
+		char* begin = const_cast<char*>(source_.get_data());
+		setg(begin, begin, begin + source_.get_size());
+	}
+	else
+	{
+		setg(buffer_, buffer_, buffer_);
+	}
+}
+
+std::streambuf::int_type data_source_streambuf::underflow()
+{
+	if(gptr() < egptr())
+		return traits_type::to_int_type(*gptr());
+
+	//Read next block of data
+	std::size_t offset = buffer_offset_ + (egptr() - eback());
+	if(source_.get_data() || offset >= source_.get_size())
+		return traits_type::eof();
+
+	std::size_t size = std::min<std::size_t>(block_size, source_.get_size() - offset);
+	source_.read_data(offset, buffer_, size);
+	buffer_offset_ = offset;
+	setg(buffer_, buffer_, buffer_ + size);
+
+	return traits_type::to_int_type(*gptr());
+}
+
+std::streambuf::pos_type data_source_streambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+	if(!(which & std::ios_base::in))
+		return pos_type(off_type(-1));
+
+	off_type pos;
+	if(dir == std::ios_base::beg)
+		pos = off;
+	else if(dir == std::ios_base::cur)
+		pos = static_cast<off_type>(buffer_offset_) + (gptr() - eback()) + off;
+	else
+		pos = static_cast<off_type>(source_.get_size()) + off;
+
+	if(pos < 0 || pos > static_cast<off_type>(source_.get_size()))
+		return pos_type(off_type(-1));
+
+	if(pos >= static_cast<off_type>(buffer_offset_) && pos <= static_cast<off_type>(buffer_offset_) + (egptr() - eback()))
+	{
+		//Position is inside of buffer
+		setg(eback(), eback() + (pos - buffer_offset_), egptr());
+	}
+	else
+	{
+		//Buffer will be filled on next read
+		buffer_offset_ = static_cast<std::size_t>(pos);
+		setg(buffer_, buffer_, buffer_);
+	}
+
+	return pos_type(pos);
+}
+
+std::streambuf::pos_type data_source_streambuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <string>
+#include <streambuf>
+#include <istream>
+#include "pe_structures.h"
+#include "pe_threads.h"
+
+namespace pe_bliss
+{
+//Reference-counted read-only source of raw PE file data
+//Image sections can reference data of source without copying it
+//or load it from source on first access
+//Sources must be created with operator new and passed to library in data_source_holder,
+//which takes the first reference; source is deleted when the last reference is released
+class data_source
+{
+public:
+	//Default constructor
+	data_source();
+	//Destructor
+	virtual ~data_source();
+
+	//Returns pointer to source data
+	//Returns zero, if source data is not stored in memory (then it is read with read_data)
+	virtual const char* get_data() const = 0;
+	//Returns size of source data
+	virtual std::size_t get_size() const = 0;
+	//Copies "size" bytes from offset "offset" of source data to "data" (checks bounds)
+	virtual void read_data(std::size_t offset, char* data, std::size_t size) const;
+
+public: //Reference counting
+	//Increments reference counter
+	void add_ref() const;
+	//Decrements reference counter, deletes source if it is not referenced anymore
+	void release() const;
+	//Returns true if source is referenced more than once
+	bool is_shared() const;
+
+private:
+	mutable volatile long ref_count_;
+
+	data_source(const data_source&);
+	data_source& operator=(const data_source&);
+};
+
+//Holds reference to data source, releases it automatically
+class data_source_holder
+{
+public:
+	//Constructor (references source, if it is not zero)
+	//Holder, which takes newly created source, owns it
+	explicit data_source_holder(const data_source* source = 0);
+	//Copy constructor
+	data_source_holder(const data_source_holder& other);
+	//Copy assignment operator
+	data_source_holder& operator=(const data_source_holder& other);
+	//Destructor
+	~data_source_holder();
+
+	//Returns held data source (or zero)
+	const data_source* get() const;
+	//Releases held data source and references "source" (if it is not zero)
+	void reset(const data_source* source = 0);
+	//Exchanges held data sources without changing reference counters
+	void swap(data_source_holder& other);
+
+private:
+	const data_source* source_;
+};
+
+//Read-only memory-mapped file
+class mapped_file_source : public data_source
+{
+public:
+	//Opens and maps file with name "file_name"
+	explicit mapped_file_source(const std::string& file_name);
+	//Destructor (unmaps file)
+	virtual ~mapped_file_source();
+
+	//Returns pointer to mapped file contents
+	virtual const char* get_data() const;
+	//Returns mapped file size
+	virtual std::size_t get_size() const;
+
+private:
+	const char* data_;
+	std::size_t size_;
+
+#ifdef PE_BLISS_WINDOWS
+	void* file_;
+	void* mapping_;
+#endif
+};
+
+//Data source, which owns data stored in memory
+//Sections keep their own data in such sources, so copies of section
+//share data until it is changed (copy-on-write)
+class memory_data_source : public data_source
+{
+public:
+	//Constructor from data
+	explicit memory_data_source(const std::string& data = std::string());
+
+	//Returns pointer to data
+	virtual const char* get_data() const;
+	//Returns size of data
+	virtual std::size_t get_size() const;
+
+	//Returns stored data
+	const std::string& get_string() const;
+	//Returns stored data for changing
+	//Data can be changed only if source is not shared
+	std::string& get_string();
+
+private:
+	std::string data_;
+};
+
+//Data source, which reads data from istream on demand
+//Stream must exist while any image section references the source
+//(until all section data is loaded)
+//The beginning of stream (where PE headers are located) is read once by one block and cached
+//Reads are serialized, so source can be used from several threads
+class stream_data_source : public data_source
+{
+public:
+	//Constructor from stream (determines stream size)
+	explicit stream_data_source(std::istream& file);
+
+	//Returns zero, stream data is not stored in memory
+	virtual const char* get_data() const;
+	//Returns stream size
+	virtual std::size_t get_size() const;
+	//Reads "size" bytes from offset "offset" of stream to "data", restores stream state
+	virtual void read_data(std::size_t offset, char* data, std::size_t size) const;
+
+private:
+	static const std::size_t header_cache_size = 0x1000;
+
+	std::istream& file_;
+	std::size_t size_;
+	//Cached data from the beginning of stream
+	mutable std::string header_cache_;
+	//Serializes stream reads
+	mutable pe_mutex mutex_;
+
+	//Reads "size" bytes from offset "offset" of stream to "data" without bounds checks, restores stream state
+	void read_stream(std::size_t offset, char* data, std::size_t size) const;
+};
+
+//Input stream buffer over data source
+//Used to read PE headers from data sources through std::istream
+//Data of sources, which are not stored in memory, is read by small blocks
+class data_source_streambuf : public std::streambuf
+{
+public:
+	//Constructor from data source
+	explicit data_source_streambuf(const data_source& source);
+
+protected:
+	virtual int_type underflow();
+	virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::in);
+	virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in);
+
+private:
+	static const std::size_t block_size = 0x1000;
+
+	const data_source& source_;
+	//Offset of buffer data inside source
+	std::size_t buffer_offset_;
+	char buffer_[block_size];
+
+	data_source_streambuf(const data_source_streambuf&);
+	data_source_streambuf& operator=(const data_source_streambuf&);
+};
+}
@@ -259,7 +259,7 @@ debug_info::advanced_info_type debug_info::get_advanced_info_type() const
 //Returns advanced debug information or throws an exception,
 //if requested information type is not contained by structure
 template<>
-const pdb_7_0_info debug_info::get_advanced_debug_info<pdb_7_0_info>() const
+pdb_7_0_info debug_info::get_advanced_debug_info<pdb_7_0_info>() const
 {
 	if(advanced_info_type_ != advanced_info_pdb_7_0)
 		throw pe_exception("Debug info structure does not contain PDB 7.0 data", pe_exception::advanced_debug_information_request_error);
@@ -268,7 +268,7 @@ const pdb_7_0_info debug_info::get_advanced_debug_info<pdb_7_0_info>() const
 }
 
 template<>
-const pdb_2_0_info debug_info::get_advanced_debug_info<pdb_2_0_info>() const
+pdb_2_0_info debug_info::get_advanced_debug_info<pdb_2_0_info>() const
 {
 	if(advanced_info_type_ != advanced_info_pdb_2_0)
 		throw pe_exception("Debug info structure does not contain PDB 2.0 data", pe_exception::advanced_debug_information_request_error);
@@ -277,7 +277,7 @@ const pdb_2_0_info debug_info::get_advanced_debug_info<pdb_2_0_info>() const
 }
 
 template<>
-const misc_debug_info debug_info::get_advanced_debug_info<misc_debug_info>() const
+misc_debug_info debug_info::get_advanced_debug_info<misc_debug_info>() const
 {
 	if(advanced_info_type_ != advanced_info_misc)
 		throw pe_exception("Debug info structure does not contain MISC data", pe_exception::advanced_debug_information_request_error);
@@ -286,7 +286,7 @@ const misc_debug_info debug_info::get_advanced_debug_info<misc_debug_info>() con
 }
 
 template<>
-const coff_debug_info debug_info::get_advanced_debug_info<coff_debug_info>() const
+coff_debug_info debug_info::get_advanced_debug_info<coff_debug_info>() const
 {
 	if(advanced_info_type_ != advanced_info_coff)
 		throw pe_exception("Debug info structure does not contain COFF data", pe_exception::advanced_debug_information_request_error);
@@ -316,7 +316,7 @@ pdb_7_0_info::pdb_7_0_info(const CV_INFO_PDB70* info)
 {}
 
 //Returns debug PDB 7.0 structure GUID
-const guid pdb_7_0_info::get_guid() const
+guid pdb_7_0_info::get_guid() const
 {
 	return guid_;
 }
@@ -599,7 +599,7 @@ void coff_debug_info::coff_symbol::set_type(uint16_t type)
 }
 
 //Returns debug information list
-const debug_info_list get_debug_information(const pe_base& pe)
+debug_info_list get_debug_information(const pe_base& pe)
 {
 	debug_info_list ret;
 
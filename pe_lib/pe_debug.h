@@ -15,7 +15,7 @@ public:
 	explicit pdb_7_0_info(const pe_win::CV_INFO_PDB70* info);
 
 	//Returns debug PDB 7.0 structure GUID
-	const pe_win::guid get_guid() const;
+	pe_win::guid get_guid() const;
 	//Returns age of build
 	uint32_t get_age() const;
 	//Returns PDB file name / path
@@ -248,7 +248,7 @@ public:
 	//Returns advanced debug information or throws an exception,
 	//if requested information type is not contained by structure
 	template<typename AdvancedInfo>
-	const AdvancedInfo get_advanced_debug_info() const;
+	AdvancedInfo get_advanced_debug_info() const;
 
 public: //These functions do not change everything inside image, they are used by PE class
 	//Sets advanced debug information
@@ -299,5 +299,5 @@ private:
 typedef std::vector<debug_info> debug_info_list;
 
 //Returns debug information list
-const debug_info_list get_debug_information(const pe_base& pe);
+debug_info_list get_debug_information(const pe_base& pe);
 }
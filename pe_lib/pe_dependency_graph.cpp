@@ -0,0 +1,528 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <algorithm>
+#include "pe_dependency_graph.h"
+#include "pe_factory.h"
+#include "pe_imports.h"
+#include "pe_bound_import.h"
+
+#ifdef PE_BLISS_WINDOWS
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#endif
+
+namespace pe_bliss
+{
+//Default constructor
+string_table::string_table()
+{}
+
+//Returns shard of string
+string_table::shard& string_table::get_shard(const char* data, std::size_t length) const
+{
+	//FNV-1a hash
+	uint32_t hash = 2166136261u;
+	for(std::size_t i = 0; i != length; ++i)
+	{
+		hash ^= static_cast<uint8_t>(data[i]);
+		hash *= 16777619u;
+	}
+
+	return shards_[hash % shard_count];
+}
+
+//Returns id of string, adds string to table if it is not there yet
+uint32_t string_table::intern(const char* data, std::size_t length)
+{
+	std::string str(data, length);
+	shard& s = get_shard(data, length);
+
+	pe_lock lock(s.mutex);
+	std::map<std::string, uint32_t>::const_iterator it = s.ids.find(str);
+	if(it != s.ids.end())
+		return (*it).second;
+
+	uint32_t id;
+	{
+		pe_lock strings_lock(strings_mutex_);
+		strings_.push_back(str);
+		id = static_cast<uint32_t>(strings_.size() - 1);
+	}
+
+	s.ids.insert(std::make_pair(str, id));
+	return id;
+}
+
+//Returns id of string, adds string to table if it is not there yet
+uint32_t string_table::intern(const std::string& str)
+{
+	return intern(str.data(), str.length());
+}
+
+//Returns true and id of string, if string is in table
+bool string_table::find(const std::string& str, uint32_t& id) const
+{
+	shard& s = get_shard(str.data(), str.length());
+
+	pe_lock lock(s.mutex);
+	std::map<std::string, uint32_t>::const_iterator it = s.ids.find(str);
+	if(it == s.ids.end())
+		return false;
+
+	id = (*it).second;
+	return true;
+}
+
+//Returns string with id "id"
+const std::string& string_table::get(uint32_t id) const
+{
+	//Deque elements are not moved when new strings are added
+	pe_lock lock(strings_mutex_);
+	return strings_.at(id);
+}
+
+//Returns number of strings in table
+std::size_t string_table::size() const
+{
+	pe_lock lock(strings_mutex_);
+	return strings_.size();
+}
+
+//Default constructor
+dependency_graph::edge::edge()
+	:from_(0), to_(0), image_count_(0), bound_count_(0)
+{}
+
+//Returns id of importing module name
+uint32_t dependency_graph::edge::get_from() const
+{
+	return from_;
+}
+
+//Returns id of imported library name
+uint32_t dependency_graph::edge::get_to() const
+{
+	return to_;
+}
+
+//Returns number of images, which import library
+uint32_t dependency_graph::edge::get_image_count() const
+{
+	return image_count_;
+}
+
+//Returns number of images, which have library in bound import directory
+uint32_t dependency_graph::edge::get_bound_count() const
+{
+	return bound_count_;
+}
+
+//Returns sorted ids of imported function names
+const std::vector<uint32_t>& dependency_graph::edge::get_functions() const
+{
+	return functions_;
+}
+
+//Sets ids of module names
+void dependency_graph::edge::set_modules(uint32_t from, uint32_t to)
+{
+	from_ = from;
+	to_ = to;
+}
+
+//Sets counters
+void dependency_graph::edge::set_counts(uint32_t image_count, uint32_t bound_count)
+{
+	image_count_ = image_count;
+	bound_count_ = bound_count;
+}
+
+//Returns imported functions list for changing
+std::vector<uint32_t>& dependency_graph::edge::get_functions()
+{
+	return functions_;
+}
+
+dependency_graph::edge_data::edge_data()
+	:image_count(0), bound_count(0)
+{}
+
+//Helper: converts module name to lower case
+std::string module_name_to_lower(const char* data, std::size_t length)
+{
+	std::string ret(data, length);
+	for(std::string::iterator it = ret.begin(); it != ret.end(); ++it)
+		*it = static_cast<char>(tolower(static_cast<unsigned char>(*it)));
+
+	return ret;
+}
+
+//Helper: dependencies of one image, they are collected without locking the graph
+//Names are interned to graph only after image was parsed
+struct image_dependencies
+{
+	//Names of modules and functions of image
+	std::vector<std::string> names;
+	//Imported functions: (library name index, function name index), library without functions has function index -1
+	std::vector<std::pair<uint32_t, uint32_t> > functions;
+	//Bound import edges: (module name index, library name index)
+	std::vector<std::pair<uint32_t, uint32_t> > bound;
+
+	//Adds name, returns its index
+	uint32_t add_name(const std::string& name)
+	{
+		names.push_back(name);
+		return static_cast<uint32_t>(names.size() - 1);
+	}
+};
+
+//Helper: import visitor, which collects names of imported libraries and functions
+class dependency_visitor : public import_visitor
+{
+public:
+	explicit dependency_visitor(image_dependencies& dependencies)
+		:dependencies_(dependencies), library_(0)
+	{}
+
+	virtual library_action on_library(const import_library_view& library)
+	{
+		library_ = dependencies_.add_name(module_name_to_lower(library.get_name().get_data(), library.get_name().get_length()));
+		dependencies_.functions.push_back(std::make_pair(library_, static_cast<uint32_t>(-1)));
+		return visit_functions;
+	}
+
+	virtual bool on_function(const import_library_view& /*library*/, const imported_function_view& func, uint32_t /*thunk_rva*/)
+	{
+		uint32_t index;
+		if(func.has_name())
+		{
+			index = dependencies_.add_name(func.get_name().to_string());
+		}
+		else
+		{
+			char ordinal[8];
+			sprintf(ordinal, "#%u", static_cast<unsigned int>(func.get_ordinal()));
+			index = dependencies_.add_name(ordinal);
+		}
+
+		dependencies_.functions.push_back(std::make_pair(library_, index));
+		return true;
+	}
+
+private:
+	image_dependencies& dependencies_;
+	uint32_t library_;
+
+	dependency_visitor(const dependency_visitor&);
+	dependency_visitor& operator=(const dependency_visitor&);
+};
+
+//Default constructor
+dependency_graph::dependency_graph()
+	:image_count_(0), error_count_(0)
+{}
+
+//Returns table of interned module and function names
+const string_table& dependency_graph::get_names() const
+{
+	return names_;
+}
+
+//Returns id of module name (name is converted to lower case)
+uint32_t dependency_graph::get_module_id(const std::string& name)
+{
+	return names_.intern(module_name_to_lower(name.data(), name.length()));
+}
+
+//Adds dependencies of image, "module_name" is name of image
+void dependency_graph::add_image(const std::string& module_name, const pe_base& image)
+{
+	//Collect dependencies without locking the graph
+	image_dependencies dependencies;
+	uint32_t module = dependencies.add_name(module_name_to_lower(module_name.data(), module_name.length()));
+	dependency_visitor visitor(dependencies);
+	enumerate_imports(image, visitor);
+
+	if(image.has_bound_import())
+	{
+		const bound_import_module_list bound_imports(get_bound_import_module_list(image));
+		for(bound_import_module_list::const_iterator it = bound_imports.begin(); it != bound_imports.end(); ++it)
+		{
+			const std::string& library_name = (*it).get_module_name();
+			uint32_t library = dependencies.add_name(module_name_to_lower(library_name.data(), library_name.length()));
+			dependencies.bound.push_back(std::make_pair(module, library));
+
+			//Bound library forwards functions to referenced modules
+			const bound_import::ref_list& refs = (*it).get_module_ref_list();
+			for(bound_import::ref_list::const_iterator ref = refs.begin(); ref != refs.end(); ++ref)
+			{
+				const std::string& ref_name = (*ref).get_module_name();
+				dependencies.bound.push_back(std::make_pair(library, dependencies.add_name(module_name_to_lower(ref_name.data(), ref_name.length()))));
+			}
+		}
+	}
+
+	//Image is parsed, names are interned and their indexes are replaced with ids
+	std::vector<uint32_t> ids(dependencies.names.size());
+	for(std::size_t i = 0; i != dependencies.names.size(); ++i)
+		ids[i] = names_.intern(dependencies.names[i]);
+
+	module = ids[module];
+	for(std::vector<std::pair<uint32_t, uint32_t> >::iterator it = dependencies.functions.begin(); it != dependencies.functions.end(); ++it)
+	{
+		(*it).first = ids[(*it).first];
+		if((*it).second != static_cast<uint32_t>(-1))
+			(*it).second = ids[(*it).second];
+	}
+
+	for(std::vector<std::pair<uint32_t, uint32_t> >::iterator it = dependencies.bound.begin(); it != dependencies.bound.end(); ++it)
+	{
+		(*it).first = ids[(*it).first];
+		(*it).second = ids[(*it).second];
+	}
+
+	//Several import descriptors and bound entries can reference one library,
+	//edge counts are incremented once per image
+	std::sort(dependencies.bound.begin(), dependencies.bound.end());
+	dependencies.bound.erase(std::unique(dependencies.bound.begin(), dependencies.bound.end()), dependencies.bound.end());
+
+	std::set<uint32_t> libraries;
+
+	pe_lock lock(mutex_);
+	for(std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = dependencies.functions.begin(); it != dependencies.functions.end(); ++it)
+	{
+		edge_key key(module, (*it).first);
+		edge_data& data = edges_[key];
+		if(libraries.insert((*it).first).second)
+		{
+			++data.image_count;
+			reverse_edges_.insert(edge_key(key.second, key.first));
+		}
+
+		if((*it).second != static_cast<uint32_t>(-1))
+			data.functions.insert((*it).second);
+	}
+
+	for(std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = dependencies.bound.begin(); it != dependencies.bound.end(); ++it)
+	{
+		++edges_[*it].bound_count;
+		reverse_edges_.insert(edge_key((*it).second, (*it).first));
+	}
+
+	++image_count_;
+}
+
+//Helper: bulk scanning callback, which adds images to dependency graph
+class dependency_scan_callback : public pe_scan_callback
+{
+public:
+	explicit dependency_scan_callback(dependency_graph& graph)
+		:graph_(graph)
+	{}
+
+	virtual void on_image(std::size_t /*index*/, const std::string& path, pe_base& image)
+	{
+		std::string::size_type pos = path.find_last_of("/\\");
+		graph_.add_image(pos == std::string::npos ? path : path.substr(pos + 1), image);
+	}
+
+	virtual void on_error(std::size_t /*index*/, const std::string& /*path*/, const pe_exception& /*error*/)
+	{
+		pe_lock lock(graph_.mutex_);
+		++graph_.error_count_;
+	}
+
+private:
+	dependency_graph& graph_;
+
+	dependency_scan_callback(const dependency_scan_callback&);
+	dependency_scan_callback& operator=(const dependency_scan_callback&);
+};
+
+//Adds files "paths" on several threads
+void dependency_graph::scan(const std::vector<std::string>& paths, unsigned int threads)
+{
+	dependency_scan_callback callback(*this);
+	pe_factory::scan(paths, callback, threads, false);
+}
+
+//Adds all files of directory "directory" and its subdirectories
+void dependency_graph::scan_directory(const std::string& directory, unsigned int threads)
+{
+	std::vector<std::string> files;
+	list_files(directory, files);
+	scan(files, threads);
+}
+
+//Returns number of added images
+std::size_t dependency_graph::get_image_count() const
+{
+	pe_lock lock(mutex_);
+	return image_count_;
+}
+
+//Returns number of skipped files
+std::size_t dependency_graph::get_error_count() const
+{
+	pe_lock lock(mutex_);
+	return error_count_;
+}
+
+//Returns all edges sorted by ids of importing and imported modules
+dependency_graph::edge_list dependency_graph::get_edges() const
+{
+	pe_lock lock(mutex_);
+
+	edge_list ret;
+	ret.reserve(edges_.size());
+	for(edge_map::const_iterator it = edges_.begin(); it != edges_.end(); ++it)
+	{
+		ret.push_back(edge());
+		edge& e = ret.back();
+		e.set_modules((*it).first.first, (*it).first.second);
+		e.set_counts((*it).second.image_count, (*it).second.bound_count);
+		e.get_functions().assign((*it).second.functions.begin(), (*it).second.functions.end());
+	}
+
+	return ret;
+}
+
+//Returns true and edge, if module "from" imports library "to"
+bool dependency_graph::find_edge(uint32_t from, uint32_t to, edge& result) const
+{
+	pe_lock lock(mutex_);
+
+	edge_map::const_iterator it = edges_.find(edge_key(from, to));
+	if(it == edges_.end())
+		return false;
+
+	result.set_modules(from, to);
+	result.set_counts((*it).second.image_count, (*it).second.bound_count);
+	result.get_functions().assign((*it).second.functions.begin(), (*it).second.functions.end());
+	return true;
+}
+
+//Helper: returns key of direct edge
+template<typename Value>
+const std::pair<uint32_t, uint32_t>& get_edge_key(const Value& value)
+{
+	return value.first;
+}
+
+//Helper: returns key of reverse edge
+const std::pair<uint32_t, uint32_t>& get_edge_key(const std::pair<uint32_t, uint32_t>& value)
+{
+	return value;
+}
+
+//Returns sorted ids of modules adjacent to "module" in "edges" (which are direct or reverse edges)
+template<typename Edges>
+std::vector<uint32_t> dependency_graph::get_adjacent(const Edges& edges, uint32_t module, bool transitive)
+{
+	std::set<uint32_t> visited;
+	std::vector<uint32_t> queue(1, module);
+
+	//Breadth-first search, edges of module are adjacent in sorted container
+	for(std::size_t i = 0; i != queue.size(); ++i)
+	{
+		for(typename Edges::const_iterator it = edges.lower_bound(edge_key(queue[i], 0));
+			it != edges.end() && get_edge_key(*it).first == queue[i]; ++it)
+		{
+			uint32_t next = get_edge_key(*it).second;
+			if(visited.insert(next).second && transitive)
+				queue.push_back(next);
+		}
+	}
+
+	//Module depends on itself only if there is a loop
+	return std::vector<uint32_t>(visited.begin(), visited.end());
+}
+
+//Returns sorted ids of modules, which module "module" imports
+std::vector<uint32_t> dependency_graph::get_dependencies(uint32_t module, bool transitive) const
+{
+	pe_lock lock(mutex_);
+	return get_adjacent(edges_, module, transitive);
+}
+
+//Returns sorted ids of modules, which import module "module"
+std::vector<uint32_t> dependency_graph::get_dependents(uint32_t module, bool transitive) const
+{
+	pe_lock lock(mutex_);
+	return get_adjacent(reverse_edges_, module, transitive);
+}
+
+//Lists all files of directory "directory" and its subdirectories
+void dependency_graph::list_files(const std::string& directory, std::vector<std::string>& files)
+{
+	std::vector<std::string> directories(1, directory);
+	for(std::size_t i = 0; i != directories.size(); ++i)
+	{
+		//Copy, vector can be reallocated
+		std::string current(directories[i]);
+
+#ifdef PE_BLISS_WINDOWS
+		WIN32_FIND_DATAA data;
+		HANDLE find = FindFirstFileA((current + "\\*").c_str(), &data);
+		if(find == INVALID_HANDLE_VALUE)
+		{
+			if(!i)
+				throw pe_exception("Cannot open directory", pe_exception::error_reading_file);
+
+			continue;
+		}
+
+		do
+		{
+			std::string name(data.cFileName);
+			if(name == "." || name == "..")
+				continue;
+
+			if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				if(!(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+					directories.push_back(current + "\\" + name);
+			}
+			else
+			{
+				files.push_back(current + "\\" + name);
+			}
+		}
+		while(FindNextFileA(find, &data));
+
+		FindClose(find);
+#else
+		DIR* dir = opendir(current.c_str());
+		if(!dir)
+		{
+			if(!i)
+				throw pe_exception("Cannot open directory", pe_exception::error_reading_file);
+
+			continue;
+		}
+
+		while(dirent* entry = readdir(dir))
+		{
+			std::string name(entry->d_name);
+			if(name == "." || name == "..")
+				continue;
+
+			std::string path(current + "/" + name);
+			struct stat st;
+			if(lstat(path.c_str(), &st) == -1)
+				continue;
+
+			if(S_ISDIR(st.st_mode))
+				directories.push_back(path);
+			else if(S_ISREG(st.st_mode))
+				files.push_back(path);
+		}
+
+		closedir(dir);
+#endif
+	}
+}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <deque>
+#include "pe_structures.h"
+#include "pe_base.h"
+#include "pe_threads.h"
+
+namespace pe_bliss
+{
+//Table of interned strings, which can be used from several threads
+//Each string gets its own id, ids are assigned sequentially starting from zero
+class string_table
+{
+public:
+	//Default constructor
+	string_table();
+
+	//Returns id of string, adds string to table if it is not there yet
+	uint32_t intern(const char* data, std::size_t length);
+	uint32_t intern(const std::string& str);
+	//Returns true and id of string, if string is in table
+	bool find(const std::string& str, uint32_t& id) const;
+
+	//Returns string with id "id"
+	//References stay valid while table exists
+	const std::string& get(uint32_t id) const;
+	//Returns number of strings in table
+	std::size_t size() const;
+
+private:
+	//Strings are distributed between shards by hash, so threads interning different strings rarely wait
+	enum { shard_count = 16 };
+
+	struct shard
+	{
+		pe_mutex mutex;
+		std::map<std::string, uint32_t> ids;
+	};
+
+	mutable shard shards_[shard_count];
+
+	//Strings by id
+	mutable pe_mutex strings_mutex_;
+	std::deque<std::string> strings_;
+
+	//Returns shard of string
+	shard& get_shard(const char* data, std::size_t length) const;
+
+	string_table(const string_table&);
+	string_table& operator=(const string_table&);
+};
+
+//Graph of dependencies between modules (executable images and DLLs)
+//Nodes are module names (in lower case), edges are "module imports library" relations
+//Edges are built from import directories (and bound import directories) of images,
+//each edge is stored once and counts images, where it was found
+//Module and function names are interned in one string table, nodes are ids of their names
+//Images can be added from several threads
+class dependency_graph
+{
+public:
+	//Edge of graph
+	class edge
+	{
+	public:
+		//Default constructor
+		edge();
+
+		//Returns id of importing module name
+		uint32_t get_from() const;
+		//Returns id of imported library name
+		uint32_t get_to() const;
+		//Returns number of images, which import library
+		uint32_t get_image_count() const;
+		//Returns number of images, which have library in bound import directory
+		uint32_t get_bound_count() const;
+		//Returns sorted ids of imported function names
+		//(functions imported by ordinal are named "#ordinal")
+		const std::vector<uint32_t>& get_functions() const;
+
+	public: //Setters, they are used by graph
+		//Sets ids of module names
+		void set_modules(uint32_t from, uint32_t to);
+		//Sets counters
+		void set_counts(uint32_t image_count, uint32_t bound_count);
+		//Returns imported functions list for changing
+		std::vector<uint32_t>& get_functions();
+
+	private:
+		uint32_t from_, to_;
+		uint32_t image_count_, bound_count_;
+		std::vector<uint32_t> functions_;
+	};
+
+	typedef std::vector<edge> edge_list;
+
+public:
+	//Default constructor
+	dependency_graph();
+
+	//Returns table of interned module and function names
+	const string_table& get_names() const;
+	//Returns id of module name (name is converted to lower case)
+	uint32_t get_module_id(const std::string& name);
+
+	//Adds dependencies of image, "module_name" is name of image
+	//Throws an exception if import directory of image is incorrect, graph is not changed then
+	void add_image(const std::string& module_name, const pe_base& image);
+
+	//Adds files "paths" on several threads (see pe_factory::scan), module names are file names
+	//Files, which are not correct PE images, are skipped and counted
+	//If threads = 0, number of logical processors is used
+	void scan(const std::vector<std::string>& paths, unsigned int threads = 0);
+	//Adds all files of directory "directory" and its subdirectories
+	//Throws an exception if directory can't be opened
+	void scan_directory(const std::string& directory, unsigned int threads = 0);
+
+	//Returns number of added images
+	std::size_t get_image_count() const;
+	//Returns number of skipped files
+	std::size_t get_error_count() const;
+
+	//Returns all edges sorted by ids of importing and imported modules
+	edge_list get_edges() const;
+	//Returns true and edge, if module "from" imports library "to"
+	bool find_edge(uint32_t from, uint32_t to, edge& result) const;
+
+	//Returns sorted ids of modules, which module "module" imports
+	//If transitive = true, returns transitive closure (all direct and indirect dependencies)
+	std::vector<uint32_t> get_dependencies(uint32_t module, bool transitive = false) const;
+	//Returns sorted ids of modules, which import module "module"
+	//If transitive = true, returns all direct and indirect dependents
+	std::vector<uint32_t> get_dependents(uint32_t module, bool transitive = false) const;
+
+	//Lists all files of directory "directory" and its subdirectories (symbolic links are not followed)
+	//Throws an exception if directory can't be opened
+	static void list_files(const std::string& directory, std::vector<std::string>& files);
+
+private:
+	//Edge data
+	struct edge_data
+	{
+		edge_data();
+
+		uint32_t image_count;
+		uint32_t bound_count;
+		std::set<uint32_t> functions;
+	};
+
+	typedef std::pair<uint32_t, uint32_t> edge_key;
+	typedef std::map<edge_key, edge_data> edge_map;
+
+	string_table names_;
+
+	mutable pe_mutex mutex_;
+	edge_map edges_;
+	//Reverse edges (imported library, importing module)
+	std::set<edge_key> reverse_edges_;
+	std::size_t image_count_;
+	std::size_t error_count_;
+
+	//Scanning callback
+	friend class dependency_scan_callback;
+
+	//Returns sorted ids of modules adjacent to "module" in "edges" (which are direct or reverse edges)
+	template<typename Edges>
+	static std::vector<uint32_t> get_adjacent(const Edges& edges, uint32_t module, bool transitive);
+
+	dependency_graph(const dependency_graph&);
+	dependency_graph& operator=(const dependency_graph&);
+};
+}
@@ -153,7 +153,7 @@ uint32_t basic_dotnet_info::get_size_of_managed_native_header() const
 
 //Returns basic .NET information
 //If image is not native, throws an exception
-const basic_dotnet_info get_basic_dotnet_info(const pe_base& pe)
+basic_dotnet_info get_basic_dotnet_info(const pe_base& pe)
 {
 	//If there's no debug directory, return empty list
 	if(!pe.is_dotnet())
@@ -72,5 +72,5 @@ private:
 
 //Returns basic .NET information
 //If image is not native, throws an exception
-const basic_dotnet_info get_basic_dotnet_info(const pe_base& pe);
+basic_dotnet_info get_basic_dotnet_info(const pe_base& pe);
 }
@@ -111,7 +111,7 @@ uint8_t exception_entry::get_scaled_rsp_offset() const
 
 //Returns exception directory data (exists on PE+ only)
 //Unwind opcodes are not listed, because their format and list are subject to change
-const exception_entry_list get_exception_directory_data(const pe_base& pe)
+exception_entry_list get_exception_directory_data(const pe_base& pe)
 {
 	exception_entry_list ret;
 
@@ -63,5 +63,5 @@ typedef std::vector<exception_entry> exception_entry_list;
 
 //Returns exception directory data (exists on PE+ only)
 //Unwind opcodes are not listed, because their format and list are subject to change
-const exception_entry_list get_exception_directory_data(const pe_base& pe);
+exception_entry_list get_exception_directory_data(const pe_base& pe);
 }
@@ -234,18 +234,97 @@ void export_info::set_rva_of_name_ordinals(uint32_t rva_of_name_ordinals)
 	address_of_name_ordinals_ = rva_of_name_ordinals;
 }
 
-const exported_functions_list get_exported_functions(const pe_base& pe, export_info* info);
+//Default constructor
+exported_function_view::exported_function_view()
+	:ordinal_(0), rva_(0), has_name_(false), name_ordinal_(0), forward_(false)
+{}
 
-//Returns array of exported functions
-const exported_functions_list get_exported_functions(const pe_base& pe)
+//Returns ordinal of function (actually, ordinal = hint + ordinal base)
+uint16_t exported_function_view::get_ordinal() const
 {
-	return get_exported_functions(pe, 0);
+	return ordinal_;
 }
 
-//Returns array of exported functions and information about export
-const exported_functions_list get_exported_functions(const pe_base& pe, export_info& info)
+//Returns RVA of function
+uint32_t exported_function_view::get_rva() const
 {
-	return get_exported_functions(pe, &info);
+	return rva_;
+}
+
+//Returns true if function has name and name ordinal
+bool exported_function_view::has_name() const
+{
+	return has_name_;
+}
+
+//Returns name of function
+const name_view& exported_function_view::get_name() const
+{
+	return name_;
+}
+
+//Returns name ordinal of function
+uint16_t exported_function_view::get_name_ordinal() const
+{
+	return name_ordinal_;
+}
+
+//Returns true if function is forwarded to other library
+bool exported_function_view::is_forwarded() const
+{
+	return forward_;
+}
+
+//Returns the name of forwarded function
+const name_view& exported_function_view::get_forwarded_name() const
+{
+	return forward_name_;
+}
+
+//Returns exported function, which owns copies of names
+exported_function exported_function_view::to_exported_function() const
+{
+	exported_function func;
+	func.set_ordinal(ordinal_);
+	func.set_rva(rva_);
+
+	if(has_name_)
+	{
+		func.set_name(name_.to_string());
+		func.set_name_ordinal(name_ordinal_);
+	}
+
+	if(forward_)
+		func.set_forwarded_name(forward_name_.to_string());
+
+	return func;
+}
+
+//Sets ordinal of function
+void exported_function_view::set_ordinal(uint16_t ordinal)
+{
+	ordinal_ = ordinal;
+}
+
+//Sets RVA of function
+void exported_function_view::set_rva(uint32_t rva)
+{
+	rva_ = rva;
+}
+
+//Sets name of function and its name ordinal
+void exported_function_view::set_name(const name_view& name, uint16_t name_ordinal)
+{
+	name_ = name;
+	name_ordinal_ = name_ordinal;
+	has_name_ = true;
+}
+
+//Sets forwarded function name
+void exported_function_view::set_forwarded_name(const name_view& name)
+{
+	forward_name_ = name;
+	forward_ = true;
 }
 
 //Helper: sorts exported function list by ordinals
@@ -255,12 +334,11 @@ public:
 		bool operator()(const exported_function& func1, const exported_function& func2) const;
 };
 
-//Returns array of exported functions and information about export (if info != 0)
-const exported_functions_list get_exported_functions(const pe_base& pe, export_info* info)
+//Helper: walks export directory and passes exported functions, which names are not copied, to sink
+//Saves information about export to "info" (if info != 0)
+template<typename Sink>
+void walk_exports(const pe_base& pe, export_info* info, Sink& sink)
 {
-	//Returned exported functions info array
-	std::vector<exported_function> ret;
-
 	if(pe.has_exports())
 	{
 		//Check the length in bytes of the section containing export directory
@@ -284,11 +362,9 @@ const exported_functions_list get_exported_functions(const pe_base& pe, export_i
 			if((max_name_length = pe.section_data_length_from_rva(exports.Name, exports.Name, section_data_virtual, true)) < 2)
 				throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 
-			//Get dll name pointer
-			const char* dll_name = pe.section_data_from_rva(exports.Name, section_data_virtual, true);
-
-			//Check for null-termination
-			if(!pe_utils::is_null_terminated(dll_name, max_name_length))
+			//Get dll name and check for null-termination
+			std::string dll_name;
+			if(!pe.read_string_from_rva(exports.Name, dll_name, true))
 				throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 
 			//Save the rest of export information data
@@ -303,7 +379,7 @@ const exported_functions_list get_exported_functions(const pe_base& pe, export_i
 		}
 
 		if(!exports.NumberOfFunctions)
-			return ret;
+			return;
 
 		//Check IMAGE_EXPORT_DIRECTORY fields
 		if(exports.NumberOfNames > exports.NumberOfFunctions)
@@ -338,6 +414,22 @@ const exported_functions_list get_exported_functions(const pe_base& pe, export_i
 				throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 		}
 		
+		//Invert name ordinal table: index of the first name of each function (or no_name)
+		//This is done once, so parsing takes linear time of number of functions and names
+		const uint32_t no_name = static_cast<uint32_t>(-1);
+		std::vector<uint32_t> name_indexes(exports.NumberOfFunctions, no_name);
+		if(exports.NumberOfNames)
+		{
+			std::vector<uint16_t> name_ordinals(exports.NumberOfNames);
+			pe.read_data_from_rva(exports.AddressOfNameOrdinals, reinterpret_cast<char*>(&name_ordinals[0]), exports.NumberOfNames * sizeof(uint16_t), true);
+
+			for(uint32_t i = 0; i < exports.NumberOfNames; i++)
+			{
+				if(name_ordinals[i] < exports.NumberOfFunctions && name_indexes[name_ordinals[i]] == no_name)
+					name_indexes[name_ordinals[i]] = i;
+			}
+		}
+
 		for(uint32_t ordinal = 0; ordinal < exports.NumberOfFunctions; ordinal++)
 		{
 			//Get function address
@@ -348,7 +440,7 @@ const exported_functions_list get_exported_functions(const pe_base& pe, export_i
 			if(!rva)
 				continue;
 
-			exported_function func;
+			exported_function_view func;
 			func.set_rva(rva);
 
 			if(!pe_utils::is_sum_safe(exports.Base, ordinal) || exports.Base + ordinal > pe_utils::max_word)
@@ -356,66 +448,124 @@ const exported_functions_list get_exported_functions(const pe_base& pe, export_i
 
 			func.set_ordinal(static_cast<uint16_t>(ordinal + exports.Base));
 
-			//Scan for function name ordinal
-			for(uint32_t i = 0; i < exports.NumberOfNames; i++)
+			//If function has name (and name ordinal)
+			uint32_t i = name_indexes[ordinal];
+			if(i != no_name)
 			{
-				uint16_t ordinal2 = pe.section_data_from_rva<uint16_t>(exports.AddressOfNameOrdinals + i * sizeof(uint16_t), section_data_virtual, true);
+				//Get function name
+				//Sum and multiplication are safe (checked above)
+				uint32_t function_name_rva = pe.section_data_from_rva<uint32_t>(exports.AddressOfNames + i * sizeof(uint32_t), section_data_virtual, true);
 
-				//If function has name (and name ordinal)
-				if(ordinal == ordinal2)
-				{
-					//Get function name
-					//Sum and multiplication are safe (checked above)
-					uint32_t function_name_rva = pe.section_data_from_rva<uint32_t>(exports.AddressOfNames + i * sizeof(uint32_t), section_data_virtual, true);
+				//Get byte count that we have for function name
+				if((max_name_length = pe.section_data_length_from_rva(function_name_rva, function_name_rva, section_data_virtual, true)) < 2)
+					throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 
-					//Get byte count that we have for function name
-					if((max_name_length = pe.section_data_length_from_rva(function_name_rva, function_name_rva, section_data_virtual, true)) < 2)
-						throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+				//Get function name and check for null-termination
+				name_view func_name;
+				if(!pe.read_string_from_rva(function_name_rva, func_name, true))
+					throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 
-					//Get function name pointer
-					const char* func_name = pe.section_data_from_rva(function_name_rva, section_data_virtual, true);
+				//Save function info
+				func.set_name(func_name, static_cast<uint16_t>(ordinal));
 
-					//Check for null-termination
-					if(!pe_utils::is_null_terminated(func_name, max_name_length))
+				//If the function is just a redirect, save its name
+				if(rva >= pe.get_directory_rva(image_directory_entry_export) + sizeof(image_directory_entry_export) &&
+					rva < pe.get_directory_rva(image_directory_entry_export) + pe.get_directory_size(image_directory_entry_export))
+				{
+					if((max_name_length = pe.section_data_length_from_rva(rva, rva, section_data_virtual, true)) < 2)
 						throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 
-					//Save function info
-					func.set_name(func_name);
-					func.set_name_ordinal(ordinal2);
+					//Get forwarded function name and check for null-termination
+					name_view forwarded_func_name;
+					if(!pe.read_string_from_rva(rva, forwarded_func_name, true))
+						throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
 
-					//If the function is just a redirect, save its name
-					if(rva >= pe.get_directory_rva(image_directory_entry_export) + sizeof(image_directory_entry_export) &&
-						rva < pe.get_directory_rva(image_directory_entry_export) + pe.get_directory_size(image_directory_entry_export))
-					{
-						if((max_name_length = pe.section_data_length_from_rva(rva, rva, section_data_virtual, true)) < 2)
-							throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+					//Set the name of forwarded function
+					func.set_forwarded_name(forwarded_func_name);
+				}
+			}
 
-						//Get forwarded function name pointer
-						const char* forwarded_func_name = pe.section_data_from_rva(rva, section_data_virtual, true);
+			//Pass function info to sink
+			sink.on_function(func);
+		}
+	}
+}
 
-						//Check for null-termination
-						if(!pe_utils::is_null_terminated(forwarded_func_name, max_name_length))
-							throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+//Helper: export walker sink, which collects function views
+struct export_view_collector
+{
+	explicit export_view_collector(exported_function_view_list& functions)
+		:functions(functions)
+	{}
 
-						//Set the name of forwarded function
-						func.set_forwarded_name(forwarded_func_name);
-					}
+	void on_function(const exported_function_view& func)
+	{
+		functions.push_back(func);
+	}
 
-					break;
-				}
-			}
+	exported_function_view_list& functions;
 
-			//Add function info to output array
-			ret.push_back(func);
-		}
+private:
+	export_view_collector& operator=(const export_view_collector&);
+};
+
+//Helper: export walker sink, which fills exported functions list (names are copied)
+struct export_list_collector
+{
+	explicit export_list_collector(exported_functions_list& functions)
+		:functions(functions)
+	{}
+
+	void on_function(const exported_function_view& func)
+	{
+		functions.push_back(func.to_exported_function());
 	}
 
+	exported_functions_list& functions;
+
+private:
+	export_list_collector& operator=(const export_list_collector&);
+};
+
+//Returns array of exported functions
+exported_functions_list get_exported_functions(const pe_base& pe)
+{
+	exported_functions_list ret;
+	export_list_collector collector(ret);
+	walk_exports(pe, 0, collector);
+	return ret;
+}
+
+//Returns array of exported functions and information about export
+exported_functions_list get_exported_functions(const pe_base& pe, export_info& info)
+{
+	exported_functions_list ret;
+	export_list_collector collector(ret);
+	walk_exports(pe, &info, collector);
+	return ret;
+}
+
+//Returns array of exported functions, which names are not copied
+exported_function_view_list get_exported_function_views(const pe_base& pe)
+{
+	exported_function_view_list ret;
+	export_view_collector collector(ret);
+	walk_exports(pe, 0, collector);
+	return ret;
+}
+
+//Returns array of exported functions, which names are not copied, and information about export
+exported_function_view_list get_exported_function_views(const pe_base& pe, export_info& info)
+{
+	exported_function_view_list ret;
+	export_view_collector collector(ret);
+	walk_exports(pe, &info, collector);
 	return ret;
 }
 
 //Helper export functions
 //Returns pair: <ordinal base for supplied functions; maximum ordinal value for supplied functions>
-const std::pair<uint16_t, uint16_t> get_export_ordinal_limits(const exported_functions_list& exports)
+std::pair<uint16_t, uint16_t> get_export_ordinal_limits(const exported_functions_list& exports)
 {
 	if(exports.empty())
 		return std::make_pair(0, 0);
@@ -458,6 +608,219 @@ bool exported_ordinal_exists(uint16_t ordinal, const exported_functions_list& ex
 	return false;
 }
 
+//Helper: index of absent exported function in export_index tables
+const uint32_t no_exported_function = static_cast<uint32_t>(-1);
+
+//Default constructor (empty index)
+export_index::export_index()
+	:ordinal_base_(0)
+{}
+
+//Builds index of exports of image
+export_index::export_index(const pe_base& pe)
+	:exports_(pe_bliss::get_exported_functions(pe)), ordinal_base_(0)
+{
+	build();
+}
+
+//Builds index of exported functions list
+export_index::export_index(const exported_functions_list& exports)
+	:exports_(exports), ordinal_base_(0)
+{
+	build();
+}
+
+//Returns indexed exported functions
+const exported_functions_list& export_index::get_exported_functions() const
+{
+	return exports_;
+}
+
+//Returns exported function by name or zero, if there is no such function
+const exported_function* export_index::find_by_name(const std::string& name) const
+{
+	return find_by_name(name.data(), name.length());
+}
+
+//Returns exported function by name or zero, if there is no such function
+const exported_function* export_index::find_by_name(const char* name, std::size_t length) const
+{
+	if(names_.empty())
+		return 0;
+
+	std::size_t mask = names_.size() - 1;
+	for(std::size_t slot = hash_name(name, length) & mask; names_[slot] != no_exported_function; slot = (slot + 1) & mask)
+	{
+		const std::string& function_name = exports_[names_[slot]].get_name();
+		if(function_name.length() == length && !memcmp(function_name.data(), name, length))
+			return &exports_[names_[slot]];
+	}
+
+	return 0;
+}
+
+//Returns exported function by ordinal or zero, if there is no such function
+const exported_function* export_index::find_by_ordinal(uint16_t ordinal) const
+{
+	if(ordinal < ordinal_base_ || static_cast<uint32_t>(ordinal - ordinal_base_) >= ordinals_.size())
+		return 0;
+
+	uint32_t index = ordinals_[ordinal - ordinal_base_];
+	return index == no_exported_function ? 0 : &exports_[index];
+}
+
+//Builds index of exports_
+void export_index::build()
+{
+	if(exports_.empty())
+		return;
+
+	//Ordinal table
+	std::pair<uint16_t, uint16_t> limits = get_export_ordinal_limits(exports_);
+	ordinal_base_ = limits.first;
+	ordinals_.assign(limits.second - limits.first + 1, no_exported_function);
+
+	std::size_t named_count = 0;
+	for(uint32_t i = 0; i != exports_.size(); ++i)
+	{
+		uint32_t& index = ordinals_[exports_[i].get_ordinal() - ordinal_base_];
+		if(index == no_exported_function)
+			index = i;
+
+		if(exports_[i].has_name())
+			++named_count;
+	}
+
+	if(!named_count)
+		return;
+
+	//Name hash table is filled at most by half
+	std::size_t size = 1;
+	while(size < named_count * 2)
+		size <<= 1;
+
+	names_.assign(size, no_exported_function);
+	std::size_t mask = size - 1;
+	for(uint32_t i = 0; i != exports_.size(); ++i)
+	{
+		if(!exports_[i].has_name())
+			continue;
+
+		const std::string& name = exports_[i].get_name();
+		std::size_t slot = hash_name(name.data(), name.length()) & mask;
+		for(; names_[slot] != no_exported_function; slot = (slot + 1) & mask)
+		{
+			//The first function with the same name is kept
+			if(exports_[names_[slot]].get_name() == name)
+				break;
+		}
+
+		if(names_[slot] == no_exported_function)
+			names_[slot] = i;
+	}
+}
+
+//Returns hash of name (FNV-1a)
+uint32_t export_index::hash_name(const char* name, std::size_t length)
+{
+	uint32_t hash = 2166136261u;
+	for(std::size_t i = 0; i != length; ++i)
+	{
+		hash ^= static_cast<uint8_t>(name[i]);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+//Helper: compares null-terminated export name at RVA with "name" (like strcmp)
+//End of section raw data terminates the name
+int compare_export_name(const pe_base& pe, uint32_t name_rva, const std::string& name)
+{
+	uint32_t available = pe.section_data_length_from_rva(name_rva, name_rva, section_data_raw, true);
+	const char* data = available ? pe.section_data_from_rva(name_rva, section_data_raw, true) : 0;
+
+	for(std::size_t i = 0; ; ++i)
+	{
+		uint8_t left = i < available ? static_cast<uint8_t>(data[i]) : 0;
+		uint8_t right = i < name.length() ? static_cast<uint8_t>(name[i]) : 0;
+		if(left != right)
+			return left < right ? -1 : 1;
+
+		if(!left)
+			return 0;
+	}
+}
+
+//Helper: reads export directory of image, returns false if image has no exports
+bool read_export_directory(const pe_base& pe, image_export_directory& exports)
+{
+	if(!pe.has_exports())
+		return false;
+
+	if(pe.section_data_length_from_rva(pe.get_directory_rva(image_directory_entry_export),
+		pe.get_directory_rva(image_directory_entry_export), section_data_virtual, true)
+		< sizeof(image_export_directory))
+		throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+
+	exports = pe.section_data_from_rva<image_export_directory>(pe.get_directory_rva(image_directory_entry_export), section_data_virtual, true);
+	return true;
+}
+
+//Finds exported function by name with binary search over export name pointer table, as Windows loader does
+bool find_exported_function(const pe_base& pe, const std::string& name, uint32_t& rva, uint16_t& ordinal)
+{
+	image_export_directory exports;
+	if(!read_export_directory(pe, exports) || !exports.NumberOfNames || !exports.AddressOfNames || !exports.AddressOfNameOrdinals)
+		return false;
+
+	//Table reads below check bounds
+	uint32_t low = 0, high = exports.NumberOfNames;
+	while(low < high)
+	{
+		uint32_t middle = low + (high - low) / 2;
+		if(!pe_utils::is_sum_safe(exports.AddressOfNames, middle * sizeof(uint32_t))
+			|| !pe_utils::is_sum_safe(exports.AddressOfNameOrdinals, middle * sizeof(uint16_t)))
+			throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+
+		uint32_t name_rva = pe.section_data_from_rva<uint32_t>(exports.AddressOfNames + middle * sizeof(uint32_t), section_data_virtual, true);
+		int result = compare_export_name(pe, name_rva, name);
+		if(result < 0)
+		{
+			low = middle + 1;
+		}
+		else if(result > 0)
+		{
+			high = middle;
+		}
+		else
+		{
+			uint16_t name_ordinal = pe.section_data_from_rva<uint16_t>(exports.AddressOfNameOrdinals + middle * sizeof(uint16_t), section_data_virtual, true);
+			if(name_ordinal >= exports.NumberOfFunctions || !pe_utils::is_sum_safe(exports.Base, name_ordinal) || exports.Base + name_ordinal > pe_utils::max_word)
+				throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+
+			rva = pe.section_data_from_rva<uint32_t>(exports.AddressOfFunctions + name_ordinal * sizeof(uint32_t), section_data_virtual, true);
+			ordinal = static_cast<uint16_t>(exports.Base + name_ordinal);
+			return rva != 0;
+		}
+	}
+
+	return false;
+}
+
+//Returns RVA of function exported by ordinal, or zero if there is no such function
+uint32_t find_exported_function(const pe_base& pe, uint16_t ordinal)
+{
+	image_export_directory exports;
+	if(!read_export_directory(pe, exports) || ordinal < exports.Base || ordinal - exports.Base >= exports.NumberOfFunctions)
+		return 0;
+
+	if(!pe_utils::is_sum_safe(exports.AddressOfFunctions, (ordinal - exports.Base) * sizeof(uint32_t)))
+		throw pe_exception("Incorrect export directory", pe_exception::incorrect_export_directory);
+
+	return pe.section_data_from_rva<uint32_t>(exports.AddressOfFunctions + (ordinal - exports.Base) * sizeof(uint32_t), section_data_virtual, true);
+}
+
 //Helper: sorts exported function list by ordinals
 bool ordinal_sorter::operator()(const exported_function& func1, const exported_function& func2) const
 {
@@ -476,7 +839,7 @@ bool ordinal_sorter::operator()(const exported_function& func1, const exported_f
 //Returns new export directory information
 //exported_functions_list is copied intentionally to be sorted by ordinal values later
 //Name ordinals in exported function don't matter, they will be recalculated
-const image_directory rebuild_exports(pe_base& pe, const export_info& info, exported_functions_list exports, section& exports_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
+image_directory rebuild_exports(pe_base& pe, const export_info& info, exported_functions_list exports, section& exports_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
 {
 	//Check that exports_section is attached to this PE image
 	if(!pe.section_attached(exports_section))
@@ -59,6 +59,54 @@ private:
 	std::string forward_name_; //Name of forwarded function
 };
 
+//Class representing exported function, which names reference image data (they are not copied)
+//Names are valid while image exists and its data is not changed
+class exported_function_view
+{
+public:
+	//Default constructor
+	exported_function_view();
+
+	//Returns ordinal of function (actually, ordinal = hint + ordinal base)
+	uint16_t get_ordinal() const;
+	//Returns RVA of function
+	uint32_t get_rva() const;
+
+	//Returns true if function has name and name ordinal
+	bool has_name() const;
+	//Returns name of function
+	const name_view& get_name() const;
+	//Returns name ordinal of function
+	uint16_t get_name_ordinal() const;
+
+	//Returns true if function is forwarded to other library
+	bool is_forwarded() const;
+	//Returns the name of forwarded function
+	const name_view& get_forwarded_name() const;
+
+	//Returns exported function, which owns copies of names
+	exported_function to_exported_function() const;
+
+public: //Setters, they are used by export parser
+	//Sets ordinal of function
+	void set_ordinal(uint16_t ordinal);
+	//Sets RVA of function
+	void set_rva(uint32_t rva);
+	//Sets name of function and its name ordinal
+	void set_name(const name_view& name, uint16_t name_ordinal);
+	//Sets forwarded function name
+	void set_forwarded_name(const name_view& name);
+
+private:
+	uint16_t ordinal_; //Function ordinal
+	uint32_t rva_; //Function RVA
+	name_view name_; //Function name
+	bool has_name_; //true == function has name
+	uint16_t name_ordinal_; //Function name ordinal
+	bool forward_; //true == function is forwarded
+	name_view forward_name_; //Name of forwarded function
+};
+
 //Class representing export information
 class export_info
 {
@@ -131,15 +179,23 @@ private:
 
 //Exported functions list typedef
 typedef std::vector<exported_function> exported_functions_list;
+//Exported functions list, which names reference image data
+typedef std::vector<exported_function_view> exported_function_view_list;
 
 //Returns array of exported functions
-const exported_functions_list get_exported_functions(const pe_base& pe);
+exported_functions_list get_exported_functions(const pe_base& pe);
 //Returns array of exported functions and information about export
-const exported_functions_list get_exported_functions(const pe_base& pe, export_info& info);
+exported_functions_list get_exported_functions(const pe_base& pe, export_info& info);
+
+//Returns array of exported functions, which names are not copied
+//Names reference image data, they are valid while image exists and its data is not changed
+exported_function_view_list get_exported_function_views(const pe_base& pe);
+//Returns array of exported functions, which names are not copied, and information about export
+exported_function_view_list get_exported_function_views(const pe_base& pe, export_info& info);
 	
 //Helper export functions
 //Returns pair: <ordinal base for supplied functions; maximum ordinal value for supplied functions>
-const std::pair<uint16_t, uint16_t> get_export_ordinal_limits(const exported_functions_list& exports);
+std::pair<uint16_t, uint16_t> get_export_ordinal_limits(const exported_functions_list& exports);
 
 //Checks if exported function name already exists
 bool exported_name_exists(const std::string& function_name, const exported_functions_list& exports);
@@ -147,6 +203,52 @@ bool exported_name_exists(const std::string& function_name, const exported_funct
 //Checks if exported function ordinal already exists
 bool exported_ordinal_exists(uint16_t ordinal, const exported_functions_list& exports);
 
+//Index of exported functions, which is built once and then looked up
+//by name (hash table) and by ordinal (direct table) in constant time
+//Use it instead of exported_name_exists and exported_ordinal_exists for repeated lookups
+class export_index
+{
+public:
+	//Default constructor (empty index)
+	export_index();
+	//Builds index of exports of image (throws an exception if export directory is incorrect)
+	explicit export_index(const pe_base& pe);
+	//Builds index of exported functions list
+	explicit export_index(const exported_functions_list& exports);
+
+	//Returns indexed exported functions
+	const exported_functions_list& get_exported_functions() const;
+
+	//Returns exported function by name or zero, if there is no such function
+	const exported_function* find_by_name(const std::string& name) const;
+	const exported_function* find_by_name(const char* name, std::size_t length) const;
+	//Returns exported function by ordinal or zero, if there is no such function
+	const exported_function* find_by_ordinal(uint16_t ordinal) const;
+
+private:
+	exported_functions_list exports_;
+
+	//Function indexes by (ordinal - ordinal_base_)
+	uint16_t ordinal_base_;
+	std::vector<uint32_t> ordinals_;
+
+	//Open addressing hash table of function indexes by name (size is power of 2)
+	std::vector<uint32_t> names_;
+
+	//Builds index of exports_
+	void build();
+	//Returns hash of name
+	static uint32_t hash_name(const char* name, std::size_t length);
+};
+
+//Finds exported function by name with binary search over export name pointer table, as Windows loader does
+//Export list is not built and names are not copied, name pointer table must be sorted (linkers sort it)
+//Returns false if there is no such exported function, saves its RVA and ordinal otherwise
+//Forwarded functions are found too, their RVAs point to forwarded names
+bool find_exported_function(const pe_base& pe, const std::string& name, uint32_t& rva, uint16_t& ordinal);
+//Returns RVA of function exported by ordinal, or zero if there is no such function
+uint32_t find_exported_function(const pe_base& pe, uint16_t ordinal);
+
 //Export directory rebuilder
 //info - export information
 //exported_functions_list - list of exported functions
@@ -159,5 +261,5 @@ bool exported_ordinal_exists(uint16_t ordinal, const exported_functions_list& ex
 //Returns new export directory information
 //exported_functions_list is copied intentionally to be sorted by ordinal values later
 //Name ordinals in exported function don't matter, they will be recalculated
-const image_directory rebuild_exports(pe_base& pe, const export_info& info, exported_functions_list exports, section& exports_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_exports(pe_base& pe, const export_info& info, exported_functions_list exports, section& exports_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 }
@@ -1,12 +1,314 @@
+#include <deque>
+#include <new>
+#include <stdexcept>
 #include "pe_factory.h"
 #include "pe_properties_generic.h"
+#include "pe_threads.h"
 
 namespace pe_bliss
 {
+pe_scan_callback::~pe_scan_callback()
+{}
+
+//Default implementation rethrows exception, which stops scanning
+void pe_scan_callback::on_error(std::size_t /*index*/, const std::string& /*path*/, const pe_exception& error)
+{
+	throw error;
+}
+
 pe_base pe_factory::create_pe(std::istream& file, bool read_debug_raw_data)
 {
 	return pe_base::get_pe_type(file) == pe_type_32
 		? pe_base(file, pe_properties_32(), read_debug_raw_data)
 		: pe_base(file, pe_properties_64(), read_debug_raw_data);
 }
+
+pe_base pe_factory::create_pe(const data_source_holder& source, bool read_debug_raw_data)
+{
+	return create_pe(source, read_debug_raw_data, true);
+}
+
+pe_base pe_factory::create_pe(const data_source_holder& source, bool read_debug_raw_data, bool read_section_data)
+{
+	if(!source.get())
+		throw pe_exception("No data source", pe_exception::error_reading_file);
+
+	//Determine PE type by headers of source data
+	data_source_streambuf buf(*source.get());
+	std::istream file(&buf);
+	pe_type type = pe_base::get_pe_type(file);
+
+	return type == pe_type_32
+		? pe_base(source, pe_properties_32(), read_debug_raw_data, read_section_data)
+		: pe_base(source, pe_properties_64(), read_debug_raw_data, read_section_data);
+}
+
+pe_base pe_factory::create_pe_mapped(const std::string& file_name, bool read_debug_raw_data)
+{
+	//Holder deletes mapped file if image creation fails
+	//Otherwise file stays mapped while any image section references it
+	data_source_holder source(new mapped_file_source(file_name));
+	return create_pe(source, read_debug_raw_data);
+}
+
+pe_base pe_factory::create_pe_lazy(std::istream& file, bool read_debug_raw_data)
+{
+	//Holder deletes stream source if image creation fails
+	data_source_holder source(new stream_data_source(file));
+	return create_pe(source, read_debug_raw_data);
+}
+
+pe_base pe_factory::create_pe_headers(std::istream& file)
+{
+	//Stream data source caches the beginning of stream,
+	//so type detection and header parsing share one read
+	data_source_holder source(new stream_data_source(file));
+	return create_pe(source, false, false);
+}
+
+//Helper: work queue of scanning thread
+struct scan_queue
+{
+	pe_mutex mutex;
+	std::deque<std::size_t> indexes;
+};
+
+//Helper: state of bulk scanning shared between scanning threads
+struct scan_state
+{
+	//Kind of the first exception, it is rethrown with the same type
+	enum error_kind
+	{
+		error_none,
+		error_pe,
+		error_bad_alloc,
+		error_std,
+		error_unknown
+	};
+
+	scan_state(const std::vector<std::string>& paths, pe_scan_callback& callback, bool read_debug_raw_data)
+		:paths(paths), callback(callback), read_debug_raw_data(read_debug_raw_data), stop(false), error_type(error_none), error(0)
+	{}
+
+	~scan_state()
+	{
+		for(std::vector<scan_queue*>::iterator it = queues.begin(); it != queues.end(); ++it)
+			delete *it;
+
+		delete error;
+	}
+
+	const std::vector<std::string>& paths;
+	pe_scan_callback& callback;
+	bool read_debug_raw_data;
+
+	std::vector<scan_queue*> queues;
+
+	//Stop flag and the first exception
+	pe_mutex error_mutex;
+	bool stop;
+	error_kind error_type;
+	//Saved pe_exception (for error_pe)
+	pe_exception* error;
+	//Message of std::exception (for error_std)
+	std::string error_message;
+
+private:
+	scan_state(const scan_state&);
+	scan_state& operator=(const scan_state&);
+};
+
+//Helper: argument of scanning thread
+struct scan_worker
+{
+	scan_state* state;
+	std::size_t id;
+};
+
+//Helper: takes next file index from own queue or steals it from other queues
+bool scan_next_index(scan_state& state, std::size_t id, std::size_t& index)
+{
+	{
+		scan_queue& own = *state.queues[id];
+		pe_lock lock(own.mutex);
+		if(!own.indexes.empty())
+		{
+			index = own.indexes.front();
+			own.indexes.pop_front();
+			return true;
+		}
+	}
+
+	//Steal from the back of other queues
+	for(std::size_t i = 1; i < state.queues.size(); ++i)
+	{
+		scan_queue& other = *state.queues[(id + i) % state.queues.size()];
+		pe_lock lock(other.mutex);
+		if(!other.indexes.empty())
+		{
+			index = other.indexes.back();
+			other.indexes.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//Helper: saves the first exception and stops scanning
+//Must be called from catch block, current exception is saved
+void scan_stop(scan_state& state)
+{
+	pe_lock lock(state.error_mutex);
+	if(state.stop)
+		return;
+
+	state.stop = true;
+	try
+	{
+		throw;
+	}
+	catch(const pe_exception& e)
+	{
+		state.error_type = scan_state::error_pe;
+		state.error = new pe_exception(e);
+	}
+	catch(const std::bad_alloc&)
+	{
+		state.error_type = scan_state::error_bad_alloc;
+	}
+	catch(const std::exception& e)
+	{
+		state.error_type = scan_state::error_std;
+		state.error_message = e.what();
+	}
+	catch(...)
+	{
+		state.error_type = scan_state::error_unknown;
+	}
+}
+
+//Helper: stops scanning without saving exception
+void scan_cancel(scan_state& state)
+{
+	pe_lock lock(state.error_mutex);
+	state.stop = true;
+}
+
+//Helper: rethrows the first exception of scanning, if any
+void scan_rethrow(const scan_state& state)
+{
+	switch(state.error_type)
+	{
+	case scan_state::error_none:
+		break;
+
+	case scan_state::error_pe:
+		throw *state.error;
+
+	case scan_state::error_bad_alloc:
+		throw std::bad_alloc();
+
+	case scan_state::error_std:
+		throw std::runtime_error(state.error_message);
+
+	default:
+		throw pe_exception("Unknown error while scanning");
+	}
+}
+
+//Helper: scanning thread function
+void scan_thread(void* arg)
+{
+	scan_worker& worker = *static_cast<scan_worker*>(arg);
+	scan_state& state = *worker.state;
+
+	std::size_t index;
+	while(scan_next_index(state, worker.id, index))
+	{
+		{
+			pe_lock lock(state.error_mutex);
+			if(state.stop)
+				return;
+		}
+
+		const std::string& path = state.paths[index];
+
+		try
+		{
+			try
+			{
+				pe_base image(pe_factory::create_pe_mapped(path, state.read_debug_raw_data));
+				state.callback.on_image(index, path, image);
+			}
+			catch(const pe_exception& e)
+			{
+				state.callback.on_error(index, path, e);
+			}
+		}
+		catch(...)
+		{
+			scan_stop(state);
+		}
+	}
+}
+
+void pe_factory::scan(const std::vector<std::string>& paths, pe_scan_callback& callback, unsigned int threads, bool read_debug_raw_data)
+{
+	if(paths.empty())
+		return;
+
+	if(!threads)
+		threads = pe_thread::get_processor_count();
+
+	if(threads > paths.size())
+		threads = static_cast<unsigned int>(paths.size());
+
+	scan_state state(paths, callback, read_debug_raw_data);
+	for(unsigned int i = 0; i != threads; ++i)
+		state.queues.push_back(new scan_queue);
+
+	//Distribute files between queues round-robin
+	for(std::size_t i = 0; i != paths.size(); ++i)
+		state.queues[i % threads]->indexes.push_back(i);
+
+	std::vector<scan_worker> workers(threads);
+	for(unsigned int i = 0; i != threads; ++i)
+	{
+		workers[i].state = &state;
+		workers[i].id = i;
+	}
+
+	//The calling thread is the first worker
+	//Space is reserved, so started thread is always saved to the list
+	std::vector<pe_thread*> started;
+	started.reserve(threads);
+	try
+	{
+		for(unsigned int i = 1; i < threads; ++i)
+			started.push_back(new pe_thread(&scan_thread, &workers[i]));
+	}
+	catch(...)
+	{
+		//Threads which were started are stopped before state is destroyed
+		scan_cancel(state);
+		for(std::vector<pe_thread*>::iterator it = started.begin(); it != started.end(); ++it)
+		{
+			(*it)->join();
+			delete *it;
+		}
+
+		throw;
+	}
+
+	scan_thread(&workers[0]);
+
+	for(std::vector<pe_thread*>::iterator it = started.begin(); it != started.end(); ++it)
+	{
+		(*it)->join();
+		delete *it;
+	}
+
+	scan_rethrow(state);
+}
 }
@@ -1,10 +1,29 @@
 #pragma once
 #include <memory>
 #include <istream>
+#include <string>
+#include <vector>
 #include "pe_base.h"
 
 namespace pe_bliss
 {
+//Receives results of bulk scanning (see pe_factory::scan)
+//Methods are called from scanning threads concurrently, so they must be thread-safe
+class pe_scan_callback
+{
+public:
+	virtual ~pe_scan_callback();
+
+	//Called for each image created from file with index "index" in paths list
+	//Directory getters needed by caller should be called here
+	//pe_exception thrown from here is passed to on_error
+	virtual void on_image(std::size_t index, const std::string& path, pe_base& image) = 0;
+
+	//Called if file with index "index" can't be read or processed
+	//Default implementation rethrows exception, which stops scanning
+	virtual void on_error(std::size_t index, const std::string& path, const pe_exception& error);
+};
+
 class pe_factory
 {
 public:
@@ -12,5 +31,37 @@ public:
 	//If read_bound_import_raw_data, raw bound import data will be read (used to get bound import info)
 	//If read_debug_raw_data, raw debug data will be read (used to get image debug info)
 	static pe_base create_pe(std::istream& file, bool read_debug_raw_data = true);
+
+	//Creates pe_base class instance from PE or PE+ data source
+	//Section data is not copied, sections reference source data directly
+	//Source is referenced by image (and its copies) while any section references it
+	static pe_base create_pe(const data_source_holder& source, bool read_debug_raw_data = true);
+
+	//Creates pe_base class instance from memory-mapped PE or PE+ file
+	//File stays mapped while any image section references its data
+	static pe_base create_pe_mapped(const std::string& file_name, bool read_debug_raw_data = true);
+
+	//Creates pe_base class instance from PE or PE+ istream, but doesn't read section data
+	//Section data is loaded from stream on first access to it
+	//If read_debug_raw_data, section containing debug directory is loaded immediately
+	//Stream must exist while any image section data is not loaded
+	static pe_base create_pe_lazy(std::istream& file, bool read_debug_raw_data = true);
+
+	//Creates pe_base class instance from PE or PE+ istream, reads only DOS header, PE headers and section table
+	//Section data and debug raw data are not read, sections will have no data
+	//Usually headers are read from stream by one small read
+	static pe_base create_pe_headers(std::istream& file);
+
+	//Creates pe_base class instance from PE or PE+ data source
+	//If read_section_data = false, section data is not read, sections will have no data
+	static pe_base create_pe(const data_source_holder& source, bool read_debug_raw_data, bool read_section_data);
+
+	//Creates images from memory-mapped files "paths" on several threads and passes them to "callback"
+	//If threads = 0, number of logical processors is used
+	//Files are distributed between threads, thread with empty queue steals files from queues of other threads
+	//If callback throws an exception, scanning stops and the first exception
+	//is rethrown in the calling thread (pe_exception and std::bad_alloc keep their types,
+	//other std::exception is rethrown as std::runtime_error with the same message)
+	static void scan(const std::vector<std::string>& paths, pe_scan_callback& callback, unsigned int threads = 0, bool read_debug_raw_data = true);
 };
 }
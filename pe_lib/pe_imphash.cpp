@@ -0,0 +1,147 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "pe_imphash.h"
+#include "pe_imports.h"
+#include "pe_ordinal_names.h"
+
+namespace pe_bliss
+{
+//Helper: returns true if lower case of "length" bytes "data" is equal to "str"
+bool imphash_equals_lower(const char* data, std::size_t length, const char* str)
+{
+	std::size_t i = 0;
+	for(; i != length && str[i]; ++i)
+	{
+		if(tolower(static_cast<unsigned char>(data[i])) != str[i])
+			return false;
+	}
+
+	return i == length && !str[i];
+}
+
+//Helper: import visitor, which streams imphash string to MD5
+class imphash_visitor : public import_visitor
+{
+public:
+	explicit imphash_visitor(md5_hash& hash)
+		:hash_(hash), first_(true), library_length_(0), known_extension_(false)
+	{}
+
+	virtual library_action on_library(const import_library_view& library)
+	{
+		const char* name = library.get_name().get_data();
+		library_length_ = library.get_name().get_length();
+
+		//Only the last extension is removed, if it is .dll, .ocx or .sys
+		const char* dot = 0;
+		for(std::size_t i = 0; i != library_length_; ++i)
+		{
+			if(name[i] == '.')
+				dot = name + i;
+		}
+
+		known_extension_ = false;
+		if(dot)
+		{
+			std::size_t extension_length = library_length_ - (dot - name) - 1;
+			if(imphash_equals_lower(dot + 1, extension_length, "dll")
+				|| imphash_equals_lower(dot + 1, extension_length, "ocx")
+				|| imphash_equals_lower(dot + 1, extension_length, "sys"))
+			{
+				library_length_ = dot - name;
+				known_extension_ = true;
+			}
+		}
+
+		return visit_functions;
+	}
+
+	virtual bool on_function(const import_library_view& library, const imported_function_view& func, uint32_t /*thunk_rva*/)
+	{
+		if(!first_)
+			hash_.update(",", 1);
+
+		first_ = false;
+		update_lower(library.get_name().get_data(), library_length_);
+		hash_.update(".", 1);
+
+		if(func.has_name())
+		{
+			update_lower(func.get_name().get_data(), func.get_name().get_length());
+		}
+		else
+		{
+			//Ordinal names database is keyed by full library names, like "ws2_32.dll"
+			const char* name = 0;
+			if(known_extension_ && library_length_ + 4 == library.get_name().get_length()
+				&& imphash_equals_lower(library.get_name().get_data() + library_length_, 4, ".dll"))
+				name = get_ordinal_name(library.get_name().get_data(), library.get_name().get_length(), func.get_ordinal());
+
+			if(name)
+			{
+				update_lower(name, strlen(name));
+			}
+			else
+			{
+				char ordinal[16];
+				int length = sprintf(ordinal, "ord%u", static_cast<unsigned int>(func.get_ordinal()));
+				hash_.update(ordinal, static_cast<std::size_t>(length));
+			}
+		}
+
+		return true;
+	}
+
+private:
+	md5_hash& hash_;
+	bool first_;
+	//Length of library name without extension
+	std::size_t library_length_;
+	bool known_extension_;
+
+	//Adds lower case of data to hash
+	void update_lower(const char* data, std::size_t length)
+	{
+		char buffer[64];
+		while(length)
+		{
+			std::size_t count = length < sizeof(buffer) ? length : sizeof(buffer);
+			for(std::size_t i = 0; i != count; ++i)
+				buffer[i] = static_cast<char>(tolower(static_cast<unsigned char>(data[i])));
+
+			hash_.update(buffer, count);
+			data += count;
+			length -= count;
+		}
+	}
+
+	imphash_visitor(const imphash_visitor&);
+	imphash_visitor& operator=(const imphash_visitor&);
+};
+
+//Writes imphash digest of image to "digest", returns false if image has no imports
+bool get_imphash(const pe_base& pe, uint8_t digest[md5_hash::digest_size])
+{
+	if(!pe.has_imports())
+		return false;
+
+	md5_hash hash;
+	imphash_visitor visitor(hash);
+	enumerate_imports(pe, visitor);
+	hash.finalize(digest);
+	return true;
+}
+
+//Returns import hash (imphash) of image
+std::string get_imphash(const pe_base& pe)
+{
+	if(!pe.has_imports())
+		return std::string();
+
+	md5_hash hash;
+	imphash_visitor visitor(hash);
+	enumerate_imports(pe, visitor);
+	return hash.finalize();
+}
+}
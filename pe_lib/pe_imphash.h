@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include "pe_structures.h"
+#include "pe_base.h"
+#include "pe_md5.h"
+
+namespace pe_bliss
+{
+//Returns import hash (imphash) of image: MD5 of comma-separated "library.function" strings in lower case,
+//library names are taken without .dll, .ocx and .sys extensions,
+//functions imported by ordinal are named by ordinal names database or "ord<ordinal>"
+//The result is compatible with pefile, empty string is returned if image has no imports
+//Names are streamed to MD5 directly from image, no strings are built
+std::string get_imphash(const pe_base& pe);
+//Writes imphash digest of image to "digest", returns false if image has no imports
+bool get_imphash(const pe_base& pe, uint8_t digest[md5_hash::digest_size]);
+}
@@ -0,0 +1,422 @@
+#include <ctype.h>
+#include <stdlib.h>
+#include "pe_import_resolver.h"
+#include "utils.h"
+
+namespace pe_bliss
+{
+//Helper: maximum length of forwarders chain
+const uint32_t max_forwarder_depth = 32;
+//Helper: index of module, which was not found
+const std::size_t no_module = static_cast<std::size_t>(-1);
+
+//Default constructor
+resolved_import::resolved_import()
+	:status_(function_not_found), module_index_(no_module), rva_(0), ordinal_(0), forwarder_count_(0), by_hint_(false)
+{}
+
+//Returns resolution status
+resolved_import::resolve_status resolved_import::get_status() const
+{
+	return status_;
+}
+
+//Returns true if function was resolved
+bool resolved_import::is_resolved() const
+{
+	return status_ == resolved;
+}
+
+//Returns index of module, which exports function (after following forwarders)
+std::size_t resolved_import::get_module_index() const
+{
+	return module_index_;
+}
+
+//Returns RVA of function inside of module
+uint32_t resolved_import::get_rva() const
+{
+	return rva_;
+}
+
+//Returns ordinal of function inside of module
+uint16_t resolved_import::get_ordinal() const
+{
+	return ordinal_;
+}
+
+//Returns number of followed forwarders
+uint32_t resolved_import::get_forwarder_count() const
+{
+	return forwarder_count_;
+}
+
+//Returns true if function was found by hint
+bool resolved_import::is_resolved_by_hint() const
+{
+	return by_hint_;
+}
+
+//Sets resolution status
+void resolved_import::set_status(resolve_status status)
+{
+	status_ = status;
+}
+
+//Sets index of module, which exports function
+void resolved_import::set_module_index(std::size_t index)
+{
+	module_index_ = index;
+}
+
+//Sets RVA and ordinal of function inside of module
+void resolved_import::set_function(uint32_t rva, uint16_t ordinal)
+{
+	rva_ = rva;
+	ordinal_ = ordinal;
+}
+
+//Sets number of followed forwarders
+void resolved_import::set_forwarder_count(uint32_t count)
+{
+	forwarder_count_ = count;
+}
+
+//Sets if function was found by hint
+void resolved_import::set_resolved_by_hint(bool by_hint)
+{
+	by_hint_ = by_hint;
+}
+
+//Module (DLL) information
+struct import_resolver::module_info
+{
+	module_info(const std::string& name, const pe_base& image)
+		:name(name), image(&image), ordinal_base(0)
+	{}
+
+	std::string name;
+	const pe_base* image;
+
+	export_index index;
+	//Export name pointer table and name ordinals table, they are used to check hints
+	std::vector<uint32_t> name_rvas;
+	std::vector<uint16_t> name_ordinals;
+	uint32_t ordinal_base;
+
+	//Prepares export tables of module
+	void prepare(const exported_functions_list& exports, const export_info& info)
+	{
+		index = export_index(exports);
+		ordinal_base = info.get_ordinal_base();
+
+		//Sizes of tables were checked by export directory parser
+		name_rvas.resize(info.get_number_of_names());
+		name_ordinals.resize(info.get_number_of_names());
+		if(!name_rvas.empty())
+		{
+			image->read_data_from_rva(info.get_rva_of_names(), reinterpret_cast<char*>(&name_rvas[0]), static_cast<uint32_t>(name_rvas.size() * sizeof(uint32_t)), true);
+			image->read_data_from_rva(info.get_rva_of_name_ordinals(), reinterpret_cast<char*>(&name_ordinals[0]), static_cast<uint32_t>(name_ordinals.size() * sizeof(uint16_t)), true);
+		}
+	}
+};
+
+//Helper: converts module name to lower case and appends ".dll" to names without extension
+std::string normalize_module_name(const std::string& name)
+{
+	std::string ret(name);
+	for(std::string::iterator it = ret.begin(); it != ret.end(); ++it)
+		*it = static_cast<char>(tolower(static_cast<unsigned char>(*it)));
+
+	if(ret.find('.') == std::string::npos)
+		ret += ".dll";
+
+	return ret;
+}
+
+//Helper: import visitor, which resolves imported functions
+class resolving_visitor : public import_visitor
+{
+public:
+	resolving_visitor(import_resolver& resolver, resolved_imports_list& results)
+		:resolver_(resolver), results_(results), module_index_(no_module)
+	{}
+
+	virtual library_action on_library(const import_library_view& library)
+	{
+		if(!resolver_.find_module(library.get_name().to_string(), module_index_))
+			module_index_ = no_module;
+
+		return visit_functions;
+	}
+
+	virtual bool on_function(const import_library_view& /*library*/, const imported_function_view& func, uint32_t /*thunk_rva*/)
+	{
+		if(module_index_ == no_module)
+		{
+			resolved_import result;
+			result.set_status(resolved_import::module_not_found);
+			results_.push_back(result);
+		}
+		else if(func.has_name())
+		{
+			results_.push_back(resolver_.resolve_function(module_index_, func.get_name().get_data(), func.get_name().get_length(), true, func.get_hint(), 0, 0));
+		}
+		else
+		{
+			results_.push_back(resolver_.resolve_function(module_index_, 0, 0, false, 0, func.get_ordinal(), 0));
+		}
+
+		return true;
+	}
+
+private:
+	import_resolver& resolver_;
+	resolved_imports_list& results_;
+	std::size_t module_index_;
+
+	resolving_visitor(const resolving_visitor&);
+	resolving_visitor& operator=(const resolving_visitor&);
+};
+
+//Default constructor
+import_resolver::import_resolver()
+	:depth_cutoffs_(0)
+{}
+
+//Destructor
+import_resolver::~import_resolver()
+{
+	for(std::vector<module_info*>::iterator it = modules_.begin(); it != modules_.end(); ++it)
+		delete *it;
+}
+
+//Adds module with name "name"
+std::size_t import_resolver::add_module(const std::string& name, const pe_base& image)
+{
+	export_info info;
+	exported_functions_list exports;
+	if(image.has_exports())
+		exports = get_exported_functions(image, info);
+
+	return add_module(name, image, exports, info);
+}
+
+//Adds module, name is taken from export directory of image
+std::size_t import_resolver::add_module(const pe_base& image)
+{
+	export_info info;
+	exported_functions_list exports(get_exported_functions(image, info));
+	return add_module(info.get_name(), image, exports, info);
+}
+
+//Adds module with parsed export directory
+std::size_t import_resolver::add_module(const std::string& name, const pe_base& image, const exported_functions_list& exports, const export_info& info)
+{
+	//Export tables are prepared before resolver is changed
+	module_info prepared(normalize_module_name(name), image);
+	prepared.prepare(exports, info);
+
+	//Cached forwarders can reference replaced or missing module
+	forwarders_.clear();
+
+	std::map<std::string, std::size_t>::const_iterator it = module_indexes_.find(prepared.name);
+	if(it != module_indexes_.end())
+	{
+		*modules_[(*it).second] = prepared;
+		return (*it).second;
+	}
+
+	module_info* module = new module_info(prepared);
+	try
+	{
+		modules_.push_back(module);
+		module_indexes_[prepared.name] = modules_.size() - 1;
+	}
+	catch(...)
+	{
+		if(!modules_.empty() && modules_.back() == module)
+			modules_.pop_back();
+
+		delete module;
+		throw;
+	}
+
+	return modules_.size() - 1;
+}
+
+//Returns number of added modules
+std::size_t import_resolver::get_module_count() const
+{
+	return modules_.size();
+}
+
+//Returns name of module (in lower case)
+const std::string& import_resolver::get_module_name(std::size_t index) const
+{
+	return modules_.at(index)->name;
+}
+
+//Returns image of module
+const pe_base& import_resolver::get_module_image(std::size_t index) const
+{
+	return *modules_.at(index)->image;
+}
+
+//Returns true and index of module, if module with name "name" was added
+bool import_resolver::find_module(const std::string& name, std::size_t& index) const
+{
+	std::map<std::string, std::size_t>::const_iterator it = module_indexes_.find(normalize_module_name(name));
+	if(it == module_indexes_.end())
+		return false;
+
+	index = (*it).second;
+	return true;
+}
+
+//Resolves all imported functions of image
+resolved_imports_list import_resolver::resolve(const pe_base& image)
+{
+	resolved_imports_list ret;
+	resolving_visitor visitor(*this, ret);
+	enumerate_imports(image, visitor);
+	return ret;
+}
+
+//Resolves function "func" imported from library "library_name"
+resolved_import import_resolver::resolve(const std::string& library_name, const imported_function& func)
+{
+	std::size_t index;
+	if(!find_module(library_name, index))
+	{
+		resolved_import ret;
+		ret.set_status(resolved_import::module_not_found);
+		return ret;
+	}
+
+	return func.has_name()
+		? resolve_function(index, func.get_name().c_str(), func.get_name().length(), true, func.get_hint(), 0, 0)
+		: resolve_function(index, 0, 0, false, 0, func.get_ordinal(), 0);
+}
+
+//Removes cached results of forwarders resolution
+void import_resolver::clear_cache()
+{
+	forwarders_.clear();
+}
+
+//Resolves function of module by name (checks hint first, if check_hint is true) or by ordinal (if name is zero)
+resolved_import import_resolver::resolve_function(std::size_t module_index, const char* name, std::size_t length, bool check_hint, uint16_t hint, uint16_t ordinal, uint32_t depth)
+{
+	resolved_import ret;
+	ret.set_module_index(module_index);
+
+	const module_info& module = *modules_.at(module_index);
+
+	const exported_function* func = 0;
+	if(name)
+	{
+		//Hint is index of name in export name pointer table
+		if(check_hint && hint < module.name_rvas.size())
+		{
+			try
+			{
+				name_view hint_name;
+				if(module.image->read_string_from_rva(module.name_rvas[hint], hint_name, true)
+					&& hint_name == name_view(name, static_cast<uint32_t>(length)))
+				{
+					func = module.index.find_by_ordinal(static_cast<uint16_t>(module.name_ordinals[hint] + module.ordinal_base));
+					ret.set_resolved_by_hint(func != 0);
+				}
+			}
+			catch(const pe_exception&)
+			{
+				//Incorrect name pointer, search function by name
+			}
+		}
+
+		if(!func)
+			func = module.index.find_by_name(name, length);
+	}
+	else
+	{
+		func = module.index.find_by_ordinal(ordinal);
+	}
+
+	if(!func)
+	{
+		ret.set_status(resolved_import::function_not_found);
+		return ret;
+	}
+
+	if(func->is_forwarded())
+	{
+		resolved_import forwarded(resolve_forwarder(func->get_forwarded_name(), depth + 1));
+		forwarded.set_resolved_by_hint(ret.is_resolved_by_hint());
+		return forwarded;
+	}
+
+	ret.set_status(resolved_import::resolved);
+	ret.set_function(func->get_rva(), func->get_ordinal());
+	return ret;
+}
+
+//Resolves forwarder "forwarded_name"
+resolved_import import_resolver::resolve_forwarder(const std::string& forwarded_name, uint32_t depth)
+{
+	resolved_import ret;
+	ret.set_status(resolved_import::forwarder_loop);
+	if(depth > max_forwarder_depth)
+	{
+		++depth_cutoffs_;
+		return ret;
+	}
+
+	//Forwarded name looks like "MODULE.Function" or "MODULE.#ordinal"
+	std::string::size_type dot = forwarded_name.rfind('.');
+	if(dot == std::string::npos || dot == 0 || dot + 1 == forwarded_name.length())
+	{
+		ret.set_status(resolved_import::function_not_found);
+		return ret;
+	}
+
+	std::string module_name(normalize_module_name(forwarded_name.substr(0, dot)));
+	std::string function_name(forwarded_name.substr(dot + 1));
+	std::string key(module_name + "." + function_name);
+
+	std::map<std::string, resolved_import>::const_iterator cached = forwarders_.find(key);
+	if(cached != forwarders_.end())
+		return (*cached).second; //Forwarder, which is being resolved, is cached as loop
+
+	forwarders_[key] = ret;
+	uint32_t depth_cutoffs = depth_cutoffs_;
+
+	std::map<std::string, std::size_t>::const_iterator module = module_indexes_.find(module_name);
+	if(module == module_indexes_.end())
+	{
+		ret.set_status(resolved_import::module_not_found);
+	}
+	else if(function_name[0] == '#')
+	{
+		unsigned long ordinal = strtoul(function_name.c_str() + 1, 0, 10);
+		if(ordinal > pe_utils::max_word)
+			ret.set_status(resolved_import::function_not_found);
+		else
+			ret = resolve_function((*module).second, 0, 0, false, 0, static_cast<uint16_t>(ordinal), depth);
+	}
+	else
+	{
+		ret = resolve_function((*module).second, function_name.c_str(), function_name.length(), false, 0, 0, depth);
+	}
+
+	ret.set_forwarder_count(ret.get_forwarder_count() + 1);
+
+	//Result of too long chain depends on depth, from which forwarder was reached, so it is not cached
+	if(depth_cutoffs == depth_cutoffs_)
+		forwarders_[key] = ret;
+	else
+		forwarders_.erase(key);
+
+	return ret;
+}
+}
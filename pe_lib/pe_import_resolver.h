@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include "pe_structures.h"
+#include "pe_base.h"
+#include "pe_exports.h"
+#include "pe_imports.h"
+
+namespace pe_bliss
+{
+//Class representing result of imported function resolution
+class resolved_import
+{
+public:
+	//Resolution status
+	enum resolve_status
+	{
+		resolved, //function was found (forwarders are followed)
+		module_not_found, //module, which exports function, was not added to resolver
+		function_not_found, //module does not export function
+		forwarder_loop //forwarders form a loop or their chain is too long
+	};
+
+public:
+	//Default constructor
+	resolved_import();
+
+	//Returns resolution status
+	resolve_status get_status() const;
+	//Returns true if function was resolved
+	bool is_resolved() const;
+
+	//Returns index of module, which exports function (after following forwarders)
+	//Returns -1 if module was not found
+	std::size_t get_module_index() const;
+	//Returns RVA of function inside of module
+	uint32_t get_rva() const;
+	//Returns ordinal of function inside of module
+	uint16_t get_ordinal() const;
+	//Returns number of followed forwarders
+	uint32_t get_forwarder_count() const;
+	//Returns true if function was found by hint
+	bool is_resolved_by_hint() const;
+
+public: //Setters, they are used by resolver
+	//Sets resolution status
+	void set_status(resolve_status status);
+	//Sets index of module, which exports function
+	void set_module_index(std::size_t index);
+	//Sets RVA and ordinal of function inside of module
+	void set_function(uint32_t rva, uint16_t ordinal);
+	//Sets number of followed forwarders
+	void set_forwarder_count(uint32_t count);
+	//Sets if function was found by hint
+	void set_resolved_by_hint(bool by_hint);
+
+private:
+	resolve_status status_;
+	std::size_t module_index_;
+	uint32_t rva_;
+	uint16_t ordinal_;
+	uint32_t forwarder_count_;
+	bool by_hint_;
+};
+
+//Results of imports resolution in import directory order
+//(functions of the first imported library, then functions of the second one, and so on)
+typedef std::vector<resolved_import> resolved_imports_list;
+
+//Binds imported functions to exports of modules (DLLs) like Windows loader does:
+//function, which is imported by name, is checked against export name pointer table entry,
+//which index is hint, then it is searched by name; forwarders are followed
+//Results of forwarders resolution are cached
+//Images of modules are not copied, they must exist while resolver is used
+//Module names are case-insensitive, ".dll" is appended to names without extension
+//Resolver is not thread-safe
+class import_resolver
+{
+public:
+	//Default constructor
+	import_resolver();
+	//Destructor
+	~import_resolver();
+
+	//Adds module with name "name" (throws an exception if export directory of image is incorrect, resolver is not changed then)
+	//If module with this name was added, its image is replaced
+	//Returns index of module
+	std::size_t add_module(const std::string& name, const pe_base& image);
+	//Adds module, name is taken from export directory of image
+	std::size_t add_module(const pe_base& image);
+
+	//Returns number of added modules
+	std::size_t get_module_count() const;
+	//Returns name of module (in lower case)
+	const std::string& get_module_name(std::size_t index) const;
+	//Returns image of module
+	const pe_base& get_module_image(std::size_t index) const;
+	//Returns true and index of module, if module with name "name" was added
+	bool find_module(const std::string& name, std::size_t& index) const;
+
+	//Resolves all imported functions of image
+	resolved_imports_list resolve(const pe_base& image);
+	//Resolves function "func" imported from library "library_name"
+	resolved_import resolve(const std::string& library_name, const imported_function& func);
+
+	//Removes cached results of forwarders resolution
+	void clear_cache();
+
+private:
+	struct module_info;
+
+	//Import visitor, which resolves imported functions
+	friend class resolving_visitor;
+
+	std::vector<module_info*> modules_;
+	std::map<std::string, std::size_t> module_indexes_;
+	//Cached results of forwarders resolution, keys are "module.function" or "module.#ordinal"
+	std::map<std::string, resolved_import> forwarders_;
+	//Number of forwarders chains, which were cut because of their length
+	uint32_t depth_cutoffs_;
+
+	//Adds module with parsed export directory
+	std::size_t add_module(const std::string& name, const pe_base& image, const exported_functions_list& exports, const export_info& info);
+
+	//Resolves function of module by name (checks hint first, if check_hint is true) or by ordinal (if name is zero)
+	resolved_import resolve_function(std::size_t module_index, const char* name, std::size_t length, bool check_hint, uint16_t hint, uint16_t ordinal, uint32_t depth);
+	//Resolves forwarder "forwarded_name"
+	resolved_import resolve_forwarder(const std::string& forwarded_name, uint32_t depth);
+
+	import_resolver(const import_resolver&);
+	import_resolver& operator=(const import_resolver&);
+};
+}
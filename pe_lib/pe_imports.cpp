@@ -254,29 +254,469 @@ void import_library::clear_imports()
 	imports_.clear();
 }
 
-const imported_functions_list get_imported_functions(const pe_base& pe)
+//Default constructor
+imported_function_view::imported_function_view()
+	:hint_(0), ordinal_(0), iat_va_(0)
+{}
+
+//Returns true if imported function has name (and hint)
+bool imported_function_view::has_name() const
+{
+	return !name_.empty();
+}
+
+//Returns name of function
+const name_view& imported_function_view::get_name() const
+{
+	return name_;
+}
+
+//Returns hint
+uint16_t imported_function_view::get_hint() const
+{
+	return hint_;
+}
+
+//Returns ordinal of function
+uint16_t imported_function_view::get_ordinal() const
+{
+	return ordinal_;
+}
+
+//Returns IAT entry VA (usable if image has both IAT and original IAT and is bound)
+uint64_t imported_function_view::get_iat_va() const
+{
+	return iat_va_;
+}
+
+//Returns imported function, which owns copy of name
+imported_function imported_function_view::to_imported_function() const
+{
+	imported_function func;
+	func.set_name(name_.to_string());
+	func.set_hint(hint_);
+	func.set_ordinal(ordinal_);
+	func.set_iat_va(iat_va_);
+	return func;
+}
+
+//Sets name of function
+void imported_function_view::set_name(const name_view& name)
+{
+	name_ = name;
+}
+
+//Sets hint
+void imported_function_view::set_hint(uint16_t hint)
+{
+	hint_ = hint;
+}
+
+//Sets ordinal
+void imported_function_view::set_ordinal(uint16_t ordinal)
+{
+	ordinal_ = ordinal;
+}
+
+//Sets IAT entry VA (usable if image has both IAT and original IAT and is bound)
+void imported_function_view::set_iat_va(uint64_t va)
+{
+	iat_va_ = va;
+}
+
+//Default constructor
+import_library_view::import_library_view()
+	:rva_to_iat_(0), rva_to_original_iat_(0), timestamp_(0)
+{}
+
+//Returns name of library
+const name_view& import_library_view::get_name() const
+{
+	return name_;
+}
+
+//Returns RVA to Import Address Table (IAT)
+uint32_t import_library_view::get_rva_to_iat() const
+{
+	return rva_to_iat_;
+}
+
+//Returns RVA to Original Import Address Table (Original IAT)
+uint32_t import_library_view::get_rva_to_original_iat() const
+{
+	return rva_to_original_iat_;
+}
+
+//Returns timestamp
+uint32_t import_library_view::get_timestamp() const
+{
+	return timestamp_;
+}
+
+//Returns imported functions list
+const import_library_view::imported_list& import_library_view::get_imported_functions() const
+{
+	return imports_;
+}
+
+//Returns imported library, which owns copies of names
+import_library import_library_view::to_import_library() const
+{
+	import_library lib;
+	lib.set_name(name_.to_string());
+	lib.set_rva_to_iat(rva_to_iat_);
+	lib.set_rva_to_original_iat(rva_to_original_iat_);
+	lib.set_timestamp(timestamp_);
+
+	for(imported_list::const_iterator it = imports_.begin(); it != imports_.end(); ++it)
+		lib.add_import((*it).to_imported_function());
+
+	return lib;
+}
+
+//Sets name of library
+void import_library_view::set_name(const name_view& name)
+{
+	name_ = name;
+}
+
+//Sets RVA to Import Address Table (IAT)
+void import_library_view::set_rva_to_iat(uint32_t rva_to_iat)
+{
+	rva_to_iat_ = rva_to_iat;
+}
+
+//Sets RVA to Original Import Address Table (Original IAT)
+void import_library_view::set_rva_to_original_iat(uint32_t rva_to_original_iat)
+{
+	rva_to_original_iat_ = rva_to_original_iat;
+}
+
+//Sets timestamp
+void import_library_view::set_timestamp(uint32_t timestamp)
+{
+	timestamp_ = timestamp;
+}
+
+//Adds imported function
+void import_library_view::add_import(const imported_function_view& func)
+{
+	imports_.push_back(func);
+}
+
+import_visitor::~import_visitor()
+{}
+
+//Default constructor
+flat_import_table::flat_import_table()
+	:string_pool_(1, '\0')
+{}
+
+//Returns number of imported libraries
+std::size_t flat_import_table::get_library_count() const
+{
+	return library_names_.size();
+}
+
+//Returns number of imported functions of all libraries
+std::size_t flat_import_table::get_function_count() const
+{
+	return function_libraries_.size();
+}
+
+//Returns name of library with index "index"
+const char* flat_import_table::get_library_name(std::size_t index) const
+{
+	return string_pool_.c_str() + library_names_.at(index);
+}
+
+//Returns RVA to Import Address Table (IAT) of library
+uint32_t flat_import_table::get_library_rva_to_iat(std::size_t index) const
+{
+	return rvas_to_iat_.at(index);
+}
+
+//Returns RVA to Original Import Address Table (Original IAT) of library
+uint32_t flat_import_table::get_library_rva_to_original_iat(std::size_t index) const
+{
+	return rvas_to_original_iat_.at(index);
+}
+
+//Returns timestamp of library
+uint32_t flat_import_table::get_library_timestamp(std::size_t index) const
+{
+	return timestamps_.at(index);
+}
+
+//Returns index of the first function of library
+uint32_t flat_import_table::get_library_first_function(std::size_t index) const
+{
+	return first_functions_.at(index);
+}
+
+//Returns number of functions of library
+uint32_t flat_import_table::get_library_function_count(std::size_t index) const
+{
+	uint32_t end = index + 1 < first_functions_.size()
+		? first_functions_[index + 1]
+		: static_cast<uint32_t>(function_libraries_.size());
+
+	return end - first_functions_.at(index);
+}
+
+//Returns index of library of function with index "index"
+uint32_t flat_import_table::get_function_library(std::size_t index) const
+{
+	return function_libraries_.at(index);
+}
+
+//Returns true if function has name (and hint)
+bool flat_import_table::has_name(std::size_t index) const
+{
+	return string_pool_[function_names_.at(index)] != '\0';
+}
+
+//Returns name of function (empty string for functions imported by ordinal)
+const char* flat_import_table::get_function_name(std::size_t index) const
+{
+	return string_pool_.c_str() + function_names_.at(index);
+}
+
+//Returns hint of function
+uint16_t flat_import_table::get_hint(std::size_t index) const
+{
+	return hints_.at(index);
+}
+
+//Returns ordinal of function
+uint16_t flat_import_table::get_ordinal(std::size_t index) const
+{
+	return ordinals_.at(index);
+}
+
+//Returns RVA of IAT entry (thunk) of function
+uint32_t flat_import_table::get_thunk_rva(std::size_t index) const
+{
+	return thunk_rvas_.at(index);
+}
+
+//Returns IAT entry VA (usable if image has both IAT and original IAT and is bound)
+uint64_t flat_import_table::get_iat_va(std::size_t index) const
+{
+	return iat_vas_.at(index);
+}
+
+//Returns offsets of library names inside of string pool
+const std::vector<uint32_t>& flat_import_table::get_library_name_offsets() const
+{
+	return library_names_;
+}
+
+//Returns library indexes of functions
+const std::vector<uint32_t>& flat_import_table::get_function_libraries() const
+{
+	return function_libraries_;
+}
+
+//Returns offsets of function names inside of string pool
+const std::vector<uint32_t>& flat_import_table::get_function_name_offsets() const
+{
+	return function_names_;
+}
+
+//Returns hints of functions
+const std::vector<uint16_t>& flat_import_table::get_hints() const
+{
+	return hints_;
+}
+
+//Returns ordinals of functions
+const std::vector<uint16_t>& flat_import_table::get_ordinals() const
+{
+	return ordinals_;
+}
+
+//Returns RVAs of IAT entries (thunks) of functions
+const std::vector<uint32_t>& flat_import_table::get_thunk_rvas() const
+{
+	return thunk_rvas_;
+}
+
+//Returns IAT entry VAs of functions
+const std::vector<uint64_t>& flat_import_table::get_iat_vas() const
+{
+	return iat_vas_;
+}
+
+//Returns string pool, which contains null-terminated names
+const std::string& flat_import_table::get_string_pool() const
+{
+	return string_pool_;
+}
+
+//Searches for function with name "name" starting from function with index "from"
+bool flat_import_table::find_function(const char* name, std::size_t& index, std::size_t from) const
+{
+	//Functions imported by ordinal reference empty string, it is never equal to name
+	if(!*name)
+		return false;
+
+	const char* pool = string_pool_.c_str();
+	for(std::size_t i = from; i < function_names_.size(); ++i)
+	{
+		const char* func_name = pool + function_names_[i];
+		if(*func_name == *name && !strcmp(func_name, name))
+		{
+			index = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//Searches for function with name "name" starting from function with index "from"
+bool flat_import_table::find_function(const std::string& name, std::size_t& index, std::size_t from) const
+{
+	return find_function(name.c_str(), index, from);
+}
+
+//Returns imported functions list with related libraries info
+imported_functions_list flat_import_table::to_imported_functions_list() const
+{
+	imported_functions_list ret;
+	ret.reserve(get_library_count());
+
+	for(std::size_t i = 0; i != get_library_count(); ++i)
+	{
+		import_library lib;
+		lib.set_name(get_library_name(i));
+		lib.set_rva_to_iat(rvas_to_iat_[i]);
+		lib.set_rva_to_original_iat(rvas_to_original_iat_[i]);
+		lib.set_timestamp(timestamps_[i]);
+
+		uint32_t first = first_functions_[i];
+		uint32_t count = get_library_function_count(i);
+		for(uint32_t j = first; j != first + count; ++j)
+		{
+			imported_function func;
+			func.set_name(get_function_name(j));
+			func.set_hint(hints_[j]);
+			func.set_ordinal(ordinals_[j]);
+			func.set_iat_va(iat_vas_[j]);
+			lib.add_import(func);
+		}
+
+		ret.push_back(lib);
+	}
+
+	return ret;
+}
+
+//Removes all libraries and functions
+void flat_import_table::clear()
+{
+	library_names_.clear();
+	rvas_to_iat_.clear();
+	rvas_to_original_iat_.clear();
+	timestamps_.clear();
+	first_functions_.clear();
+
+	function_libraries_.clear();
+	function_names_.clear();
+	hints_.clear();
+	ordinals_.clear();
+	thunk_rvas_.clear();
+	iat_vas_.clear();
+
+	string_pool_.assign(1, '\0');
+}
+
+//Adds library
+void flat_import_table::add_library(const name_view& name, uint32_t rva_to_iat, uint32_t rva_to_original_iat, uint32_t timestamp)
+{
+	library_names_.push_back(add_name(name));
+	rvas_to_iat_.push_back(rva_to_iat);
+	rvas_to_original_iat_.push_back(rva_to_original_iat);
+	timestamps_.push_back(timestamp);
+	first_functions_.push_back(static_cast<uint32_t>(function_libraries_.size()));
+}
+
+//Adds function to the last added library
+void flat_import_table::add_function(const imported_function_view& func, uint32_t thunk_rva)
+{
+	if(library_names_.empty())
+		throw pe_exception("No imported library to add function to", pe_exception::incorrect_import_directory);
+
+	function_libraries_.push_back(static_cast<uint32_t>(library_names_.size() - 1));
+	function_names_.push_back(func.has_name() ? add_name(func.get_name()) : 0);
+	hints_.push_back(func.get_hint());
+	ordinals_.push_back(func.get_ordinal());
+	thunk_rvas_.push_back(thunk_rva);
+	iat_vas_.push_back(func.get_iat_va());
+}
+
+//Adds name to string pool and returns its offset
+uint32_t flat_import_table::add_name(const name_view& name)
+{
+	if(name.empty())
+		return 0;
+
+	if(string_pool_.size() >= static_cast<uint32_t>(-1) - name.get_length())
+		throw pe_exception("Too many imported names", pe_exception::incorrect_import_directory);
+
+	uint32_t offset = static_cast<uint32_t>(string_pool_.size());
+	string_pool_.append(name.get_data(), name.get_length());
+	string_pool_.push_back('\0');
+	return offset;
+}
+
+imported_functions_list get_imported_functions(const pe_base& pe)
 {
 	return (pe.get_pe_type() == pe_type_32 ?
 		get_imported_functions_base<pe_types_class_32>(pe)
 		: get_imported_functions_base<pe_types_class_64>(pe));
 }
 
-const image_directory rebuild_imports(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings)
+void get_imported_functions(const pe_base& pe, flat_import_table& table)
+{
+	if(pe.get_pe_type() == pe_type_32)
+		get_imported_functions_base<pe_types_class_32>(pe, table);
+	else
+		get_imported_functions_base<pe_types_class_64>(pe, table);
+}
+
+void enumerate_imports(const pe_base& pe, import_visitor& visitor)
+{
+	if(pe.get_pe_type() == pe_type_32)
+		enumerate_imports_base<pe_types_class_32>(pe, visitor);
+	else
+		enumerate_imports_base<pe_types_class_64>(pe, visitor);
+}
+
+imported_functions_view_list get_imported_function_views(const pe_base& pe)
+{
+	return (pe.get_pe_type() == pe_type_32 ?
+		get_imported_function_views_base<pe_types_class_32>(pe)
+		: get_imported_function_views_base<pe_types_class_64>(pe));
+}
+
+image_directory rebuild_imports(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings)
 {
 	return (pe.get_pe_type() == pe_type_32 ?
 		rebuild_imports_base<pe_types_class_32>(pe, imports, import_section, import_settings)
 		: rebuild_imports_base<pe_types_class_64>(pe, imports, import_section, import_settings));
 }
 
-//Returns imported functions list with related libraries info
-template<typename PEClassType>
-const imported_functions_list get_imported_functions_base(const pe_base& pe)
+//Helper: walks import directory and passes libraries and functions to sink
+//Sink must have the same functions as import_visitor has (they may be not virtual)
+//Names reference image data, nothing is allocated while walking
+template<typename PEClassType, typename Sink>
+void walk_imports(const pe_base& pe, Sink& sink)
 {
-	imported_functions_list ret;
-
-	//If image has no imports, return empty array
+	//If image has no imports, there is nothing to walk
 	if(!pe.has_imports())
-		return ret;
+		return;
 
 	unsigned long current_descriptor_pos = pe.get_directory_rva(image_directory_entry_import);
 	//Get first IMAGE_IMPORT_DESCRIPTOR
@@ -287,29 +727,28 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe)
 	//inside of loop if we go outsize of section
 	while(import_descriptor.Name)
 	{
-		//Get imported library information
-		import_library lib;
-
 		unsigned long max_name_length;
 		//Get byte count that we have for library name
 		if((max_name_length = pe.section_data_length_from_rva(import_descriptor.Name, import_descriptor.Name, section_data_virtual, true)) < 2)
 			throw pe_exception("Incorrect import directory", pe_exception::incorrect_import_directory);
 
-		//Get DLL name pointer
-		const char* dll_name = pe.section_data_from_rva(import_descriptor.Name, section_data_virtual, true);
-
-		//Check for null-termination
-		if(!pe_utils::is_null_terminated(dll_name, max_name_length))
+		//Get DLL name and check for null-termination
+		name_view dll_name;
+		if(!pe.read_string_from_rva(import_descriptor.Name, dll_name, true))
 			throw pe_exception("Incorrect import directory", pe_exception::incorrect_import_directory);
 
-		//Set library name
+		//Imported library information
+		import_library_view lib;
 		lib.set_name(dll_name);
-		//Set library timestamp
 		lib.set_timestamp(import_descriptor.TimeDateStamp);
-		//Set library RVA to IAT and original IAT
 		lib.set_rva_to_iat(import_descriptor.FirstThunk);
 		lib.set_rva_to_original_iat(import_descriptor.OriginalFirstThunk);
 
+		//Pass library information to sink
+		import_visitor::library_action action = sink.on_library(lib);
+		if(action == import_visitor::stop_enumeration)
+			return;
+
 		//Get RVA to IAT (it must be filled by loader when loading PE)
 		uint32_t current_thunk_rva = import_descriptor.FirstThunk;
 		typename PEClassType::BaseSize import_address_table = pe.section_data_from_rva<typename PEClassType::BaseSize>(current_thunk_rva, section_data_virtual, true);
@@ -325,12 +764,15 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe)
 			current_original_thunk_rva = current_thunk_rva;
 
 		//List all imported functions for current DLL
-		if(import_lookup_table != 0 && import_address_table != 0)
+		if(action == import_visitor::visit_functions && import_lookup_table != 0 && import_address_table != 0)
 		{
 			while(true)
 			{
 				//Imported function description
-				imported_function func;
+				imported_function_view func;
+
+				//IAT entry (thunk) of function
+				uint32_t thunk_rva = current_thunk_rva;
 
 				//Get VA from IAT
 				typename PEClassType::BaseSize address = pe.section_data_from_rva<typename PEClassType::BaseSize>(current_thunk_rva, section_data_virtual, true);
@@ -364,11 +806,9 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe)
 					if((max_name_length = pe.section_data_length_from_rva(static_cast<uint32_t>(lookup + sizeof(uint16_t)), static_cast<uint32_t>(lookup + sizeof(uint16_t)), section_data_virtual, true)) < 2)
 						throw pe_exception("Incorrect import directory", pe_exception::incorrect_import_directory);
 
-					//Get imported function name
-					const char* func_name = pe.section_data_from_rva(static_cast<uint32_t>(lookup + sizeof(uint16_t)), section_data_virtual, true);
-
-					//Check for null-termination
-					if(!pe_utils::is_null_terminated(func_name, max_name_length))
+					//Get imported function name and check for null-termination
+					name_view func_name;
+					if(!pe.read_string_from_rva(static_cast<uint32_t>(lookup + sizeof(uint16_t)), func_name, true))
 						throw pe_exception("Incorrect import directory", pe_exception::incorrect_import_directory);
 
 					//HINT in import table is ORDINAL in export table
@@ -379,8 +819,9 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe)
 					func.set_hint(hint);
 				}
 
-				//Add function to list
-				lib.add_import(func);
+				//Pass function to sink
+				if(!sink.on_function(lib, func, thunk_rva))
+					return;
 			}
 		}
 
@@ -391,15 +832,125 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe)
 		//Go to next library
 		current_descriptor_pos += sizeof(image_import_descriptor);
 		import_descriptor = pe.section_data_from_rva<image_import_descriptor>(current_descriptor_pos, section_data_virtual, true);
+	}
+}
 
-		//Save import information
-		ret.push_back(lib);
+
+//Helper: import walker sink, which collects library views
+struct import_view_collector
+{
+	explicit import_view_collector(imported_functions_view_list& libraries)
+		:libraries(libraries)
+	{}
+
+	import_visitor::library_action on_library(const import_library_view& library)
+	{
+		libraries.push_back(library);
+		return import_visitor::visit_functions;
+	}
+
+	bool on_function(const import_library_view& /*library*/, const imported_function_view& func, uint32_t /*thunk_rva*/)
+	{
+		libraries.back().add_import(func);
+		return true;
+	}
+
+	imported_functions_view_list& libraries;
+
+private:
+	import_view_collector& operator=(const import_view_collector&);
+};
+
+//Helper: import walker sink, which fills imported functions list (names are copied)
+struct import_list_collector
+{
+	explicit import_list_collector(imported_functions_list& libraries)
+		:libraries(libraries)
+	{}
+
+	import_visitor::library_action on_library(const import_library_view& library)
+	{
+		libraries.push_back(import_library());
+		import_library& lib = libraries.back();
+		lib.set_name(library.get_name().to_string());
+		lib.set_rva_to_iat(library.get_rva_to_iat());
+		lib.set_rva_to_original_iat(library.get_rva_to_original_iat());
+		lib.set_timestamp(library.get_timestamp());
+		return import_visitor::visit_functions;
+	}
+
+	bool on_function(const import_library_view& /*library*/, const imported_function_view& func, uint32_t /*thunk_rva*/)
+	{
+		libraries.back().add_import(func.to_imported_function());
+		return true;
+	}
+
+	imported_functions_list& libraries;
+
+private:
+	import_list_collector& operator=(const import_list_collector&);
+};
+
+//Helper: import walker sink, which fills flat import table
+struct import_table_collector
+{
+	explicit import_table_collector(flat_import_table& table)
+		:table(table)
+	{}
+
+	import_visitor::library_action on_library(const import_library_view& library)
+	{
+		table.add_library(library.get_name(), library.get_rva_to_iat(), library.get_rva_to_original_iat(), library.get_timestamp());
+		return import_visitor::visit_functions;
+	}
+
+	bool on_function(const import_library_view& /*library*/, const imported_function_view& func, uint32_t thunk_rva)
+	{
+		table.add_function(func, thunk_rva);
+		return true;
 	}
 
-	//Return resulting list
+	flat_import_table& table;
+
+private:
+	import_table_collector& operator=(const import_table_collector&);
+};
+
+//Returns imported functions list with related libraries info
+template<typename PEClassType>
+imported_functions_list get_imported_functions_base(const pe_base& pe)
+{
+	imported_functions_list ret;
+	import_list_collector collector(ret);
+	walk_imports<PEClassType>(pe, collector);
 	return ret;
 }
 
+//Fills flat import table with imported functions and related libraries info
+template<typename PEClassType>
+void get_imported_functions_base(const pe_base& pe, flat_import_table& table)
+{
+	table.clear();
+	import_table_collector collector(table);
+	walk_imports<PEClassType>(pe, collector);
+}
+
+//Passes imported libraries and functions to visitor, stops when visitor requests it
+template<typename PEClassType>
+void enumerate_imports_base(const pe_base& pe, import_visitor& visitor)
+{
+	walk_imports<PEClassType>(pe, visitor);
+}
+
+//Returns imported functions list with related libraries info, which names are not copied
+template<typename PEClassType>
+imported_functions_view_list get_imported_function_views_base(const pe_base& pe)
+{
+	imported_functions_view_list ret;
+	import_view_collector collector(ret);
+	walk_imports<PEClassType>(pe, collector);
+	return ret;
+}
 
 //Simple import directory rebuilder
 //You can get all image imports with get_imported_functions() function
@@ -410,7 +961,7 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe)
 //rewriting of some used memory (or other IAT/orig.IAT fields) by system loader
 //The safest way is just adding import libraries with functions to the end of imported_functions_list array
 template<typename PEClassType>
-const image_directory rebuild_imports_base(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings)
+image_directory rebuild_imports_base(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings)
 {
 	//Check that import_section is attached to this PE image
 	if(!pe.section_attached(import_section))
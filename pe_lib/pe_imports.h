@@ -92,6 +92,95 @@ private:
 	imported_list imports_;
 };
 
+//Class representing imported function, which name references image data (it is not copied)
+//Name is valid while image exists and its data is not changed
+class imported_function_view
+{
+public:
+	//Default constructor
+	imported_function_view();
+
+	//Returns true if imported function has name (and hint)
+	bool has_name() const;
+	//Returns name of function
+	const name_view& get_name() const;
+	//Returns hint
+	uint16_t get_hint() const;
+	//Returns ordinal of function
+	uint16_t get_ordinal() const;
+
+	//Returns IAT entry VA (usable if image has both IAT and original IAT and is bound)
+	uint64_t get_iat_va() const;
+
+	//Returns imported function, which owns copy of name
+	imported_function to_imported_function() const;
+
+public: //Setters, they are used by import parser
+	//Sets name of function
+	void set_name(const name_view& name);
+	//Sets hint
+	void set_hint(uint16_t hint);
+	//Sets ordinal
+	void set_ordinal(uint16_t ordinal);
+
+	//Sets IAT entry VA (usable if image has both IAT and original IAT and is bound)
+	void set_iat_va(uint64_t rva);
+
+private:
+	name_view name_; //Function name
+	uint16_t hint_; //Hint
+	uint16_t ordinal_; //Ordinal
+	uint64_t iat_va_;
+};
+
+//Class representing imported library information, which names reference image data (they are not copied)
+//Names are valid while image exists and its data is not changed
+class import_library_view
+{
+public:
+	typedef std::vector<imported_function_view> imported_list;
+
+public:
+	//Default constructor
+	import_library_view();
+
+	//Returns name of library
+	const name_view& get_name() const;
+	//Returns RVA to Import Address Table (IAT)
+	uint32_t get_rva_to_iat() const;
+	//Returns RVA to Original Import Address Table (Original IAT)
+	uint32_t get_rva_to_original_iat() const;
+	//Returns timestamp
+	uint32_t get_timestamp() const;
+
+	//Returns imported functions list
+	const imported_list& get_imported_functions() const;
+
+	//Returns imported library, which owns copies of names
+	import_library to_import_library() const;
+
+public: //Setters, they are used by import parser
+	//Sets name of library
+	void set_name(const name_view& name);
+	//Sets RVA to Import Address Table (IAT)
+	void set_rva_to_iat(uint32_t rva_to_iat);
+	//Sets RVA to Original Import Address Table (Original IAT)
+	void set_rva_to_original_iat(uint32_t rva_to_original_iat);
+	//Sets timestamp
+	void set_timestamp(uint32_t timestamp);
+
+	//Adds imported function
+	void add_import(const imported_function_view& func);
+
+private:
+	name_view name_; //Library name
+	uint32_t rva_to_iat_; //RVA to IAT
+	uint32_t rva_to_original_iat_; //RVA to original IAT
+	uint32_t timestamp_; //DLL TimeStamp
+
+	imported_list imports_;
+};
+
 //Simple import directory rebuilder
 //Class representing import rebuilder advanced settings
 class import_rebuilder_settings
@@ -164,13 +253,166 @@ private:
 };
 
 typedef std::vector<import_library> imported_functions_list;
+//Imported libraries list, which names reference image data
+typedef std::vector<import_library_view> imported_functions_view_list;
+
+//Import directory visitor
+//Libraries and functions are passed to visitor in import directory order,
+//their names reference image data, so enumeration allocates nothing
+class import_visitor
+{
+public:
+	//Actions, which visitor returns for imported library
+	enum library_action
+	{
+		visit_functions, //enumerate functions of library
+		skip_functions, //go to the next library
+		stop_enumeration //stop enumeration
+	};
+
+public:
+	virtual ~import_visitor();
+
+	//Called for each imported library before its functions
+	//Imported functions list of library is empty
+	virtual library_action on_library(const import_library_view& library) = 0;
+	//Called for each imported function of library, "thunk_rva" is RVA of its IAT entry
+	//Returns false to stop enumeration
+	virtual bool on_function(const import_library_view& library, const imported_function_view& func, uint32_t thunk_rva) = 0;
+};
+
+//Compact import table representation (structure of arrays)
+//Every property of libraries and functions is kept in its own contiguous array,
+//all names are kept in one string pool and are referenced by offsets
+//Functions of each library are stored one after another in import directory order
+//The string pool starts with empty string, functions imported by ordinal reference it
+class flat_import_table
+{
+public:
+	//Default constructor
+	flat_import_table();
+
+	//Returns number of imported libraries
+	std::size_t get_library_count() const;
+	//Returns number of imported functions of all libraries
+	std::size_t get_function_count() const;
+
+public: //Library properties
+	//Returns name of library with index "index"
+	const char* get_library_name(std::size_t index) const;
+	//Returns RVA to Import Address Table (IAT) of library
+	uint32_t get_library_rva_to_iat(std::size_t index) const;
+	//Returns RVA to Original Import Address Table (Original IAT) of library
+	uint32_t get_library_rva_to_original_iat(std::size_t index) const;
+	//Returns timestamp of library
+	uint32_t get_library_timestamp(std::size_t index) const;
+	//Returns index of the first function of library
+	uint32_t get_library_first_function(std::size_t index) const;
+	//Returns number of functions of library
+	uint32_t get_library_function_count(std::size_t index) const;
+
+public: //Function properties
+	//Returns index of library of function with index "index"
+	uint32_t get_function_library(std::size_t index) const;
+	//Returns true if function has name (and hint)
+	bool has_name(std::size_t index) const;
+	//Returns name of function (empty string for functions imported by ordinal)
+	const char* get_function_name(std::size_t index) const;
+	//Returns hint of function
+	uint16_t get_hint(std::size_t index) const;
+	//Returns ordinal of function
+	uint16_t get_ordinal(std::size_t index) const;
+	//Returns RVA of IAT entry (thunk) of function
+	uint32_t get_thunk_rva(std::size_t index) const;
+	//Returns IAT entry VA (usable if image has both IAT and original IAT and is bound)
+	uint64_t get_iat_va(std::size_t index) const;
+
+public: //Contiguous arrays
+	//Returns offsets of library names inside of string pool
+	const std::vector<uint32_t>& get_library_name_offsets() const;
+	//Returns library indexes of functions
+	const std::vector<uint32_t>& get_function_libraries() const;
+	//Returns offsets of function names inside of string pool
+	const std::vector<uint32_t>& get_function_name_offsets() const;
+	//Returns hints of functions
+	const std::vector<uint16_t>& get_hints() const;
+	//Returns ordinals of functions
+	const std::vector<uint16_t>& get_ordinals() const;
+	//Returns RVAs of IAT entries (thunks) of functions
+	const std::vector<uint32_t>& get_thunk_rvas() const;
+	//Returns IAT entry VAs of functions
+	const std::vector<uint64_t>& get_iat_vas() const;
+	//Returns string pool, which contains null-terminated names
+	const std::string& get_string_pool() const;
+
+public: //Searching
+	//Searches for function with name "name" starting from function with index "from"
+	//Returns true and saves index of found function to "index", if function was found
+	bool find_function(const char* name, std::size_t& index, std::size_t from = 0) const;
+	bool find_function(const std::string& name, std::size_t& index, std::size_t from = 0) const;
+
+	//Returns imported functions list with related libraries info
+	imported_functions_list to_imported_functions_list() const;
+
+public: //Setters, they are used by import parser
+	//Removes all libraries and functions
+	void clear();
+	//Adds library
+	void add_library(const name_view& name, uint32_t rva_to_iat, uint32_t rva_to_original_iat, uint32_t timestamp);
+	//Adds function to the last added library
+	void add_function(const imported_function_view& func, uint32_t thunk_rva);
+
+private:
+	//Library properties
+	std::vector<uint32_t> library_names_;
+	std::vector<uint32_t> rvas_to_iat_;
+	std::vector<uint32_t> rvas_to_original_iat_;
+	std::vector<uint32_t> timestamps_;
+	std::vector<uint32_t> first_functions_;
+
+	//Function properties
+	std::vector<uint32_t> function_libraries_;
+	std::vector<uint32_t> function_names_;
+	std::vector<uint16_t> hints_;
+	std::vector<uint16_t> ordinals_;
+	std::vector<uint32_t> thunk_rvas_;
+	std::vector<uint64_t> iat_vas_;
+
+	//Names
+	std::string string_pool_;
+
+	//Adds name to string pool and returns its offset
+	uint32_t add_name(const name_view& name);
+};
+
 
 
 //Returns imported functions list with related libraries info
-const imported_functions_list get_imported_functions(const pe_base& pe);
+imported_functions_list get_imported_functions(const pe_base& pe);
+
+template<typename PEClassType>
+imported_functions_list get_imported_functions_base(const pe_base& pe);
+
+//Fills flat import table with imported functions and related libraries info
+//Previous contents of table are removed
+void get_imported_functions(const pe_base& pe, flat_import_table& table);
+
+template<typename PEClassType>
+void get_imported_functions_base(const pe_base& pe, flat_import_table& table);
+
+//Passes imported libraries and functions to visitor, stops when visitor requests it
+//Nothing is allocated while enumerating
+void enumerate_imports(const pe_base& pe, import_visitor& visitor);
+
+template<typename PEClassType>
+void enumerate_imports_base(const pe_base& pe, import_visitor& visitor);
+
+//Returns imported functions list with related libraries info, which names are not copied
+//Names reference image data, they are valid while image exists and its data is not changed
+imported_functions_view_list get_imported_function_views(const pe_base& pe);
 
 template<typename PEClassType>
-const imported_functions_list get_imported_functions_base(const pe_base& pe);
+imported_functions_view_list get_imported_function_views_base(const pe_base& pe);
 
 
 //You can get all image imports with get_imported_functions() function
@@ -180,8 +422,8 @@ const imported_functions_list get_imported_functions_base(const pe_base& pe);
 //Don't add new imported functions to existing imported library entries, because this can cause
 //rewriting of some used memory (or other IAT/orig.IAT fields) by system loader
 //The safest way is just adding import libraries with functions to the end of imported_functions_list array
-const image_directory rebuild_imports(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings = import_rebuilder_settings());
+image_directory rebuild_imports(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings = import_rebuilder_settings());
 
 template<typename PEClassType>
-const image_directory rebuild_imports_base(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings = import_rebuilder_settings());
+image_directory rebuild_imports_base(pe_base& pe, const imported_functions_list& imports, section& import_section, const import_rebuilder_settings& import_settings = import_rebuilder_settings());
 }
@@ -146,18 +146,18 @@ private:
 
 //Returns image config info
 //If image does not have config info, throws an exception
-const image_config_info get_image_config(const pe_base& pe);
+image_config_info get_image_config(const pe_base& pe);
 
 template<typename PEClassType>
-const image_config_info get_image_config_base(const pe_base& pe);
+image_config_info get_image_config_base(const pe_base& pe);
 
 
 //Image config directory rebuilder
 //auto_strip_last_section - if true and TLS are placed in the last section, it will be automatically stripped
 //If write_se_handlers = true, SE Handlers list will be written just after image config directory structure
 //If write_lock_prefixes = true, Lock Prefixes address list will be written just after image config directory structure
-const image_directory rebuild_image_config(pe_base& pe, const image_config_info& info, section& image_config_section, uint32_t offset_from_section_start = 0, bool write_se_handlers = true, bool write_lock_prefixes = true, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_image_config(pe_base& pe, const image_config_info& info, section& image_config_section, uint32_t offset_from_section_start = 0, bool write_se_handlers = true, bool write_lock_prefixes = true, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 
 template<typename PEClassType>
-const image_directory rebuild_image_config_base(pe_base& pe, const image_config_info& info, section& image_config_section, uint32_t offset_from_section_start = 0, bool write_se_handlers = true, bool write_lock_prefixes = true, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_image_config_base(pe_base& pe, const image_config_info& info, section& image_config_section, uint32_t offset_from_section_start = 0, bool write_se_handlers = true, bool write_lock_prefixes = true, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 }
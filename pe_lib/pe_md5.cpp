@@ -0,0 +1,160 @@
+#include <string.h>
+#include "pe_md5.h"
+
+namespace pe_bliss
+{
+//Helper: MD5 per-round shift amounts
+const uint32_t md5_shifts[64] =
+{
+	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+//Helper: MD5 constants (integer parts of sines)
+const uint32_t md5_constants[64] =
+{
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+//Default constructor
+md5_hash::md5_hash()
+{
+	reset();
+}
+
+//Starts new hash
+void md5_hash::reset()
+{
+	state_[0] = 0x67452301;
+	state_[1] = 0xefcdab89;
+	state_[2] = 0x98badcfe;
+	state_[3] = 0x10325476;
+	length_ = 0;
+}
+
+//Processes 64-byte block
+void md5_hash::transform(const uint8_t* block)
+{
+	//Block is little-endian
+	uint32_t words[16];
+	for(uint32_t i = 0; i != 16; ++i)
+	{
+		words[i] = static_cast<uint32_t>(block[i * 4])
+			| (static_cast<uint32_t>(block[i * 4 + 1]) << 8)
+			| (static_cast<uint32_t>(block[i * 4 + 2]) << 16)
+			| (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+	}
+
+	uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+	for(uint32_t i = 0; i != 64; ++i)
+	{
+		uint32_t f, g;
+		if(i < 16)
+		{
+			f = (b & c) | (~b & d);
+			g = i;
+		}
+		else if(i < 32)
+		{
+			f = (d & b) | (~d & c);
+			g = (5 * i + 1) % 16;
+		}
+		else if(i < 48)
+		{
+			f = b ^ c ^ d;
+			g = (3 * i + 5) % 16;
+		}
+		else
+		{
+			f = c ^ (b | ~d);
+			g = (7 * i) % 16;
+		}
+
+		uint32_t temp = d;
+		d = c;
+		c = b;
+		uint32_t sum = a + f + md5_constants[i] + words[g];
+		b += (sum << md5_shifts[i]) | (sum >> (32 - md5_shifts[i]));
+		a = temp;
+	}
+
+	state_[0] += a;
+	state_[1] += b;
+	state_[2] += c;
+	state_[3] += d;
+}
+
+//Adds "length" bytes of data to hash
+void md5_hash::update(const char* data, std::size_t length)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+	std::size_t used = static_cast<std::size_t>(length_ % 64);
+	length_ += length;
+
+	//Fill buffered block first
+	if(used)
+	{
+		std::size_t count = 64 - used < length ? 64 - used : length;
+		memcpy(buffer_ + used, bytes, count);
+		bytes += count;
+		length -= count;
+		used += count;
+		if(used != 64)
+			return;
+
+		transform(buffer_);
+	}
+
+	//Process whole blocks without copying
+	for(; length >= 64; bytes += 64, length -= 64)
+		transform(bytes);
+
+	if(length)
+		memcpy(buffer_, bytes, length);
+}
+
+//Finishes hashing and writes digest to "digest"
+void md5_hash::finalize(uint8_t digest[digest_size])
+{
+	uint64_t bit_length = length_ * 8;
+
+	//Padding: 0x80 byte, zeroes up to 56 bytes of block, then length in bits
+	static const char padding[64] = {static_cast<char>(0x80)};
+	std::size_t used = static_cast<std::size_t>(length_ % 64);
+	update(padding, used < 56 ? 56 - used : 120 - used);
+
+	char length_bytes[8];
+	for(uint32_t i = 0; i != 8; ++i)
+		length_bytes[i] = static_cast<char>(bit_length >> (i * 8));
+	update(length_bytes, sizeof(length_bytes));
+
+	for(uint32_t i = 0; i != 16; ++i)
+		digest[i] = static_cast<uint8_t>(state_[i / 4] >> ((i % 4) * 8));
+}
+
+//Finishes hashing and returns digest as lower case hex string
+std::string md5_hash::finalize()
+{
+	uint8_t digest[digest_size];
+	finalize(digest);
+
+	static const char hex[] = "0123456789abcdef";
+	std::string ret(digest_size * 2, '0');
+	for(uint32_t i = 0; i != digest_size; ++i)
+	{
+		ret[i * 2] = hex[digest[i] >> 4];
+		ret[i * 2 + 1] = hex[digest[i] & 0xF];
+	}
+
+	return ret;
+}
+}
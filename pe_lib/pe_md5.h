@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include "pe_structures.h"
+
+namespace pe_bliss
+{
+//MD5 hash, data can be added by parts
+class md5_hash
+{
+public:
+	//Size of digest in bytes
+	enum { digest_size = 16 };
+
+public:
+	//Default constructor
+	md5_hash();
+
+	//Adds "length" bytes of data to hash
+	void update(const char* data, std::size_t length);
+	//Finishes hashing and writes digest to "digest"
+	//Hash can't be updated after this, until reset() is called
+	void finalize(uint8_t digest[digest_size]);
+	//Finishes hashing and returns digest as lower case hex string
+	std::string finalize();
+	//Starts new hash
+	void reset();
+
+private:
+	uint32_t state_[4];
+	uint64_t length_;
+	uint8_t buffer_[64];
+
+	//Processes 64-byte block
+	void transform(const uint8_t* block);
+};
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include "pe_structures.h"
+#include "pe_imports.h"
+
+namespace pe_bliss
+{
+//Database of names of functions, which are exported by ordinal from well-known system libraries
+//(ws2_32.dll, wsock32.dll, oleaut32.dll)
+//Names are kept in compiled-in perfect hash tables, lookups don't allocate memory
+
+//Returns name of function exported by ordinal "ordinal" from library "library_name"
+//or zero, if library or ordinal is unknown
+//Library name is case-insensitive, ".dll" extension may be omitted
+const char* get_ordinal_name(const char* library_name, std::size_t length, uint16_t ordinal);
+const char* get_ordinal_name(const std::string& library_name, uint16_t ordinal);
+
+//Sets names of functions, which are imported by ordinal from well-known libraries
+//Returns number of functions, which got names
+//Ordinals of functions are kept, but if imports are rebuilt, such functions will be imported by name
+std::size_t set_ordinal_names(imported_functions_list& imports);
+}
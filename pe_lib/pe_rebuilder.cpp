@@ -143,7 +143,7 @@ void rebuild_pe(pe_base& pe, std::ostream& out, bool strip_dos_header, bool chan
 		if(it == sections.end() - 1) //If last section encountered
 		{
 			image_section_header header((*it).get_raw_header());
-			header.SizeOfRawData = static_cast<uint32_t>((*it).get_raw_data().length()); //Set non-aligned actual data length for it
+			header.SizeOfRawData = (*it).get_raw_data_length(); //Set non-aligned actual data length for it
 			out.write(reinterpret_cast<const char*>(&header), sizeof(image_section_header));
 		}
 		else
@@ -171,7 +171,7 @@ void rebuild_pe(pe_base& pe, std::ostream& out, bool strip_dos_header, bool chan
 			out.put(0);
 
 		//Write raw section data
-		out.write(s.get_raw_data().data(), s.get_raw_data().length());
+		out.write(s.get_raw_data_ptr(), s.get_raw_data_length());
 	}
 }
 }
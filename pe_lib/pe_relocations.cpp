@@ -101,7 +101,7 @@ relocation_table::relocation_list& relocation_table::get_relocations()
 
 //Get relocation list of pe file, supports one-word sized relocations only
 //If list_absolute_entries = true, IMAGE_REL_BASED_ABSOLUTE will be listed
-const relocation_table_list get_relocations(const pe_base& pe, bool list_absolute_entries)
+relocation_table_list get_relocations(const pe_base& pe, bool list_absolute_entries)
 {
 	relocation_table_list ret;
 
@@ -165,7 +165,7 @@ const relocation_table_list get_relocations(const pe_base& pe, bool list_absolut
 //auto_strip_last_section - if true and relocations are placed in the last section, it will be automatically stripped
 //offset_from_section_start - offset from the beginning of reloc_section, where relocations data will be situated
 //If save_to_pe_header is true, PE header will be modified automatically
-const image_directory rebuild_relocations(pe_base& pe, const relocation_table_list& relocs, section& reloc_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
+image_directory rebuild_relocations(pe_base& pe, const relocation_table_list& relocs, section& reloc_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
 {
 	//Check that reloc_section is attached to this PE image
 	if(!pe.section_attached(reloc_section))
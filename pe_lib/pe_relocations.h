@@ -79,7 +79,7 @@ typedef std::vector<relocation_table> relocation_table_list;
 
 //Get relocation list of pe file, supports one-word sized relocations only
 //If list_absolute_entries = true, IMAGE_REL_BASED_ABSOLUTE will be listed
-const relocation_table_list get_relocations(const pe_base& pe, bool list_absolute_entries = false);
+relocation_table_list get_relocations(const pe_base& pe, bool list_absolute_entries = false);
 
 //Simple relocations rebuilder
 //To keep PE file working, don't remove any of existing relocations in
@@ -87,7 +87,7 @@ const relocation_table_list get_relocations(const pe_base& pe, bool list_absolut
 //auto_strip_last_section - if true and relocations are placed in the last section, it will be automatically stripped
 //offset_from_section_start - offset from the beginning of reloc_section, where relocations data will be situated
 //If save_to_pe_header is true, PE header will be modified automatically
-const image_directory rebuild_relocations(pe_base& pe, const relocation_table_list& relocs, section& reloc_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_relocations(pe_base& pe, const relocation_table_list& relocs, section& reloc_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 
 //Recalculates image base with the help of relocation tables
 //Recalculates VAs of DWORDS/QWORDS in image according to relocations
@@ -27,12 +27,11 @@ resource_directory& pe_resource_manager::get_root_directory()
 bool pe_resource_manager::remove_resource_type(resource_type type)
 {
 	//Search for resource type
-	resource_directory::entry_list& entries = root_dir_edit_.get_entry_list();
-	resource_directory::entry_list::iterator it = std::find_if(entries.begin(), entries.end(), resource_directory::id_entry_finder(type));
-	if(it != entries.end())
+	std::size_t index;
+	if(root_dir_edit_.find_entry(resource_directory::entry_finder(type), index))
 	{
 		//Remove it, if found
-		entries.erase(it);
+		root_dir_edit_.remove_entry(index);
 		return true;
 	}
 
@@ -42,12 +41,11 @@ bool pe_resource_manager::remove_resource_type(resource_type type)
 bool pe_resource_manager::remove_resource(const std::wstring& root_name)
 {
 	//Search for resource type
-	resource_directory::entry_list& entries = root_dir_edit_.get_entry_list();
-	resource_directory::entry_list::iterator it = std::find_if(entries.begin(), entries.end(), resource_directory::name_entry_finder(root_name));
-	if(it != entries.end())
+	std::size_t index;
+	if(root_dir_edit_.find_entry(resource_directory::entry_finder(root_name), index))
 	{
 		//Remove it, if found
-		entries.erase(it);
+		root_dir_edit_.remove_entry(index);
 		return true;
 	}
 
@@ -58,19 +56,18 @@ bool pe_resource_manager::remove_resource(const std::wstring& root_name)
 bool pe_resource_manager::remove_resource(const resource_directory::entry_finder& root_finder, const resource_directory::entry_finder& finder)
 {
 	//Search for resource type
-	resource_directory::entry_list& entries_type = root_dir_edit_.get_entry_list();
-	resource_directory::entry_list::iterator it_type = std::find_if(entries_type.begin(), entries_type.end(), root_finder);
-	if(it_type != entries_type.end())
+	std::size_t index_type;
+	if(root_dir_edit_.find_entry(root_finder, index_type))
 	{
 		//Search for resource name/ID with "finder"
-		resource_directory::entry_list& entries_name = (*it_type).get_resource_directory().get_entry_list();
-		resource_directory::entry_list::iterator it_name = std::find_if(entries_name.begin(), entries_name.end(), finder);
-		if(it_name != entries_name.end())
+		resource_directory& dir_name = root_dir_edit_.get_entry(index_type).get_resource_directory();
+		std::size_t index_name;
+		if(dir_name.find_entry(finder, index_name))
 		{
 			//Erase resource, if found
-			entries_name.erase(it_name);
-			if(entries_name.empty())
-				entries_type.erase(it_type);
+			dir_name.remove_entry(index_name);
+			if(is_empty(dir_name))
+				root_dir_edit_.remove_entry(index_type);
 
 			return true;
 		}
@@ -109,27 +106,26 @@ bool pe_resource_manager::remove_resource(const std::wstring& root_name, uint32_
 bool pe_resource_manager::remove_resource(const resource_directory::entry_finder& root_finder, const resource_directory::entry_finder& finder, uint32_t language)
 {
 	//Search for resource type
-	resource_directory::entry_list& entries_type = root_dir_edit_.get_entry_list();
-	resource_directory::entry_list::iterator it_type = std::find_if(entries_type.begin(), entries_type.end(), root_finder);
-	if(it_type != entries_type.end())
+	std::size_t index_type;
+	if(root_dir_edit_.find_entry(root_finder, index_type))
 	{
 		//Search for resource name/ID with "finder"
-		resource_directory::entry_list& entries_name = (*it_type).get_resource_directory().get_entry_list();
-		resource_directory::entry_list::iterator it_name = std::find_if(entries_name.begin(), entries_name.end(), finder);
-		if(it_name != entries_name.end())
+		resource_directory& dir_name = root_dir_edit_.get_entry(index_type).get_resource_directory();
+		std::size_t index_name;
+		if(dir_name.find_entry(finder, index_name))
 		{
 			//Search for resource language
-			resource_directory::entry_list& entries_lang = (*it_name).get_resource_directory().get_entry_list();
-			resource_directory::entry_list::iterator it_lang = std::find_if(entries_lang.begin(), entries_lang.end(), resource_directory::id_entry_finder(language));
-			if(it_lang != entries_lang.end())
+			resource_directory& dir_lang = dir_name.get_entry(index_name).get_resource_directory();
+			std::size_t index_lang;
+			if(dir_lang.find_entry(resource_directory::entry_finder(language), index_lang))
 			{
 				//Erase resource, if found
-				entries_lang.erase(it_lang);
-				if(entries_lang.empty())
+				dir_lang.remove_entry(index_lang);
+				if(is_empty(dir_lang))
 				{
-					entries_name.erase(it_name);
-					if(entries_name.empty())
-						entries_type.erase(it_type);
+					dir_name.remove_entry(index_name);
+					if(is_empty(dir_name))
+						root_dir_edit_.remove_entry(index_type);
 				}
 
 				return true;
@@ -188,43 +184,59 @@ void pe_resource_manager::add_resource(const std::string& data, const std::wstri
 void pe_resource_manager::add_resource(const std::string& data, resource_directory_entry& new_root_entry, const resource_directory::entry_finder& root_finder, resource_directory_entry& new_entry, const resource_directory::entry_finder& finder, uint32_t language, uint32_t codepage, uint32_t timestamp)
 {
 	//Search for resource type
-	resource_directory::entry_list* entries = &root_dir_edit_.get_entry_list();
-	resource_directory::entry_list::iterator it = std::find_if(entries->begin(), entries->end(), root_finder);
-	if(it == entries->end())
+	resource_directory* dir = &root_dir_edit_;
+	std::size_t index;
+	if(!dir->find_entry(root_finder, index))
 	{
 		//Add resource type directory, if it was not found
-		resource_directory dir;
-		dir.set_timestamp(timestamp);
-		new_root_entry.add_resource_directory(dir);
-		entries->push_back(new_root_entry);
-		it = entries->end() - 1;
+		resource_directory new_dir;
+		new_dir.set_timestamp(timestamp);
+		new_root_entry.add_resource_directory(new_dir);
+		dir->add_resource_directory_entry(new_root_entry);
+		index = get_entry_count(*dir) - 1;
 	}
 
 	//Search for resource name/ID directory with "finder"
-	entries = &(*it).get_resource_directory().get_entry_list();
-	it = std::find_if(entries->begin(), entries->end(), finder);
-	if(it == entries->end())
+	dir = &dir->get_entry(index).get_resource_directory();
+	if(!dir->find_entry(finder, index))
 	{
 		//Add resource name/ID directory, if it was not found
-		resource_directory dir;
-		dir.set_timestamp(timestamp);
-		new_entry.add_resource_directory(dir);
-		entries->push_back(new_entry);
-		it = entries->end() - 1;
+		resource_directory new_dir;
+		new_dir.set_timestamp(timestamp);
+		new_entry.add_resource_directory(new_dir);
+		dir->add_resource_directory_entry(new_entry);
+		index = get_entry_count(*dir) - 1;
 	}
 
 	//Search for data resource entry by language
-	entries = &(*it).get_resource_directory().get_entry_list();
-	it = std::find_if(entries->begin(), entries->end(), resource_directory::id_entry_finder(language));
-	if(it != entries->end())
-		entries->erase(it); //Erase it, if found
-
-	//Add new data entry
-	resource_directory_entry new_dir_data_entry;
+	dir = &dir->get_entry(index).get_resource_directory();
 	resource_data_entry data_dir(data, codepage);
-	new_dir_data_entry.add_data_entry(data_dir);
-	new_dir_data_entry.set_id(language);
-	entries->push_back(new_dir_data_entry);
+	if(dir->find_entry(resource_directory::entry_finder(language), index))
+	{
+		//Replace data, if found
+		dir->get_entry(index).add_data_entry(data_dir);
+	}
+	else
+	{
+		//Add new data entry
+		resource_directory_entry new_dir_data_entry;
+		new_dir_data_entry.add_data_entry(data_dir);
+		new_dir_data_entry.set_id(language);
+		dir->add_resource_directory_entry(new_dir_data_entry);
+	}
+}
+
+//Helper: returns number of entries of directory
+//Entry list is taken by const reference, so entry index of directory is kept
+std::size_t pe_resource_manager::get_entry_count(const resource_directory& dir)
+{
+	return dir.get_entry_list().size();
+}
+
+//Helper: returns true if directory has no entries
+bool pe_resource_manager::is_empty(const resource_directory& dir)
+{
+	return dir.get_entry_list().empty();
 }
 
 //Adds resource. If resource already exists, replaces it
@@ -23,6 +23,9 @@ public:
 	resource_directory& get_root_directory();
 
 public: //Resource editing
+	//Directories are searched by entry index (see resource_directory::find_entry),
+	//which is kept up to date across edits, so adding N resources takes O(N log N)
+	//Entries are added to the end of directories, rebuild_resources sorts them
 	//Removes all resources of given type or root name
 	//If there's more than one directory entry of a given type, only the
 	//first one will be deleted (that's an unusual situation)
@@ -88,5 +91,10 @@ private:
 
 	//Helper to remove resource
 	bool remove_resource(const resource_directory::entry_finder& root_finder, const resource_directory::entry_finder& finder, uint32_t language);
+
+	//Helper: returns number of entries of directory
+	static std::size_t get_entry_count(const resource_directory& dir);
+	//Helper: returns true if directory has no entries
+	static bool is_empty(const resource_directory& dir);
 };
 }
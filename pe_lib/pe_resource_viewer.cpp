@@ -29,7 +29,7 @@ bool pe_resource_viewer::has_id::operator()(const resource_directory_entry& entr
 }
 
 //Lists resource types existing in PE file (non-named only)
-const pe_resource_viewer::resource_type_list pe_resource_viewer::list_resource_types() const
+pe_resource_viewer::resource_type_list pe_resource_viewer::list_resource_types() const
 {
 	resource_type_list ret;
 
@@ -60,7 +60,7 @@ bool pe_resource_viewer::resource_exists(const std::wstring& root_name) const
 }
 
 //Helper function to get name list from entry list
-const pe_resource_viewer::resource_name_list pe_resource_viewer::get_name_list(const resource_directory::entry_list& entries)
+pe_resource_viewer::resource_name_list pe_resource_viewer::get_name_list(const resource_directory::entry_list& entries)
 {
 	resource_name_list ret;
 
@@ -75,7 +75,7 @@ const pe_resource_viewer::resource_name_list pe_resource_viewer::get_name_list(c
 }
 
 //Helper function to get ID list from entry list
-const pe_resource_viewer::resource_id_list pe_resource_viewer::get_id_list(const resource_directory::entry_list& entries)
+pe_resource_viewer::resource_id_list pe_resource_viewer::get_id_list(const resource_directory::entry_list& entries)
 {
 	resource_id_list ret;
 
@@ -90,25 +90,25 @@ const pe_resource_viewer::resource_id_list pe_resource_viewer::get_id_list(const
 }
 
 //Lists resource names existing in PE file by resource type
-const pe_resource_viewer::resource_name_list pe_resource_viewer::list_resource_names(resource_type type) const
+pe_resource_viewer::resource_name_list pe_resource_viewer::list_resource_names(resource_type type) const
 {
 	return get_name_list(root_dir_.entry_by_id(type).get_resource_directory().get_entry_list());
 }
 
 //Lists resource names existing in PE file by resource name
-const pe_resource_viewer::resource_name_list pe_resource_viewer::list_resource_names(const std::wstring& root_name) const
+pe_resource_viewer::resource_name_list pe_resource_viewer::list_resource_names(const std::wstring& root_name) const
 {
 	return get_name_list(root_dir_.entry_by_name(root_name).get_resource_directory().get_entry_list());
 }
 
 //Lists resource IDs existing in PE file by resource type
-const pe_resource_viewer::resource_id_list pe_resource_viewer::list_resource_ids(resource_type type) const
+pe_resource_viewer::resource_id_list pe_resource_viewer::list_resource_ids(resource_type type) const
 {
 	return get_id_list(root_dir_.entry_by_id(type).get_resource_directory().get_entry_list());
 }
 
 //Lists resource IDs existing in PE file by resource name
-const pe_resource_viewer::resource_id_list pe_resource_viewer::list_resource_ids(const std::wstring& root_name) const
+pe_resource_viewer::resource_id_list pe_resource_viewer::list_resource_ids(const std::wstring& root_name) const
 {
 	return get_id_list(root_dir_.entry_by_name(root_name).get_resource_directory().get_entry_list());
 }
@@ -192,7 +192,7 @@ unsigned long pe_resource_viewer::get_language_count(const std::wstring& root_na
 }
 
 //Lists resource languages by resource type and name
-const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(resource_type type, const std::wstring& name) const
+pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(resource_type type, const std::wstring& name) const
 {
 	const resource_directory::entry_list& entries =
 		root_dir_ //Type directory
@@ -206,7 +206,7 @@ const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resour
 }
 
 //Lists resource languages by resource names
-const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(const std::wstring& root_name, const std::wstring& name) const
+pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(const std::wstring& root_name, const std::wstring& name) const
 {
 	const resource_directory::entry_list& entries =
 		root_dir_ //Type directory
@@ -220,7 +220,7 @@ const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resour
 }
 
 //Lists resource languages by resource type and ID
-const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(resource_type type, uint32_t id) const
+pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(resource_type type, uint32_t id) const
 {
 	const resource_directory::entry_list& entries =
 		root_dir_ //Type directory
@@ -234,7 +234,7 @@ const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resour
 }
 
 //Lists resource languages by resource name and ID
-const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(const std::wstring& root_name, uint32_t id) const
+pe_resource_viewer::resource_language_list pe_resource_viewer::list_resource_languages(const std::wstring& root_name, uint32_t id) const
 {
 	const resource_directory::entry_list& entries =
 		root_dir_ //Type directory
@@ -248,7 +248,7 @@ const pe_resource_viewer::resource_language_list pe_resource_viewer::list_resour
 }
 
 //Returns raw resource data by type, name and language
-const resource_data_info pe_resource_viewer::get_resource_data_by_name(uint32_t language, resource_type type, const std::wstring& name) const
+resource_data_info pe_resource_viewer::get_resource_data_by_name(uint32_t language, resource_type type, const std::wstring& name) const
 {
 	return resource_data_info(root_dir_ //Type directory
 		.entry_by_id(type)
@@ -260,7 +260,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_name(uint32_t
 }
 
 //Returns raw resource data by root name, name and language
-const resource_data_info pe_resource_viewer::get_resource_data_by_name(uint32_t language, const std::wstring& root_name, const std::wstring& name) const
+resource_data_info pe_resource_viewer::get_resource_data_by_name(uint32_t language, const std::wstring& root_name, const std::wstring& name) const
 {
 	return resource_data_info(root_dir_ //Type directory
 		.entry_by_name(root_name)
@@ -272,7 +272,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_name(uint32_t
 }
 
 //Returns raw resource data by type, ID and language
-const resource_data_info pe_resource_viewer::get_resource_data_by_id(uint32_t language, resource_type type, uint32_t id) const
+resource_data_info pe_resource_viewer::get_resource_data_by_id(uint32_t language, resource_type type, uint32_t id) const
 {
 	return resource_data_info(root_dir_ //Type directory
 		.entry_by_id(type)
@@ -284,7 +284,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_id(uint32_t la
 }
 
 //Returns raw resource data by root name, ID and language
-const resource_data_info pe_resource_viewer::get_resource_data_by_id(uint32_t language, const std::wstring& root_name, uint32_t id) const
+resource_data_info pe_resource_viewer::get_resource_data_by_id(uint32_t language, const std::wstring& root_name, uint32_t id) const
 {
 	return resource_data_info(root_dir_ //Type directory
 		.entry_by_name(root_name)
@@ -296,7 +296,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_id(uint32_t la
 }
 
 //Returns raw resource data by type, name and index in language directory (instead of language)
-const resource_data_info pe_resource_viewer::get_resource_data_by_name(resource_type type, const std::wstring& name, uint32_t index) const
+resource_data_info pe_resource_viewer::get_resource_data_by_name(resource_type type, const std::wstring& name, uint32_t index) const
 {
 	const resource_directory::entry_list& entries = root_dir_ //Type directory
 		.entry_by_id(type)
@@ -312,7 +312,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_name(resource_
 }
 
 //Returns raw resource data by root name, name and index in language directory (instead of language)
-const resource_data_info pe_resource_viewer::get_resource_data_by_name(const std::wstring& root_name, const std::wstring& name, uint32_t index) const
+resource_data_info pe_resource_viewer::get_resource_data_by_name(const std::wstring& root_name, const std::wstring& name, uint32_t index) const
 {
 	const resource_directory::entry_list& entries = root_dir_ //Type directory
 		.entry_by_name(root_name)
@@ -328,7 +328,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_name(const std
 }
 
 //Returns raw resource data by type, ID and index in language directory (instead of language)
-const resource_data_info pe_resource_viewer::get_resource_data_by_id(resource_type type, uint32_t id, uint32_t index) const
+resource_data_info pe_resource_viewer::get_resource_data_by_id(resource_type type, uint32_t id, uint32_t index) const
 {
 	const resource_directory::entry_list& entries = root_dir_ //Type directory
 		.entry_by_id(type)
@@ -344,7 +344,7 @@ const resource_data_info pe_resource_viewer::get_resource_data_by_id(resource_ty
 }
 
 //Returns raw resource data by root name, ID and index in language directory (instead of language)
-const resource_data_info pe_resource_viewer::get_resource_data_by_id(const std::wstring& root_name, uint32_t id, uint32_t index) const
+resource_data_info pe_resource_viewer::get_resource_data_by_id(const std::wstring& root_name, uint32_t id, uint32_t index) const
 {
 	const resource_directory::entry_list& entries = root_dir_ //Type directory
 		.entry_by_name(root_name)
@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <deque>
 #include <string.h>
 #include "pe_resources.h"
+#include "pe_threads.h"
+#include "pe_md5.h"
 
 namespace pe_bliss
 {
@@ -9,14 +12,79 @@ using namespace pe_win;
 //RESOURCES
 //Default constructor
 resource_data_entry::resource_data_entry()
-	:codepage_(0)
+	:codepage_(0), pe_(0), rva_(0), size_(0), image_data_(0)
 {}
 
 //Constructor from data
 resource_data_entry::resource_data_entry(const std::string& data, uint32_t codepage)
-	:codepage_(codepage), data_(data)
+	:codepage_(codepage), data_(data), pe_(0), rva_(0), size_(0), image_data_(0)
 {}
 
+//Constructor of entry, which references "size" bytes of data at RVA "rva" of image "pe"
+resource_data_entry::resource_data_entry(const pe_base& pe, uint32_t rva, uint32_t size, uint32_t codepage)
+	:codepage_(codepage), pe_(&pe), rva_(rva), size_(size), image_data_(0)
+{}
+
+//Copy constructor
+resource_data_entry::resource_data_entry(const resource_data_entry& other)
+	:codepage_(other.codepage_), data_(other.data_), pe_(other.pe_), rva_(other.rva_), size_(other.size_), image_data_(0)
+{
+	//Data, which was already read from image, is copied too
+	const std::string* image_data = static_cast<const std::string*>(pe_atomic::load_pointer(reinterpret_cast<void* volatile*>(&other.image_data_)));
+	if(image_data)
+		image_data_ = new std::string(*image_data);
+}
+
+//Copy assignment operator
+resource_data_entry& resource_data_entry::operator=(const resource_data_entry& other)
+{
+	resource_data_entry(other).swap(*this);
+	return *this;
+}
+
+//Destructor
+resource_data_entry::~resource_data_entry()
+{
+	release();
+}
+
+#ifdef PE_BLISS_MOVE_SEMANTICS
+//Move constructor
+resource_data_entry::resource_data_entry(resource_data_entry&& other) PE_BLISS_NOEXCEPT
+	:codepage_(0), pe_(0), rva_(0), size_(0), image_data_(0)
+{
+	swap(other);
+}
+
+//Move assignment operator
+resource_data_entry& resource_data_entry::operator=(resource_data_entry&& other) PE_BLISS_NOEXCEPT
+{
+	swap(other);
+	return *this;
+}
+#endif
+
+//Exchanges contents of two entries
+void resource_data_entry::swap(resource_data_entry& other)
+{
+	std::swap(codepage_, other.codepage_);
+	data_.swap(other.data_);
+	std::swap(pe_, other.pe_);
+	std::swap(rva_, other.rva_);
+	std::swap(size_, other.size_);
+
+	std::string* image_data = image_data_;
+	image_data_ = other.image_data_;
+	other.image_data_ = image_data;
+}
+
+//Destroys data read from image
+void resource_data_entry::release()
+{
+	delete image_data_;
+	image_data_ = 0;
+}
+
 //Returns resource data codepage
 uint32_t resource_data_entry::get_codepage() const
 {
@@ -26,7 +94,70 @@ uint32_t resource_data_entry::get_codepage() const
 //Returns resource data
 const std::string& resource_data_entry::get_data() const
 {
-	return data_;
+	if(!pe_)
+		return data_;
+
+	std::string* image_data = static_cast<std::string*>(pe_atomic::load_pointer(reinterpret_cast<void* volatile*>(&image_data_)));
+	if(image_data)
+		return *image_data;
+
+	std::string* data = new std::string(size_, 0);
+	try
+	{
+		if(size_)
+			pe_->read_data_from_rva(rva_, &(*data)[0], size_, true);
+	}
+	catch(...)
+	{
+		delete data;
+		throw;
+	}
+
+	//Another thread could read data first, then its data is used
+	if(pe_atomic::compare_and_swap_pointer(reinterpret_cast<void* volatile*>(&image_data_), data, 0))
+		return *data;
+
+	delete data;
+	return *static_cast<std::string*>(pe_atomic::load_pointer(reinterpret_cast<void* volatile*>(&image_data_)));
+}
+
+//Returns size of resource data
+uint32_t resource_data_entry::get_size() const
+{
+	return pe_ ? size_ : static_cast<uint32_t>(data_.length());
+}
+
+//Returns true if entry references image data
+bool resource_data_entry::references_image() const
+{
+	return pe_ != 0;
+}
+
+//Returns RVA of resource data inside of image
+uint32_t resource_data_entry::get_rva() const
+{
+	return rva_;
+}
+
+//Returns view of resource data, which doesn't copy it
+section_data_view resource_data_entry::get_data_view() const
+{
+	//Data inside of image headers is read by get_data()
+	if(pe_ && rva_ >= pe_->get_full_headers_data().length())
+	{
+		const section& s = pe_->section_from_rva(rva_);
+		section_data_view view(s.get_virtual_view(pe_->get_section_alignment()));
+		uint32_t offset = rva_ - s.get_virtual_address();
+		if(view.get_size() < offset || view.get_size() - offset < size_)
+			throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+		//Part of data can be zero-filled (outside of raw section data)
+		uint32_t raw_length = view.get_raw_data_length() > offset ? std::min(view.get_raw_data_length() - offset, size_) : 0;
+		return section_data_view(raw_length ? view.get_raw_data_ptr() + offset : 0, raw_length, size_);
+	}
+
+	const std::string& data = get_data();
+	return section_data_view(data.data(), static_cast<uint32_t>(data.length()), static_cast<uint32_t>(data.length()));
 }
 
 //Sets resource data codepage
@@ -39,6 +170,10 @@ void resource_data_entry::set_codepage(uint32_t codepage)
 void resource_data_entry::set_data(const std::string& data)
 {
 	data_ = data;
+	release();
+	pe_ = 0;
+	rva_ = 0;
+	size_ = 0;
 }
 
 //Default constructor
@@ -87,6 +222,32 @@ resource_directory_entry& resource_directory_entry::operator=(const resource_dir
 	return *this;
 }
 
+#ifdef PE_BLISS_MOVE_SEMANTICS
+//Move constructor (included data is not copied)
+resource_directory_entry::resource_directory_entry(resource_directory_entry&& other) PE_BLISS_NOEXCEPT
+	:id_(0), includes_data_(false), named_(false)
+{
+	swap(other);
+}
+
+//Move assignment operator (included data is not copied)
+resource_directory_entry& resource_directory_entry::operator=(resource_directory_entry&& other) PE_BLISS_NOEXCEPT
+{
+	swap(other);
+	return *this;
+}
+#endif
+
+//Exchanges contents of two entries without copying included data
+void resource_directory_entry::swap(resource_directory_entry& other)
+{
+	std::swap(id_, other.id_);
+	name_.swap(other.name_);
+	std::swap(ptr_, other.ptr_);
+	std::swap(includes_data_, other.includes_data_);
+	std::swap(named_, other.named_);
+}
+
 //Destroys included data
 void resource_directory_entry::release()
 {
@@ -207,7 +368,8 @@ resource_directory::resource_directory()
 	:characteristics_(0),
 	timestamp_(0),
 	major_version_(0), minor_version_(0),
-	number_of_named_entries_(0), number_of_id_entries_(0)
+	number_of_named_entries_(0), number_of_id_entries_(0),
+	index_valid_(false), index_has_duplicates_(false)
 {}
 
 //Constructor from data
@@ -215,7 +377,8 @@ resource_directory::resource_directory(const image_resource_directory& dir)
 	:characteristics_(dir.Characteristics),
 	timestamp_(dir.TimeDateStamp),
 	major_version_(dir.MajorVersion), minor_version_(dir.MinorVersion),
-	number_of_named_entries_(0), number_of_id_entries_(0) //Set to zero here, calculate on add
+	number_of_named_entries_(0), number_of_id_entries_(0), //Set to zero here, calculate on add
+	index_valid_(false), index_has_duplicates_(false)
 {}
 
 //Returns characteristics of directory
@@ -263,6 +426,7 @@ const resource_directory::entry_list& resource_directory::get_entry_list() const
 //Returns resource_directory_entry array
 resource_directory::entry_list& resource_directory::get_entry_list()
 {
+	reset_index();
 	return entries_;
 }
 
@@ -270,6 +434,9 @@ resource_directory::entry_list& resource_directory::get_entry_list()
 void resource_directory::add_resource_directory_entry(const resource_directory_entry& entry)
 {
 	entries_.push_back(entry);
+	if(index_valid_)
+		add_to_index(entries_.back(), entries_.size() - 1);
+
 	if(entry.is_named())
 		++number_of_named_entries_;
 	else
@@ -279,6 +446,7 @@ void resource_directory::add_resource_directory_entry(const resource_directory_e
 //Clears resource_directory_entry array
 void resource_directory::clear_resource_directory_entry_list()
 {
+	reset_index();
 	entries_.clear();
 	number_of_named_entries_ = 0;
 	number_of_id_entries_ = 0;
@@ -321,7 +489,7 @@ void resource_directory::get_minor_version(uint16_t minor_version)
 }
 
 //Processes resource directory
-const resource_directory process_resource_directory(const pe_base& pe, uint32_t res_rva, uint32_t offset_to_directory, std::set<uint32_t>& processed)
+resource_directory process_resource_directory(const pe_base& pe, uint32_t res_rva, uint32_t offset_to_directory, std::set<uint32_t>& processed, bool read_data)
 {
 	resource_directory ret;
 	
@@ -369,15 +537,20 @@ const resource_directory process_resource_directory(const pe_base& pe, uint32_t
 				< directory_name_length)
 				throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
 
+			//Read entry UNICODE name
+			std::string name_data(directory_name_length * sizeof(uint16_t), 0);
+			if(directory_name_length)
+				pe.read_data_from_rva(res_rva + dir_entry.NameOffset + sizeof(uint16_t), &name_data[0], directory_name_length * sizeof(uint16_t), true);
+
 #ifdef PE_BLISS_WINDOWS
 			//Set entry UNICODE name
 			entry.set_name(std::wstring(
-				reinterpret_cast<const wchar_t*>(pe.section_data_from_rva(res_rva + dir_entry.NameOffset + sizeof(uint16_t), section_data_virtual, true)),
+				reinterpret_cast<const wchar_t*>(name_data.data()),
 				directory_name_length));
 #else
 			//Set entry UNICODE name
 			entry.set_name(pe_utils::from_ucs2(u16string(
-				reinterpret_cast<const unicode16_t*>(pe.section_data_from_rva(res_rva + dir_entry.NameOffset + sizeof(uint16_t), section_data_virtual, true)),
+				reinterpret_cast<const unicode16_t*>(name_data.data()),
 				directory_name_length)));
 #endif
 		}
@@ -390,7 +563,7 @@ const resource_directory process_resource_directory(const pe_base& pe, uint32_t
 		//If directory entry has another resource directory
 		if(dir_entry.DataIsDirectory)
 		{
-			entry.add_resource_directory(process_resource_directory(pe, res_rva, dir_entry.OffsetToDirectory, processed));
+			entry.add_resource_directory(process_resource_directory(pe, res_rva, dir_entry.OffsetToDirectory, processed, read_data));
 		}
 		else
 		{
@@ -402,10 +575,21 @@ const resource_directory process_resource_directory(const pe_base& pe, uint32_t
 			if(pe.section_data_length_from_rva(data_entry.OffsetToData, data_entry.OffsetToData, section_data_virtual, true) < data_entry.Size)
 				throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
 
-			//Add data entry to directory entry
-			entry.add_data_entry(resource_data_entry(
-				std::string(pe.section_data_from_rva(data_entry.OffsetToData, section_data_virtual, true), data_entry.Size),
-				data_entry.CodePage));
+			if(read_data)
+			{
+				//Read resource data
+				std::string data(data_entry.Size, 0);
+				if(data_entry.Size)
+					pe.read_data_from_rva(data_entry.OffsetToData, &data[0], data_entry.Size, true);
+
+				//Add data entry to directory entry
+				entry.add_data_entry(resource_data_entry(data, data_entry.CodePage));
+			}
+			else
+			{
+				//Add data entry, which references resource data
+				entry.add_data_entry(resource_data_entry(pe, data_entry.OffsetToData, data_entry.Size, data_entry.CodePage));
+			}
 		}
 
 		//Save directory entry
@@ -439,6 +623,7 @@ void calculate_resource_data_space(const resource_directory& root, uint32_t need
 	{
 		if((*it).includes_data())
 		{
+			//Data of entries, which reference image, is read here, before resource section is changed
 			uint32_t data_size = static_cast<uint32_t>((*it).get_data_entry().get_data().length()
 				+ sizeof(image_resource_data_entry)
 				+ (pe_utils::align_up(current_data_pos, sizeof(uint32_t)) - current_data_pos) /* alignment */);
@@ -459,6 +644,49 @@ public:
 	bool operator()(const resource_directory_entry& entry1, const resource_directory_entry& entry2) const;
 };
 
+//Helper: sorts pointers to resource directory entries
+struct entry_pointer_sorter
+{
+public:
+	bool operator()(const resource_directory_entry* entry1, const resource_directory_entry* entry2) const
+	{
+		return entry_sorter()(*entry1, *entry2);
+	}
+};
+
+//Helper: sorts resource directory entries, if they are not sorted yet
+void sort_resource_directory_entries(resource_directory::entry_list& entries)
+{
+	//Entries are usually already sorted (directories, which were read from image or rebuilt before)
+	bool sorted = true;
+	for(std::size_t i = 1; i < entries.size(); ++i)
+	{
+		if(entry_sorter()(entries[i], entries[i - 1]))
+		{
+			sorted = false;
+			break;
+		}
+	}
+
+	if(sorted)
+		return;
+
+	//Pointers are sorted, and then entries are swapped to their places,
+	//so subdirectories and data are not copied
+	std::vector<resource_directory_entry*> order;
+	order.reserve(entries.size());
+	for(resource_directory::entry_list::iterator it = entries.begin(); it != entries.end(); ++it)
+		order.push_back(&*it);
+
+	std::stable_sort(order.begin(), order.end(), entry_pointer_sorter());
+
+	resource_directory::entry_list sorted_entries(entries.size());
+	for(std::size_t i = 0; i != order.size(); ++i)
+		sorted_entries[i].swap(*order[i]);
+
+	entries.swap(sorted_entries);
+}
+
 //Helper function to rebuild resource directory
 void rebuild_resource_directory(pe_base& pe, section& resource_section, resource_directory& root, uint32_t& current_structures_pos, uint32_t& current_data_pos, uint32_t& current_strings_pos, uint32_t offset_from_section_start)
 {
@@ -469,10 +697,7 @@ void rebuild_resource_directory(pe_base& pe, section& resource_section, resource
 	dir.MinorVersion = root.get_minor_version();
 	dir.TimeDateStamp = root.get_timestamp();
 	
-	{
-		resource_directory::entry_list& entries = root.get_entry_list();
-		std::sort(entries.begin(), entries.end(), entry_sorter());
-	}
+	sort_resource_directory_entries(root.get_entry_list());
 
 	//Calculate number of named and ID entries
 	for(resource_directory::entry_list::const_iterator it = root.get_entry_list().begin(); it != root.get_entry_list().end(); ++it)
@@ -562,6 +787,294 @@ bool entry_sorter::operator()(const resource_directory_entry& entry1, const reso
 		return entry1.is_named();
 }
 
+//Helper: planned resource directory of deduplicating rebuilder
+struct resource_plan_directory
+{
+	const resource_directory* dir;
+	//Offset from start of directory structures
+	uint32_t offset;
+	//Index of first entry in entries of plan
+	uint32_t first_entry;
+	uint16_t number_of_named_entries, number_of_id_entries;
+};
+
+//Helper: planned resource directory entry of deduplicating rebuilder
+struct resource_plan_entry
+{
+	//ID or offset of name from start of strings
+	uint32_t name;
+	//Offset of subdirectory from start of directory structures or index of data entry
+	uint32_t target;
+	bool named;
+	bool includes_data;
+};
+
+//Helper: planned resource data entry of deduplicating rebuilder
+struct resource_plan_data_entry
+{
+	uint32_t blob;
+	uint32_t codepage;
+};
+
+//Helper: layout of resource directory, which is planned by one pass over the tree
+//Identical data and names are stored once
+struct resource_plan
+{
+	std::vector<resource_plan_directory> directories;
+	std::vector<resource_plan_entry> entries;
+	std::vector<resource_plan_data_entry> data_entries;
+	//Unique data blobs
+	std::vector<const std::string*> blobs;
+	//Offsets of blobs from start of blobs
+	std::vector<uint32_t> blob_offsets;
+	//Unique names in order of their offsets (names and blobs are owned by tree)
+	std::vector<const std::wstring*> names;
+
+	uint32_t structures_size;
+	uint32_t strings_size;
+	uint32_t blobs_size;
+
+	//Returns offset of data entries from start of resource directory
+	uint32_t get_data_entries_offset() const
+	{
+		return pe_utils::align_up(structures_size + strings_size, sizeof(uint32_t));
+	}
+
+	//Returns offset of blobs from start of resource directory
+	uint32_t get_blobs_offset() const
+	{
+		return get_data_entries_offset() + static_cast<uint32_t>(data_entries.size() * sizeof(image_resource_data_entry));
+	}
+
+	//Returns size of resource directory
+	uint32_t get_size() const
+	{
+		return get_blobs_offset() + blobs_size;
+	}
+};
+
+//Helper: returns size of resource directory structure with its entries
+uint32_t get_resource_directory_structure_size(const resource_directory& dir)
+{
+	return static_cast<uint32_t>(sizeof(image_resource_directory) + dir.get_entry_list().size() * sizeof(image_resource_directory_entry));
+}
+
+//Helper: adds value to size, throws an exception on overflow
+void add_resource_plan_size(uint32_t& size, std::size_t value)
+{
+	if(value > static_cast<uint32_t>(-1) - size)
+		throw pe_exception("Resource directory is too big", pe_exception::incorrect_resource_directory);
+
+	size += static_cast<uint32_t>(value);
+}
+
+//Helper: plans layout of resource directory "root" with one pass over the tree
+//Directory entries are sorted, data of entries, which reference image, is read
+void plan_resource_directory(resource_directory& root, resource_plan& plan)
+{
+	plan.structures_size = get_resource_directory_structure_size(root);
+	plan.strings_size = 0;
+	plan.blobs_size = 0;
+
+	//Names are keyed by themselves, data blobs by MD5 of their contents and size
+	//Blobs with equal keys are compared, so MD5 collisions don't merge different data
+	std::map<std::wstring, uint32_t> names;
+	typedef std::map<std::pair<std::string, std::size_t>, std::vector<uint32_t> > blob_map;
+	blob_map blobs;
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> data_entries;
+
+	//Directories, which offsets are already known, and their offsets
+	std::vector<std::pair<resource_directory*, uint32_t> > stack;
+	stack.push_back(std::make_pair(&root, 0u));
+	while(!stack.empty())
+	{
+		resource_directory& dir = *stack.back().first;
+		resource_plan_directory planned_dir;
+		planned_dir.dir = &dir;
+		planned_dir.offset = stack.back().second;
+		planned_dir.first_entry = static_cast<uint32_t>(plan.entries.size());
+		planned_dir.number_of_named_entries = 0;
+		planned_dir.number_of_id_entries = 0;
+		stack.pop_back();
+
+		resource_directory::entry_list& entries = dir.get_entry_list();
+		if(entries.size() > pe_utils::max_word)
+			throw pe_exception("Too many resource directory entries", pe_exception::incorrect_resource_directory);
+
+		sort_resource_directory_entries(entries);
+
+		for(resource_directory::entry_list::iterator it = entries.begin(); it != entries.end(); ++it)
+		{
+			resource_plan_entry planned_entry;
+			planned_entry.named = (*it).is_named();
+			planned_entry.includes_data = (*it).includes_data();
+			if(planned_entry.named)
+			{
+				++planned_dir.number_of_named_entries;
+
+				std::map<std::wstring, uint32_t>::const_iterator name = names.find((*it).get_name());
+				if(name == names.end())
+				{
+					if((*it).get_name().length() > pe_utils::max_word)
+						throw pe_exception("Too long resource name", pe_exception::incorrect_resource_directory);
+
+					name = names.insert(std::make_pair((*it).get_name(), plan.strings_size)).first;
+					plan.names.push_back(&(*it).get_name());
+					add_resource_plan_size(plan.strings_size, ((*it).get_name().length() + 1) * 2 /* unicode */ + sizeof(uint16_t) /* for string length */);
+				}
+
+				planned_entry.name = (*name).second;
+			}
+			else
+			{
+				++planned_dir.number_of_id_entries;
+				planned_entry.name = (*it).get_id();
+			}
+
+			if(planned_entry.includes_data)
+			{
+				//Data of entries, which reference image, is read here, before resource section is changed
+				const resource_data_entry& data_entry = (*it).get_data_entry();
+				const std::string& data = data_entry.get_data();
+
+				uint8_t digest[md5_hash::digest_size];
+				md5_hash hash;
+				hash.update(data.data(), data.length());
+				hash.finalize(digest);
+
+				std::vector<uint32_t>& same_hash_blobs = blobs[std::make_pair(std::string(reinterpret_cast<const char*>(digest), sizeof(digest)), data.length())];
+				uint32_t blob = static_cast<uint32_t>(plan.blobs.size());
+				for(std::vector<uint32_t>::const_iterator b = same_hash_blobs.begin(); b != same_hash_blobs.end(); ++b)
+				{
+					if(*plan.blobs[*b] == data)
+					{
+						blob = *b;
+						break;
+					}
+				}
+
+				if(blob == plan.blobs.size())
+				{
+					same_hash_blobs.push_back(blob);
+					plan.blobs.push_back(&data);
+					plan.blobs_size = pe_utils::align_up(plan.blobs_size, sizeof(uint32_t));
+					plan.blob_offsets.push_back(plan.blobs_size);
+					add_resource_plan_size(plan.blobs_size, data.length());
+				}
+
+				//Entries with the same data and codepage share data entry structure
+				std::pair<std::map<std::pair<uint32_t, uint32_t>, uint32_t>::iterator, bool> data_entry_index
+					= data_entries.insert(std::make_pair(std::make_pair(blob, data_entry.get_codepage()), static_cast<uint32_t>(plan.data_entries.size())));
+				if(data_entry_index.second)
+				{
+					resource_plan_data_entry planned_data_entry;
+					planned_data_entry.blob = blob;
+					planned_data_entry.codepage = data_entry.get_codepage();
+					plan.data_entries.push_back(planned_data_entry);
+				}
+
+				planned_entry.target = (*data_entry_index.first).second;
+			}
+			else
+			{
+				//Place of subdirectory is reserved now, so entry can be planned without waiting for it
+				resource_directory& subdir = (*it).get_resource_directory();
+				planned_entry.target = plan.structures_size;
+				add_resource_plan_size(plan.structures_size, get_resource_directory_structure_size(subdir));
+				stack.push_back(std::make_pair(&subdir, planned_entry.target));
+			}
+
+			plan.entries.push_back(planned_entry);
+		}
+
+		plan.directories.push_back(planned_dir);
+	}
+
+	//Check that whole directory fits 32-bit offsets
+	uint32_t size = plan.get_data_entries_offset();
+	add_resource_plan_size(size, plan.data_entries.size() * sizeof(image_resource_data_entry));
+	size = pe_utils::align_up(size, sizeof(uint32_t));
+	add_resource_plan_size(size, plan.blobs_size);
+}
+
+//Helper: writes planned resource directory to "resource_section" at offset "offset_from_section_start"
+void write_resource_plan(pe_base& pe, section& resource_section, const resource_plan& plan, uint32_t offset_from_section_start)
+{
+	std::string& raw_data = resource_section.get_raw_data();
+	char* base = &raw_data[offset_from_section_start];
+
+	//Directories and their entries
+	for(std::vector<resource_plan_directory>::const_iterator it = plan.directories.begin(); it != plan.directories.end(); ++it)
+	{
+		const resource_plan_directory& planned_dir = *it;
+
+		image_resource_directory dir = {0};
+		dir.Characteristics = planned_dir.dir->get_characteristics();
+		dir.MajorVersion = planned_dir.dir->get_major_version();
+		dir.MinorVersion = planned_dir.dir->get_minor_version();
+		dir.TimeDateStamp = planned_dir.dir->get_timestamp();
+		dir.NumberOfNamedEntries = planned_dir.number_of_named_entries;
+		dir.NumberOfIdEntries = planned_dir.number_of_id_entries;
+		memcpy(base + planned_dir.offset, &dir, sizeof(dir));
+
+		uint32_t entry_pos = planned_dir.offset + sizeof(dir);
+		uint32_t entry_count = planned_dir.number_of_named_entries + planned_dir.number_of_id_entries;
+		for(uint32_t i = 0; i != entry_count; ++i, entry_pos += sizeof(image_resource_directory_entry))
+		{
+			const resource_plan_entry& planned_entry = plan.entries[planned_dir.first_entry + i];
+
+			image_resource_directory_entry entry;
+			entry.Name = planned_entry.named ? 0x80000000 | (plan.structures_size + planned_entry.name) : planned_entry.name;
+			entry.OffsetToData = planned_entry.includes_data
+				? static_cast<uint32_t>(plan.get_data_entries_offset() + planned_entry.target * sizeof(image_resource_data_entry))
+				: 0x80000000 | planned_entry.target;
+
+			memcpy(base + entry_pos, &entry, sizeof(entry));
+		}
+	}
+
+	//Names
+	uint32_t string_pos = plan.structures_size;
+	for(std::vector<const std::wstring*>::const_iterator it = plan.names.begin(); it != plan.names.end(); ++it)
+	{
+		const std::wstring& name = **it;
+		uint16_t unicode_length = static_cast<uint16_t>(name.length());
+		memcpy(base + string_pos, &unicode_length, sizeof(unicode_length));
+		string_pos += sizeof(unicode_length);
+
+#ifdef PE_BLISS_WINDOWS
+		memcpy(base + string_pos, name.c_str(), name.length() * sizeof(uint16_t) + sizeof(uint16_t) /* unicode */);
+#else
+		{
+			u16string str(pe_utils::to_ucs2(name));
+			memcpy(base + string_pos, str.c_str(), name.length() * sizeof(uint16_t) + sizeof(uint16_t) /* unicode */);
+		}
+#endif
+
+		string_pos += static_cast<uint32_t>(name.length() * sizeof(uint16_t) + sizeof(uint16_t) /* unicode */);
+	}
+
+	//Data entries
+	uint32_t data_entry_pos = plan.get_data_entries_offset();
+	uint32_t blobs_offset = plan.get_blobs_offset();
+	for(std::vector<resource_plan_data_entry>::const_iterator it = plan.data_entries.begin(); it != plan.data_entries.end(); ++it)
+	{
+		image_resource_data_entry data_entry = {0};
+		data_entry.CodePage = (*it).codepage;
+		data_entry.Size = static_cast<uint32_t>(plan.blobs[(*it).blob]->length());
+		data_entry.OffsetToData = pe.rva_from_section_offset(resource_section, offset_from_section_start + blobs_offset + plan.blob_offsets[(*it).blob]);
+		memcpy(base + data_entry_pos, &data_entry, sizeof(data_entry));
+		data_entry_pos += sizeof(data_entry);
+	}
+
+	//Data
+	for(std::size_t i = 0; i != plan.blobs.size(); ++i)
+	{
+		if(!plan.blobs[i]->empty())
+			memcpy(base + blobs_offset + plan.blob_offsets[i], plan.blobs[i]->data(), plan.blobs[i]->length());
+	}
+}
+
 //Resources rebuilder
 //resource_directory - root resource directory
 //resources_section - section where resource directory will be placed (must be attached to PE image)
@@ -570,7 +1083,7 @@ bool entry_sorter::operator()(const resource_directory_entry& entry1, const reso
 //save_to_pe_headers - if true, new resource directory information will be saved to PE image headers
 //auto_strip_last_section - if true and resources are placed in the last section, it will be automatically stripped
 //number_of_id_entries and number_of_named_entries for resource directories are recalculated and not used
-const image_directory rebuild_resources(pe_base& pe, resource_directory& info, section& resources_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section)
+image_directory rebuild_resources(pe_base& pe, resource_directory& info, section& resources_section, uint32_t offset_from_section_start, bool save_to_pe_header, bool auto_strip_last_section, bool deduplicate)
 {
 	//Check that resources_section is attached to this PE image
 	if(!pe.section_attached(resources_section))
@@ -584,15 +1097,25 @@ const image_directory rebuild_resources(pe_base& pe, resource_directory& info, s
 	uint32_t needed_size_for_structures = aligned_offset_from_section_start - offset_from_section_start; //Calculate needed size for resource tables and data
 	uint32_t needed_size_for_strings = 0;
 	uint32_t needed_size_for_data = 0;
+	uint32_t needed_size;
 
-	calculate_resource_data_space(info, aligned_offset_from_section_start, needed_size_for_structures, needed_size_for_strings);
-
+	resource_plan plan;
+	if(deduplicate)
 	{
-		uint32_t current_data_pos = aligned_offset_from_section_start + needed_size_for_structures + needed_size_for_strings;
-		calculate_resource_data_space(info, needed_size_for_structures, needed_size_for_strings, needed_size_for_data, current_data_pos);
+		plan_resource_directory(info, plan);
+		needed_size = plan.get_size();
 	}
+	else
+	{
+		calculate_resource_data_space(info, aligned_offset_from_section_start, needed_size_for_structures, needed_size_for_strings);
 
-	uint32_t needed_size = needed_size_for_structures + needed_size_for_strings + needed_size_for_data;
+		{
+			uint32_t current_data_pos = aligned_offset_from_section_start + needed_size_for_structures + needed_size_for_strings;
+			calculate_resource_data_space(info, needed_size_for_structures, needed_size_for_strings, needed_size_for_data, current_data_pos);
+		}
+
+		needed_size = needed_size_for_structures + needed_size_for_strings + needed_size_for_data;
+	}
 
 	//Check if resources_section is last one. If it's not, check if there's enough place for resource data
 	if(&resources_section != &*(pe.get_image_sections().end() - 1) && 
@@ -606,10 +1129,17 @@ const image_directory rebuild_resources(pe_base& pe, resource_directory& info, s
 	if(raw_data.length() < needed_size + aligned_offset_from_section_start)
 		raw_data.resize(needed_size + aligned_offset_from_section_start); //Expand section raw data
 
-	uint32_t current_structures_pos = aligned_offset_from_section_start;
-	uint32_t current_strings_pos = current_structures_pos + needed_size_for_structures;
-	uint32_t current_data_pos = current_strings_pos + needed_size_for_strings;
-	rebuild_resource_directory(pe, resources_section, info, current_structures_pos, current_data_pos, current_strings_pos, aligned_offset_from_section_start);
+	if(deduplicate)
+	{
+		write_resource_plan(pe, resources_section, plan, aligned_offset_from_section_start);
+	}
+	else
+	{
+		uint32_t current_structures_pos = aligned_offset_from_section_start;
+		uint32_t current_strings_pos = current_structures_pos + needed_size_for_structures;
+		uint32_t current_data_pos = current_strings_pos + needed_size_for_strings;
+		rebuild_resource_directory(pe, resources_section, info, current_structures_pos, current_data_pos, current_strings_pos, aligned_offset_from_section_start);
+	}
 	
 	//Adjust section raw and virtual sizes
 	pe.recalculate_section_sizes(resources_section, auto_strip_last_section);
@@ -627,7 +1157,7 @@ const image_directory rebuild_resources(pe_base& pe, resource_directory& info, s
 }
 
 //Returns resources from PE file
-const resource_directory get_resources(const pe_base& pe)
+resource_directory get_resources(const pe_base& pe, bool read_data)
 {
 	resource_directory ret;
 
@@ -641,46 +1171,904 @@ const resource_directory get_resources(const pe_base& pe)
 	std::set<uint32_t> processed;
 	
 	//Process all directories (recursion)
-	ret = process_resource_directory(pe, res_rva, 0, processed);
+	ret = process_resource_directory(pe, res_rva, 0, processed, read_data);
 
 	return ret;
 }
 
-//Finds resource_directory_entry by ID
-resource_directory::id_entry_finder::id_entry_finder(uint32_t id)
-	:id_(id)
+//Constructor from ID
+resource_id::resource_id(uint32_t id)
+	:id_(id), named_(false)
 {}
 
-bool resource_directory::id_entry_finder::operator()(const resource_directory_entry& entry) const
+//Constructor from name
+resource_id::resource_id(const std::wstring& name)
+	:id_(0), name_(name), named_(true)
+{}
+
+//Constructor from name
+resource_id::resource_id(const wchar_t* name)
+	:id_(0), name_(name), named_(true)
+{}
+
+//Returns true, if identifier is name
+bool resource_id::is_named() const
 {
-	return !entry.is_named() && entry.get_id() == id_;
+	return named_;
 }
 
-//Finds resource_directory_entry by name
-resource_directory::name_entry_finder::name_entry_finder(const std::wstring& name)
-	:name_(name)
-{}
+//Returns ID
+uint32_t resource_id::get_id() const
+{
+	return id_;
+}
 
-bool resource_directory::name_entry_finder::operator()(const resource_directory_entry& entry) const
+//Returns name
+const std::wstring& resource_id::get_name() const
 {
-	return entry.is_named() && entry.get_name() == name_;
+	return name_;
 }
 
-//Finds resource_directory_entry by name or ID (universal)
-resource_directory::entry_finder::entry_finder(const std::wstring& name)
-	:name_(name), named_(true)
-{}
+//Helper: compares name of resource directory entry at RVA "name_rva" with "name"
+//Returns negative value, zero or positive value, if entry name is less than, equal to or greater than "name"
+int compare_resource_name(const pe_base& pe, uint32_t name_rva, const u16string& name)
+{
+	if(!pe_utils::is_sum_safe(name_rva, sizeof(uint16_t)))
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
 
-resource_directory::entry_finder::entry_finder(uint32_t id)
-	:id_(id), named_(false)
-{}
+	uint16_t length = pe.section_data_from_rva<uint16_t>(name_rva, section_data_virtual, true);
+	if(pe.section_data_length_from_rva(name_rva + sizeof(uint16_t), name_rva + sizeof(uint16_t), section_data_virtual, true) < length * sizeof(uint16_t))
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
 
-bool resource_directory::entry_finder::operator()(const resource_directory_entry& entry) const
+	//Name is read by small chunks through section view, only compared part of it is read
+	uint16_t chunk[64];
+	std::size_t compared_length = std::min<std::size_t>(length, name.length());
+	for(std::size_t pos = 0; pos != compared_length;)
+	{
+		std::size_t chunk_length = std::min<std::size_t>(compared_length - pos, sizeof(chunk) / sizeof(chunk[0]));
+		pe.read_data_from_rva(static_cast<uint32_t>(name_rva + sizeof(uint16_t) + pos * sizeof(uint16_t)),
+			reinterpret_cast<char*>(chunk), static_cast<uint32_t>(chunk_length * sizeof(uint16_t)), true);
+
+		for(std::size_t i = 0; i != chunk_length; ++i, ++pos)
+		{
+			uint16_t other = static_cast<uint16_t>(name[pos]);
+			if(chunk[i] != other)
+				return chunk[i] < other ? -1 : 1;
+		}
+	}
+
+	return length < name.length() ? -1 : (length > name.length() ? 1 : 0);
+}
+
+//Helper: finds entry with identifier "id" in resource directory at offset "offset_to_directory" (binary search)
+bool find_resource_directory_entry(const pe_base& pe, uint32_t res_rva, uint32_t offset_to_directory, const resource_id& id, image_resource_directory_entry& result)
 {
-	if(named_)
-		return entry.is_named() && entry.get_name() == name_;
-	else
-		return !entry.is_named() && entry.get_id() == id_;
+	if(!pe_utils::is_sum_safe(res_rva, offset_to_directory)
+		|| !pe_utils::is_sum_safe(res_rva + offset_to_directory, sizeof(image_resource_directory)))
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	image_resource_directory directory = pe.section_data_from_rva<image_resource_directory>(res_rva + offset_to_directory, section_data_virtual, true);
+	uint32_t entries_rva = res_rva + offset_to_directory + sizeof(image_resource_directory);
+
+	//Named entries go first, ID entries follow them
+	uint32_t first = id.is_named() ? 0 : directory.NumberOfNamedEntries;
+	uint32_t last = id.is_named() ? directory.NumberOfNamedEntries : static_cast<uint32_t>(directory.NumberOfNamedEntries) + directory.NumberOfIdEntries;
+	if(!pe_utils::is_sum_safe(entries_rva, last * sizeof(image_resource_directory_entry)))
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	u16string name;
+	if(id.is_named())
+	{
+#ifdef PE_BLISS_WINDOWS
+		name = id.get_name();
+#else
+		name = pe_utils::to_ucs2(id.get_name());
+#endif
+	}
+
+	while(first < last)
+	{
+		uint32_t middle = first + (last - first) / 2;
+		image_resource_directory_entry entry = pe.section_data_from_rva<image_resource_directory_entry>(
+			entries_rva + middle * sizeof(image_resource_directory_entry), section_data_virtual, true);
+
+		int compare;
+		if(id.is_named())
+		{
+			if(!entry.NameIsString || !pe_utils::is_sum_safe(res_rva, entry.NameOffset))
+				throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+			compare = compare_resource_name(pe, res_rva + entry.NameOffset, name);
+		}
+		else
+		{
+			compare = entry.Id < id.get_id() ? -1 : (entry.Id > id.get_id() ? 1 : 0);
+		}
+
+		if(!compare)
+		{
+			result = entry;
+			return true;
+		}
+
+		if(compare < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	return false;
+}
+
+//Helper: finds resource data by path, takes first language, if language is zero
+bool find_resource_data(const pe_base& pe, const resource_id& type, const resource_id& name, const uint32_t* language, resource_data_entry& entry)
+{
+	if(!pe.has_resources())
+		return false;
+
+	uint32_t res_rva = pe.get_directory_rva(image_directory_entry_resource);
+
+	//Type and name entries must have subdirectories
+	image_resource_directory_entry dir_entry;
+	if(!find_resource_directory_entry(pe, res_rva, 0, type, dir_entry) || !dir_entry.DataIsDirectory
+		|| !find_resource_directory_entry(pe, res_rva, dir_entry.OffsetToDirectory, name, dir_entry) || !dir_entry.DataIsDirectory)
+		return false;
+
+	if(language)
+	{
+		if(!find_resource_directory_entry(pe, res_rva, dir_entry.OffsetToDirectory, resource_id(*language), dir_entry))
+			return false;
+	}
+	else
+	{
+		uint32_t offset_to_directory = dir_entry.OffsetToDirectory;
+		if(!pe_utils::is_sum_safe(res_rva, offset_to_directory)
+			|| !pe_utils::is_sum_safe(res_rva + offset_to_directory, sizeof(image_resource_directory) + sizeof(image_resource_directory_entry)))
+			throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+		image_resource_directory directory = pe.section_data_from_rva<image_resource_directory>(res_rva + offset_to_directory, section_data_virtual, true);
+		if(!directory.NumberOfNamedEntries && !directory.NumberOfIdEntries)
+			return false;
+
+		dir_entry = pe.section_data_from_rva<image_resource_directory_entry>(res_rva + offset_to_directory + sizeof(image_resource_directory), section_data_virtual, true);
+	}
+
+	//Language entry must have data
+	if(dir_entry.DataIsDirectory)
+		return false;
+
+	if(!pe_utils::is_sum_safe(res_rva, dir_entry.OffsetToData))
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	image_resource_data_entry data_entry = pe.section_data_from_rva<image_resource_data_entry>(res_rva + dir_entry.OffsetToData, section_data_virtual, true);
+
+	//Check byte count that stated by data entry
+	if(pe.section_data_length_from_rva(data_entry.OffsetToData, data_entry.OffsetToData, section_data_virtual, true) < data_entry.Size)
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	entry = resource_data_entry(pe, data_entry.OffsetToData, data_entry.Size, data_entry.CodePage);
+	return true;
+}
+
+//Finds resource data by path (type, name, language) directly in resource directory of image without parsing it
+bool find_resource(const pe_base& pe, const resource_id& type, const resource_id& name, uint32_t language, resource_data_entry& entry)
+{
+	return find_resource_data(pe, type, name, &language, entry);
+}
+
+//Finds resource data of first language of resource
+bool find_resource(const pe_base& pe, const resource_id& type, const resource_id& name, resource_data_entry& entry)
+{
+	return find_resource_data(pe, type, name, 0, entry);
+}
+
+//Default constructor
+flat_resource_directory::flat_resource_directory()
+{
+	clear();
+}
+
+//Helper: child of resource directory, which is added to flat resource directory
+struct flat_resource_child
+{
+	flat_resource_child()
+		:id(0), named(false), entry(0)
+	{}
+
+	bool operator<(const flat_resource_child& other) const
+	{
+		if(named != other.named)
+			return named;
+
+		return named ? name < other.name : id < other.id;
+	}
+
+	u16string name;
+	uint32_t id;
+	bool named;
+
+	//Entry of resource directory tree
+	const resource_directory_entry* entry;
+	//Entry of image resource directory
+	image_resource_directory_entry image_entry;
+};
+
+//Helper: converts name to UTF-16
+u16string to_resource_name(const std::wstring& name)
+{
+#ifdef PE_BLISS_WINDOWS
+	return name;
+#else
+	return pe_utils::to_ucs2(name);
+#endif
+}
+
+//Constructor from resource directory tree
+flat_resource_directory::flat_resource_directory(const resource_directory& root)
+{
+	clear();
+
+	//Directories are added level by level, so children of each directory are contiguous
+	std::deque<std::pair<const resource_directory*, uint32_t> > directories;
+	directories.push_back(std::make_pair(&root, 0u));
+
+	std::vector<flat_resource_child> children;
+	while(!directories.empty())
+	{
+		const resource_directory& dir = *directories.front().first;
+		uint32_t index = directories.front().second;
+		directories.pop_front();
+
+		set_directory(index, dir.get_characteristics(), dir.get_timestamp(), dir.get_major_version(), dir.get_minor_version());
+
+		const resource_directory::entry_list& entries = dir.get_entry_list();
+		children.resize(entries.size());
+		for(std::size_t i = 0; i != entries.size(); ++i)
+		{
+			flat_resource_child& child = children[i];
+			child.entry = &entries[i];
+			child.named = entries[i].is_named();
+			child.id = entries[i].get_id();
+			child.name = child.named ? to_resource_name(entries[i].get_name()) : u16string();
+		}
+
+		std::stable_sort(children.begin(), children.end());
+
+		uint32_t first = add_children(index, static_cast<uint32_t>(children.size()));
+		for(uint32_t i = 0; i != children.size(); ++i)
+		{
+			const flat_resource_child& child = children[i];
+			if(child.named)
+			{
+				if(child.name.length() > pe_utils::max_word)
+					throw pe_exception("Too long resource name", pe_exception::incorrect_resource_directory);
+
+				set_name(first + i, child.name.data(), static_cast<uint16_t>(child.name.length()));
+			}
+			else
+			{
+				set_id(first + i, child.id);
+			}
+
+			if(child.entry->includes_data())
+			{
+				const resource_data_entry& data = child.entry->get_data_entry();
+				set_data(first + i, data.get_data().data(), static_cast<uint32_t>(data.get_data().length()), data.get_codepage());
+			}
+			else
+			{
+				directories.push_back(std::make_pair(&child.entry->get_resource_directory(), first + i));
+			}
+		}
+	}
+}
+
+//Returns number of nodes (including root)
+uint32_t flat_resource_directory::get_node_count() const
+{
+	return static_cast<uint32_t>(nodes_.size());
+}
+
+//Returns node by index, checks index
+const flat_resource_directory::node& flat_resource_directory::get_node(uint32_t index) const
+{
+	if(index >= nodes_.size())
+		throw pe_exception("Resource directory entry not found", pe_exception::resource_directory_entry_not_found);
+
+	return nodes_[index];
+}
+
+//Returns node by index, checks index
+flat_resource_directory::node& flat_resource_directory::get_node(uint32_t index)
+{
+	if(index >= nodes_.size())
+		throw pe_exception("Resource directory entry not found", pe_exception::resource_directory_entry_not_found);
+
+	return nodes_[index];
+}
+
+//Returns directory node by index, checks type of node
+const flat_resource_directory::node& flat_resource_directory::get_directory_node(uint32_t index) const
+{
+	const node& ret = get_node(index);
+	if(ret.flags & node_data)
+		throw pe_exception("Resource directory entry does not contain resource directory", pe_exception::resource_directory_entry_error);
+
+	return ret;
+}
+
+//Returns data node by index, checks type of node
+const flat_resource_directory::node& flat_resource_directory::get_data_node(uint32_t index) const
+{
+	const node& ret = get_node(index);
+	if(!(ret.flags & node_data))
+		throw pe_exception("Resource directory entry does not contain resource data entry", pe_exception::resource_directory_entry_error);
+
+	return ret;
+}
+
+//Returns true if node includes data, false if node is directory
+bool flat_resource_directory::includes_data(uint32_t index) const
+{
+	return (get_node(index).flags & node_data) != 0;
+}
+
+//Returns true if node has name, false if it has ID
+bool flat_resource_directory::is_named(uint32_t index) const
+{
+	return (get_node(index).flags & node_named) != 0;
+}
+
+//Returns ID of node
+uint32_t flat_resource_directory::get_id(uint32_t index) const
+{
+	const node& n = get_node(index);
+	return (n.flags & node_named) ? 0 : n.id;
+}
+
+//Returns name of node
+std::wstring flat_resource_directory::get_name(uint32_t index) const
+{
+	const node& n = get_node(index);
+	if(!(n.flags & node_named))
+		return std::wstring();
+
+#ifdef PE_BLISS_WINDOWS
+	return std::wstring(names_.data() + n.id, n.name_length);
+#else
+	return pe_utils::from_ucs2(names_.substr(n.id, n.name_length));
+#endif
+}
+
+//Returns pointer to UTF-16 name of node inside of name pool
+const unicode16_t* flat_resource_directory::get_name_data(uint32_t index) const
+{
+	const node& n = get_node(index);
+	return (n.flags & node_named) ? names_.data() + n.id : 0;
+}
+
+//Returns length of name of node (in UTF-16 characters)
+uint16_t flat_resource_directory::get_name_length(uint32_t index) const
+{
+	return get_node(index).name_length;
+}
+
+//Returns index of the first child of directory
+uint32_t flat_resource_directory::get_first_child(uint32_t index) const
+{
+	return get_directory_node(index).first;
+}
+
+//Returns number of children of directory
+uint32_t flat_resource_directory::get_child_count(uint32_t index) const
+{
+	return get_directory_node(index).count;
+}
+
+//Returns characteristics of directory
+uint32_t flat_resource_directory::get_characteristics(uint32_t index) const
+{
+	return get_directory_node(index).codepage;
+}
+
+//Returns date and time stamp of directory
+uint32_t flat_resource_directory::get_timestamp(uint32_t index) const
+{
+	return get_directory_node(index).timestamp;
+}
+
+//Returns major version of directory
+uint16_t flat_resource_directory::get_major_version(uint32_t index) const
+{
+	return get_directory_node(index).major_version;
+}
+
+//Returns minor version of directory
+uint16_t flat_resource_directory::get_minor_version(uint32_t index) const
+{
+	return get_directory_node(index).minor_version;
+}
+
+//Returns codepage of data
+uint32_t flat_resource_directory::get_codepage(uint32_t index) const
+{
+	return get_data_node(index).codepage;
+}
+
+//Returns size of data
+uint32_t flat_resource_directory::get_data_size(uint32_t index) const
+{
+	return get_data_node(index).count;
+}
+
+//Returns pointer to data inside of data pool
+const char* flat_resource_directory::get_data_ptr(uint32_t index) const
+{
+	return data_.data() + get_data_node(index).first;
+}
+
+//Returns copy of data
+std::string flat_resource_directory::get_data(uint32_t index) const
+{
+	const node& n = get_data_node(index);
+	return data_.substr(n.first, n.count);
+}
+
+//Compares names of nodes (returns negative value, zero or positive value)
+int flat_resource_directory::compare_names(const node& first, const unicode16_t* name, std::size_t length) const
+{
+	const unicode16_t* first_name = names_.data() + first.id;
+	for(std::size_t i = 0; i != first.name_length && i != length; ++i)
+	{
+		if(first_name[i] != name[i])
+			return static_cast<uint16_t>(first_name[i]) < static_cast<uint16_t>(name[i]) ? -1 : 1;
+	}
+
+	return first.name_length < length ? -1 : (first.name_length > length ? 1 : 0);
+}
+
+//Finds child of directory "directory" with identifier "id"
+bool flat_resource_directory::find_child(uint32_t directory, const resource_id& id, uint32_t& child) const
+{
+	const node& dir = get_directory_node(directory);
+	u16string name(id.is_named() ? to_resource_name(id.get_name()) : u16string());
+
+	//Named children go first, ID children follow them
+	uint32_t first = dir.first, last = dir.first + dir.count;
+	while(first < last)
+	{
+		uint32_t middle = first + (last - first) / 2;
+		const node& n = nodes_[middle];
+
+		int compare;
+		if(((n.flags & node_named) != 0) != id.is_named())
+			compare = (n.flags & node_named) ? -1 : 1;
+		else if(id.is_named())
+			compare = compare_names(n, name.data(), name.length());
+		else
+			compare = n.id < id.get_id() ? -1 : (n.id > id.get_id() ? 1 : 0);
+
+		if(!compare)
+		{
+			child = middle;
+			return true;
+		}
+
+		if(compare < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	return false;
+}
+
+//Finds data node by path (type, name, language)
+bool flat_resource_directory::find_data(const resource_id& type, const resource_id& name, uint32_t language, uint32_t& data) const
+{
+	uint32_t type_index, name_index;
+	return find_child(0, type, type_index) && !includes_data(type_index)
+		&& find_child(type_index, name, name_index) && !includes_data(name_index)
+		&& find_child(name_index, language, data) && includes_data(data);
+}
+
+//Returns resource directory tree
+resource_directory flat_resource_directory::to_resource_directory() const
+{
+	resource_directory ret;
+
+	//Entries of directory are added before their subdirectories are filled,
+	//subdirectories are owned by entries through pointers, so references to them stay valid
+	std::vector<std::pair<uint32_t, resource_directory*> > directories;
+	directories.push_back(std::make_pair(0u, &ret));
+	while(!directories.empty())
+	{
+		uint32_t index = directories.back().first;
+		resource_directory& dir = *directories.back().second;
+		directories.pop_back();
+
+		const node& n = nodes_[index];
+		dir.set_characteristics(n.codepage);
+		dir.set_timestamp(n.timestamp);
+		dir.set_major_version(n.major_version);
+		dir.get_minor_version(n.minor_version);
+
+		for(uint32_t i = n.first; i != n.first + n.count; ++i)
+		{
+			resource_directory_entry entry;
+			if(nodes_[i].flags & node_named)
+				entry.set_name(get_name(i));
+			else
+				entry.set_id(nodes_[i].id);
+
+			if(nodes_[i].flags & node_data)
+				entry.add_data_entry(resource_data_entry(get_data(i), nodes_[i].codepage));
+			else
+				entry.add_resource_directory(resource_directory());
+
+			dir.add_resource_directory_entry(entry);
+		}
+
+		for(uint32_t i = 0; i != n.count; ++i)
+		{
+			if(!(nodes_[n.first + i].flags & node_data))
+				directories.push_back(std::make_pair(n.first + i, &dir.get_entry_list()[i].get_resource_directory()));
+		}
+	}
+
+	return ret;
+}
+
+//Exchanges contents of two directories
+void flat_resource_directory::swap(flat_resource_directory& other)
+{
+	nodes_.swap(other.nodes_);
+	names_.swap(other.names_);
+	data_.swap(other.data_);
+}
+
+//Removes all nodes except empty root
+void flat_resource_directory::clear()
+{
+	nodes_.clear();
+	names_.clear();
+	data_.clear();
+
+	node root = {0};
+	nodes_.push_back(root);
+}
+
+//Sets properties of directory
+void flat_resource_directory::set_directory(uint32_t index, uint32_t characteristics, uint32_t timestamp, uint16_t major_version, uint16_t minor_version)
+{
+	node& n = get_node(index);
+	n.codepage = characteristics;
+	n.timestamp = timestamp;
+	n.major_version = major_version;
+	n.minor_version = minor_version;
+}
+
+//Adds "count" nodes, which will be children of directory "directory", returns index of the first one
+uint32_t flat_resource_directory::add_children(uint32_t directory, uint32_t count)
+{
+	if(nodes_.size() > pe_utils::max_dword - count)
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	node& dir = get_node(directory);
+	dir.flags &= ~node_data;
+	dir.first = static_cast<uint32_t>(nodes_.size());
+	dir.count = count;
+
+	node child = {0};
+	nodes_.resize(nodes_.size() + count, child);
+	return static_cast<uint32_t>(nodes_.size()) - count;
+}
+
+//Sets ID of node
+void flat_resource_directory::set_id(uint32_t index, uint32_t id)
+{
+	node& n = get_node(index);
+	n.id = id;
+	n.name_length = 0;
+	n.flags &= ~node_named;
+}
+
+//Sets name of node
+void flat_resource_directory::set_name(uint32_t index, const unicode16_t* name, uint16_t length)
+{
+	node& n = get_node(index);
+	if(names_.length() > pe_utils::max_dword - length)
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	n.id = static_cast<uint32_t>(names_.length());
+	n.name_length = length;
+	n.flags |= node_named;
+	names_.append(name, length);
+}
+
+//Sets data of node (node becomes data node)
+void flat_resource_directory::set_data(uint32_t index, const char* data, uint32_t size, uint32_t codepage)
+{
+	node& n = get_node(index);
+	if(data_.length() > pe_utils::max_dword - size)
+		throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+	n.flags |= node_data;
+	n.first = static_cast<uint32_t>(data_.length());
+	n.count = size;
+	n.codepage = codepage;
+	data_.append(data, size);
+}
+
+//Reads resources from PE file to flat representation
+void get_resources(const pe_base& pe, flat_resource_directory& resources)
+{
+	resources.clear();
+	if(!pe.has_resources())
+		return;
+
+	uint32_t res_rva = pe.get_directory_rva(image_directory_entry_resource);
+
+	//Store already processed directories to avoid resource loops
+	std::set<uint32_t> processed;
+
+	//Directories are read level by level (offset of directory and index of its node), so children of each directory are contiguous
+	std::deque<std::pair<uint32_t, uint32_t> > directories;
+	directories.push_back(std::make_pair(0u, 0u));
+
+	std::vector<flat_resource_child> children;
+	while(!directories.empty())
+	{
+		uint32_t offset_to_directory = directories.front().first;
+		uint32_t index = directories.front().second;
+		directories.pop_front();
+
+		//Check for resource loops
+		if(!processed.insert(offset_to_directory).second)
+			throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+		if(!pe_utils::is_sum_safe(res_rva, offset_to_directory))
+			throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+		image_resource_directory directory = pe.section_data_from_rva<image_resource_directory>(res_rva + offset_to_directory, section_data_virtual, true);
+		resources.set_directory(index, directory.Characteristics, directory.TimeDateStamp, directory.MajorVersion, directory.MinorVersion);
+
+		uint32_t count = static_cast<uint32_t>(directory.NumberOfIdEntries) + directory.NumberOfNamedEntries;
+		if(!pe_utils::is_sum_safe(offset_to_directory, sizeof(image_resource_directory) + count * sizeof(image_resource_directory_entry))
+			|| !pe_utils::is_sum_safe(res_rva, offset_to_directory + sizeof(image_resource_directory) + count * sizeof(image_resource_directory_entry)))
+			throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+		children.resize(count);
+		for(uint32_t i = 0; i != count; ++i)
+		{
+			flat_resource_child& child = children[i];
+			child.image_entry = pe.section_data_from_rva<image_resource_directory_entry>(
+				res_rva + offset_to_directory + sizeof(image_resource_directory) + i * sizeof(image_resource_directory_entry), section_data_virtual, true);
+
+			child.named = child.image_entry.NameIsString != 0;
+			child.id = child.named ? 0 : child.image_entry.Id;
+			child.name.clear();
+			if(child.named)
+			{
+				uint32_t name_rva = res_rva + child.image_entry.NameOffset;
+				if(!pe_utils::is_sum_safe(res_rva + sizeof(uint16_t), child.image_entry.NameOffset))
+					throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+				uint16_t name_length = pe.section_data_from_rva<uint16_t>(name_rva, section_data_virtual, true);
+				if(pe.section_data_length_from_rva(name_rva + sizeof(uint16_t), name_rva + sizeof(uint16_t), section_data_virtual, true) < name_length * sizeof(uint16_t))
+					throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+				child.name.resize(name_length);
+				if(name_length)
+					pe.read_data_from_rva(name_rva + sizeof(uint16_t), reinterpret_cast<char*>(&child.name[0]), name_length * sizeof(uint16_t), true);
+			}
+		}
+
+		//Entries of image can be unsorted
+		std::stable_sort(children.begin(), children.end());
+
+		uint32_t first = resources.add_children(index, count);
+		for(uint32_t i = 0; i != count; ++i)
+		{
+			const flat_resource_child& child = children[i];
+			if(child.named)
+				resources.set_name(first + i, child.name.data(), static_cast<uint16_t>(child.name.length()));
+			else
+				resources.set_id(first + i, child.id);
+
+			if(child.image_entry.DataIsDirectory)
+			{
+				directories.push_back(std::make_pair(static_cast<uint32_t>(child.image_entry.OffsetToDirectory), first + i));
+			}
+			else
+			{
+				if(!pe_utils::is_sum_safe(res_rva, child.image_entry.OffsetToData))
+					throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+				image_resource_data_entry data_entry = pe.section_data_from_rva<image_resource_data_entry>(
+					res_rva + child.image_entry.OffsetToData, section_data_virtual, true);
+
+				//Check byte count that stated by data entry
+				if(pe.section_data_length_from_rva(data_entry.OffsetToData, data_entry.OffsetToData, section_data_virtual, true) < data_entry.Size)
+					throw pe_exception("Incorrect resource directory", pe_exception::incorrect_resource_directory);
+
+				//Data is copied to data pool directly from section, if it is inside of raw section data
+				if(!data_entry.Size || pe.section_data_length_from_rva(data_entry.OffsetToData, data_entry.OffsetToData, section_data_raw, true) >= data_entry.Size)
+				{
+					resources.set_data(first + i, data_entry.Size ? pe.section_data_from_rva(data_entry.OffsetToData, section_data_raw, true) : 0, data_entry.Size, data_entry.CodePage);
+				}
+				else
+				{
+					std::string data(data_entry.Size, 0);
+					pe.read_data_from_rva(data_entry.OffsetToData, &data[0], data_entry.Size, true);
+					resources.set_data(first + i, data.data(), data_entry.Size, data_entry.CodePage);
+				}
+			}
+		}
+	}
+}
+
+//Finds resource_directory_entry by ID
+resource_directory::id_entry_finder::id_entry_finder(uint32_t id)
+	:id_(id)
+{}
+
+bool resource_directory::id_entry_finder::operator()(const resource_directory_entry& entry) const
+{
+	return !entry.is_named() && entry.get_id() == id_;
+}
+
+//Finds resource_directory_entry by name
+resource_directory::name_entry_finder::name_entry_finder(const std::wstring& name)
+	:name_(name)
+{}
+
+bool resource_directory::name_entry_finder::operator()(const resource_directory_entry& entry) const
+{
+	return entry.is_named() && entry.get_name() == name_;
+}
+
+//Finds resource_directory_entry by name or ID (universal)
+resource_directory::entry_finder::entry_finder(const std::wstring& name)
+	:name_(name), named_(true)
+{}
+
+resource_directory::entry_finder::entry_finder(uint32_t id)
+	:id_(id), named_(false)
+{}
+
+bool resource_directory::entry_finder::operator()(const resource_directory_entry& entry) const
+{
+	if(named_)
+		return entry.is_named() && entry.get_name() == name_;
+	else
+		return !entry.is_named() && entry.get_id() == id_;
+}
+
+//Searches for entry by name or ID, returns false if not found
+bool resource_directory::find_entry(const entry_finder& finder, std::size_t& index)
+{
+	//Small directories are faster to scan
+	if(entries_.size() < min_indexed_entries)
+	{
+		entry_list::const_iterator it = std::find_if(entries_.begin(), entries_.end(), finder);
+		if(it == entries_.end())
+			return false;
+
+		index = it - entries_.begin();
+		return true;
+	}
+
+	if(!index_valid_)
+		build_index();
+
+	if(finder.named_)
+	{
+		std::map<std::wstring, std::size_t>::const_iterator it = named_index_.find(finder.name_);
+		if(it == named_index_.end())
+			return false;
+
+		index = (*it).second;
+	}
+	else
+	{
+		std::map<uint32_t, std::size_t>::const_iterator it = id_index_.find(finder.id_);
+		if(it == id_index_.end())
+			return false;
+
+		index = (*it).second;
+	}
+
+	return true;
+}
+
+//Returns entry by its position in entry list
+resource_directory_entry& resource_directory::get_entry(std::size_t index)
+{
+	if(index >= entries_.size())
+		throw pe_exception("Resource directory entry not found", pe_exception::resource_directory_entry_not_found);
+
+	return entries_[index];
+}
+
+//Removes entry by its position in entry list
+void resource_directory::remove_entry(std::size_t index)
+{
+	if(index >= entries_.size())
+		throw pe_exception("Resource directory entry not found", pe_exception::resource_directory_entry_not_found);
+
+	const resource_directory_entry& entry = entries_[index];
+	if(entry.is_named())
+	{
+		if(number_of_named_entries_)
+			--number_of_named_entries_;
+	}
+	else
+	{
+		if(number_of_id_entries_)
+			--number_of_id_entries_;
+	}
+
+	if(index_valid_)
+	{
+		//Other entry with the same name or ID would have to be indexed instead of removed one
+		if(index_has_duplicates_)
+		{
+			reset_index();
+		}
+		else
+		{
+			if(entry.is_named())
+				named_index_.erase(entry.get_name());
+			else
+				id_index_.erase(entry.get_id());
+
+			//Entries after removed one are shifted
+			for(std::map<std::wstring, std::size_t>::iterator it = named_index_.begin(); it != named_index_.end(); ++it)
+			{
+				if((*it).second > index)
+					--(*it).second;
+			}
+
+			for(std::map<uint32_t, std::size_t>::iterator it = id_index_.begin(); it != id_index_.end(); ++it)
+			{
+				if((*it).second > index)
+					--(*it).second;
+			}
+		}
+	}
+
+	entries_.erase(entries_.begin() + index);
+}
+
+//Builds entry index
+void resource_directory::build_index()
+{
+	reset_index();
+	for(std::size_t i = 0; i != entries_.size(); ++i)
+		add_to_index(entries_[i], i);
+
+	index_valid_ = true;
+}
+
+//Adds entry at position "index" to entry index
+void resource_directory::add_to_index(const resource_directory_entry& entry, std::size_t index)
+{
+	bool inserted = entry.is_named()
+		? named_index_.insert(std::make_pair(entry.get_name(), index)).second
+		: id_index_.insert(std::make_pair(entry.get_id(), index)).second;
+
+	if(!inserted)
+		index_has_duplicates_ = true;
+}
+
+//Drops entry index
+void resource_directory::reset_index()
+{
+	named_index_.clear();
+	id_index_.clear();
+	index_valid_ = false;
+	index_has_duplicates_ = false;
 }
 
 //Returns resource_directory_entry by ID. If not found - throws an exception
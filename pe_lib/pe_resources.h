@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
 #include "pe_structures.h"
 #include "pe_base.h"
 #include "pe_directory.h"
@@ -16,23 +17,61 @@ public:
 	resource_data_entry();
 	//Constructor from data
 	resource_data_entry(const std::string& data, uint32_t codepage);
+	//Constructor of entry, which references "size" bytes of data at RVA "rva" of image "pe"
+	//Data is read from image on first get_data() call, image and its resource data must not be changed or destroyed before that
+	resource_data_entry(const pe_base& pe, uint32_t rva, uint32_t size, uint32_t codepage);
+	//Copy constructor
+	resource_data_entry(const resource_data_entry& other);
+	//Copy assignment operator
+	resource_data_entry& operator=(const resource_data_entry& other);
+	//Destructor
+	~resource_data_entry();
+
+#ifdef PE_BLISS_MOVE_SEMANTICS
+	//Move constructor
+	resource_data_entry(resource_data_entry&& other) PE_BLISS_NOEXCEPT;
+	//Move assignment operator
+	resource_data_entry& operator=(resource_data_entry&& other) PE_BLISS_NOEXCEPT;
+#endif
+
+	//Exchanges contents of two entries
+	void swap(resource_data_entry& other);
 
 	//Returns resource data codepage
 	uint32_t get_codepage() const;
 	//Returns resource data
+	//Data of entry, which references image, is read on first call (this can be done from several threads)
 	const std::string& get_data() const;
+	//Returns size of resource data (data is not read)
+	uint32_t get_size() const;
+	//Returns true if entry references image data
+	bool references_image() const;
+	//Returns RVA of resource data inside of image, if entry references image data (otherwise zero)
+	uint32_t get_rva() const;
+	//Returns view of resource data, which doesn't copy it
+	//View of data referenced in image points to section data and is valid while section data is not changed
+	section_data_view get_data_view() const;
 		
 public: //These functions do not change everything inside image, they are used by PE class
 	//You can also use them to rebuild resource directory
 		
 	//Sets resource data codepage
 	void set_codepage(uint32_t codepage);
-	//Sets resource data
+	//Sets resource data (entry doesn't reference image data anymore)
 	void set_data(const std::string& data);
 
 private:
 	uint32_t codepage_; //Resource data codepage
 	std::string data_; //Resource data
+
+	//Referenced image data
+	const pe_base* pe_;
+	uint32_t rva_, size_;
+	//Data read from image (set once)
+	mutable std::string* volatile image_data_;
+
+	//Destroys data read from image
+	void release();
 };
 
 //Forward declaration
@@ -49,6 +88,16 @@ public:
 	//Copy assignment operator
 	resource_directory_entry& operator=(const resource_directory_entry& other);
 
+#ifdef PE_BLISS_MOVE_SEMANTICS
+	//Move constructor (included data is not copied)
+	resource_directory_entry(resource_directory_entry&& other) PE_BLISS_NOEXCEPT;
+	//Move assignment operator (included data is not copied)
+	resource_directory_entry& operator=(resource_directory_entry&& other) PE_BLISS_NOEXCEPT;
+#endif
+
+	//Exchanges contents of two entries without copying included data
+	void swap(resource_directory_entry& other);
+
 	//Returns entry ID
 	uint32_t get_id() const;
 	//Returns entry name
@@ -162,8 +211,24 @@ public: //These functions do not change everything inside image, they are used b
 	void get_minor_version(uint16_t minor_version);
 		
 	//Returns resource_directory_entry array
+	//Entry index of directory is dropped, because entries may be changed through returned reference
 	entry_list& get_entry_list();
 
+public: //Indexed editing, used by resource manager
+	struct entry_finder;
+
+	//Searches for entry by name or ID, returns false if not found
+	//"index" is set to position of entry in entry list
+	//Directories with many entries are searched by index, which is built on first search
+	//and is kept up to date by add_resource_directory_entry and remove_entry
+	//This function is not const and must not be called from several threads at the same time
+	bool find_entry(const entry_finder& finder, std::size_t& index);
+	//Returns entry by its position in entry list
+	//Name or ID of returned entry must not be changed, as it is used by entry index
+	resource_directory_entry& get_entry(std::size_t index);
+	//Removes entry by its position in entry list
+	void remove_entry(std::size_t index);
+
 private:
 	uint32_t characteristics_;
 	uint32_t timestamp_;
@@ -171,6 +236,24 @@ private:
 	uint32_t number_of_named_entries_, number_of_id_entries_;
 	entry_list entries_;
 
+	//Entry index: positions of entries in entry list by name and by ID
+	//Only first of entries with the same name or ID is indexed
+	std::map<std::wstring, std::size_t> named_index_;
+	std::map<uint32_t, std::size_t> id_index_;
+	bool index_valid_;
+	//True if entry list contains entries with the same name or ID
+	bool index_has_duplicates_;
+
+	//Directories with less entries are searched without index
+	static const std::size_t min_indexed_entries = 16;
+
+	//Builds entry index
+	void build_index();
+	//Adds entry at position "index" to entry index
+	void add_to_index(const resource_directory_entry& entry, std::size_t index);
+	//Drops entry index
+	void reset_index();
+
 public: //Finder helpers
 	//Finds resource_directory_entry by ID
 	struct id_entry_finder
@@ -203,14 +286,170 @@ public: //Finder helpers
 		bool operator()(const resource_directory_entry& entry) const;
 
 	private:
+		friend class resource_directory;
+
 		std::wstring name_;
 		uint32_t id_;
 		bool named_;
 	};
 };
 
+//Identifier of resource directory entry: ID or name
+class resource_id
+{
+public:
+	//Constructor from ID
+	resource_id(uint32_t id);
+	//Constructors from name
+	resource_id(const std::wstring& name);
+	resource_id(const wchar_t* name);
+
+	//Returns true, if identifier is name
+	bool is_named() const;
+	//Returns ID
+	uint32_t get_id() const;
+	//Returns name
+	const std::wstring& get_name() const;
+
+private:
+	uint32_t id_;
+	std::wstring name_;
+	bool named_;
+};
+
+//Compact resource directory representation
+//All directories and data entries are nodes of one contiguous array, node 0 is root directory
+//Children of each directory are a contiguous range of nodes, sorted like in image
+//(named entries by name, then ID entries by ID), so they are binary searched
+//Entry names are kept in one UTF-16 name pool, resource data is kept in one data pool,
+//so copying the directory copies three contiguous blocks
+class flat_resource_directory
+{
+public:
+	//Default constructor (empty root directory)
+	flat_resource_directory();
+	//Constructor from resource directory tree
+	explicit flat_resource_directory(const resource_directory& root);
+
+	//Returns number of nodes (including root)
+	uint32_t get_node_count() const;
+
+public: //Node properties
+	//Returns true if node includes data, false if node is directory
+	bool includes_data(uint32_t index) const;
+	//Returns true if node has name, false if it has ID
+	bool is_named(uint32_t index) const;
+	//Returns ID of node
+	uint32_t get_id(uint32_t index) const;
+	//Returns name of node
+	std::wstring get_name(uint32_t index) const;
+	//Returns pointer to UTF-16 name of node inside of name pool (name is not null-terminated)
+	const unicode16_t* get_name_data(uint32_t index) const;
+	//Returns length of name of node (in UTF-16 characters)
+	uint16_t get_name_length(uint32_t index) const;
+
+public: //Directory properties
+	//Returns index of the first child of directory
+	uint32_t get_first_child(uint32_t index) const;
+	//Returns number of children of directory
+	uint32_t get_child_count(uint32_t index) const;
+	//Returns characteristics of directory
+	uint32_t get_characteristics(uint32_t index) const;
+	//Returns date and time stamp of directory
+	uint32_t get_timestamp(uint32_t index) const;
+	//Returns major version of directory
+	uint16_t get_major_version(uint32_t index) const;
+	//Returns minor version of directory
+	uint16_t get_minor_version(uint32_t index) const;
+
+public: //Data properties
+	//Returns codepage of data
+	uint32_t get_codepage(uint32_t index) const;
+	//Returns size of data
+	uint32_t get_data_size(uint32_t index) const;
+	//Returns pointer to data inside of data pool
+	const char* get_data_ptr(uint32_t index) const;
+	//Returns copy of data
+	std::string get_data(uint32_t index) const;
+
+public: //Searching
+	//Finds child of directory "directory" with identifier "id"
+	//Returns true and saves index of found node to "child", if child was found
+	bool find_child(uint32_t directory, const resource_id& id, uint32_t& child) const;
+	//Finds data node by path (type, name, language)
+	bool find_data(const resource_id& type, const resource_id& name, uint32_t language, uint32_t& data) const;
+
+	//Returns resource directory tree
+	resource_directory to_resource_directory() const;
+
+	//Exchanges contents of two directories
+	void swap(flat_resource_directory& other);
+
+public: //Setters, they are used by resource parser
+	//Removes all nodes except empty root
+	void clear();
+	//Sets properties of directory
+	void set_directory(uint32_t index, uint32_t characteristics, uint32_t timestamp, uint16_t major_version, uint16_t minor_version);
+	//Adds "count" nodes, which will be children of directory "directory", returns index of the first one
+	//Children must be set in sorted order (named nodes by name, then ID nodes by ID)
+	uint32_t add_children(uint32_t directory, uint32_t count);
+	//Sets ID of node
+	void set_id(uint32_t index, uint32_t id);
+	//Sets name of node
+	void set_name(uint32_t index, const unicode16_t* name, uint16_t length);
+	//Sets data of node (node becomes data node)
+	void set_data(uint32_t index, const char* data, uint32_t size, uint32_t codepage);
+
+private:
+	//Node flags
+	enum
+	{
+		node_named = 1,
+		node_data = 2
+	};
+
+	//Node (directory or data entry)
+	struct node
+	{
+		uint32_t id; //ID or offset of name in name pool
+		uint16_t name_length;
+		uint16_t flags;
+		uint32_t first; //Index of first child or offset of data in data pool
+		uint32_t count; //Number of children or size of data
+		uint32_t codepage; //Codepage of data or characteristics of directory
+		uint32_t timestamp;
+		uint16_t major_version, minor_version;
+	};
+
+	std::vector<node> nodes_;
+	u16string names_;
+	std::string data_;
+
+	//Returns node by index, checks index
+	const node& get_node(uint32_t index) const;
+	node& get_node(uint32_t index);
+	//Returns directory node by index, checks type of node
+	const node& get_directory_node(uint32_t index) const;
+	//Returns data node by index, checks type of node
+	const node& get_data_node(uint32_t index) const;
+
+	//Compares names of nodes (returns negative value, zero or positive value)
+	int compare_names(const node& first, const unicode16_t* name, std::size_t length) const;
+};
+
+//Finds resource data by path (type, name, language) directly in resource directory of image without parsing it
+//Entries of each directory are sorted (named entries by name, then ID entries by ID), so each level is binary searched
+//Returns true and data entry, which references image data (see resource_data_entry), if resource was found
+bool find_resource(const pe_base& pe, const resource_id& type, const resource_id& name, uint32_t language, resource_data_entry& entry);
+//Finds resource data of first language of resource
+bool find_resource(const pe_base& pe, const resource_id& type, const resource_id& name, resource_data_entry& entry);
+
 //Returns resources (root resource_directory) from PE file
-const resource_directory get_resources(const pe_base& pe);
+//If read_data = false, resource data is not copied: data entries reference image data (see resource_data_entry)
+//and read it on first use, so image must exist and must not be changed while they are used
+resource_directory get_resources(const pe_base& pe, bool read_data = true);
+//Reads resources from PE file to flat representation, previous contents of "resources" are removed
+void get_resources(const pe_base& pe, flat_resource_directory& resources);
 
 //Resources rebuilder
 //resource_directory - root resource directory
@@ -220,5 +459,7 @@ const resource_directory get_resources(const pe_base& pe);
 //save_to_pe_headers - if true, new resource directory information will be saved to PE image headers
 //auto_strip_last_section - if true and resources are placed in the last section, it will be automatically stripped
 //number_of_id_entries and number_of_named_entries for resource directories are recalculated and not used
-const image_directory rebuild_resources(pe_base& pe, resource_directory& info, section& resources_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+//deduplicate - if true, identical data (compared by MD5 and then by contents) and identical names are stored once,
+//entries with the same data and codepage share data entry structure, and layout is planned by one pass over the tree
+image_directory rebuild_resources(pe_base& pe, resource_directory& info, section& resources_section, uint32_t offset_from_section_start = 0, bool save_to_pe_header = true, bool auto_strip_last_section = true, bool deduplicate = false);
 }
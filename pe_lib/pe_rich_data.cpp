@@ -40,7 +40,7 @@ void rich_data::set_times(uint32_t times)
 }
 
 //Returns MSVC rich data
-const rich_data_list get_rich_data(const pe_base& pe)
+rich_data_list get_rich_data(const pe_base& pe)
 {
 	//Returned value
 	rich_data_list ret;
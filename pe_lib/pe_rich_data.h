@@ -33,5 +33,5 @@ private:
 typedef std::vector<rich_data> rich_data_list;
 
 //Returns a vector with rich data (stub overlay)
-const rich_data_list get_rich_data(const pe_base& pe);
+rich_data_list get_rich_data(const pe_base& pe);
 }
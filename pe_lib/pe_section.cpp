@@ -1,6 +1,9 @@
 #include <string.h>
+#include <algorithm>
 #include "utils.h"
+#include "pe_exception.h"
 #include "pe_section.h"
+#include "pe_threads.h"
 
 namespace pe_bliss
 {
@@ -8,11 +11,86 @@ using namespace pe_win;
 
 //Section structure default constructor
 section::section()
-	:old_size_(static_cast<size_t>(-1))
+	:old_size_(static_cast<size_t>(-1)), data_(0), data_exposed_(false), source_offset_(0), source_size_(0), views_(0)
 {
 	memset(&header_, 0, sizeof(image_section_header));
 }
 
+//Copy constructor (views are not copied)
+//Section data is not copied, it is shared until one of sections changes it
+section::section(const section& other)
+	:header_(other.header_),
+	old_size_(other.old_size_),
+	data_(0),
+	data_exposed_(false),
+	source_(other.source_),
+	source_offset_(other.source_offset_),
+	source_size_(other.source_size_),
+	views_(0)
+{
+	//Data, which could be changed through returned reference, is copied
+	reset_data(other.data_exposed_ ? new memory_data_source(other.stored_data()) : other.data_);
+}
+
+//Copy assignment operator (views are not copied)
+section& section::operator=(const section& other)
+{
+	if(this != &other)
+	{
+		reset_views();
+		header_ = other.header_;
+		old_size_ = other.old_size_;
+		reset_data(other.data_exposed_ ? new memory_data_source(other.stored_data()) : other.data_);
+		data_exposed_ = false;
+		source_ = other.source_;
+		source_offset_ = other.source_offset_;
+		source_size_ = other.source_size_;
+	}
+
+	return *this;
+}
+
+//Destructor
+section::~section()
+{
+	reset_views();
+	reset_data(0);
+}
+
+#ifdef PE_BLISS_MOVE_SEMANTICS
+//Move constructor
+section::section(section&& other) PE_BLISS_NOEXCEPT
+	:old_size_(static_cast<size_t>(-1)), data_(0), data_exposed_(false), source_offset_(0), source_size_(0), views_(0)
+{
+	memset(&header_, 0, sizeof(image_section_header));
+	swap(other);
+}
+
+//Move assignment operator
+section& section::operator=(section&& other) PE_BLISS_NOEXCEPT
+{
+	swap(other);
+	return *this;
+}
+#endif
+
+//Exchanges contents of two sections without copying section data
+//Views are exchanged together with data, they are immutable copies of it
+void section::swap(section& other)
+{
+	std::swap(header_, other.header_);
+	std::swap(old_size_, other.old_size_);
+	std::swap(data_, other.data_);
+	std::swap(data_exposed_, other.data_exposed_);
+	source_.swap(other.source_);
+	std::swap(source_offset_, other.source_offset_);
+	std::swap(source_size_, other.source_size_);
+
+	data_view* views = views_;
+	views_ = other.views_;
+	other.views_ = views;
+}
+
 //Sets the name of section (8 characters maximum)
 void section::set_name(const std::string& name)
 {
@@ -21,7 +99,7 @@ void section::set_name(const std::string& name)
 }
 
 //Returns section name
-const std::string section::get_name() const
+std::string section::get_name() const
 {
 	char buf[9] = {0};
 	memcpy(buf, header_.Name, 8);
@@ -100,64 +178,282 @@ bool section::discardable() const
 //Returns true if section has no RAW data
 bool section::empty() const
 {
-	if(old_size_ != static_cast<size_t>(-1)) //If virtual memory is mapped, check raw data length (old_size_)
+	if(source_.get()) //If section references data source, check referenced data size
+		return source_size_ == 0;
+	else if(old_size_ != static_cast<size_t>(-1)) //If virtual memory is mapped, check raw data length (old_size_)
 		return old_size_ == 0;
 	else
-		return raw_data_.empty();
+		return stored_data().empty();
 }
 
 //Returns raw section data from file image
 std::string& section::get_raw_data()
 {
+	detach_data_source();
 	unmap_virtual();
-	return raw_data_;
+	reset_views();
+	data_exposed_ = true;
+	return unique_data();
 }
 
 //Sets raw section data from file image
 void section::set_raw_data(const std::string& data)
 {
+	reset_views();
+	source_.reset();
+	old_size_ = static_cast<size_t>(-1);
+	reset_data(new memory_data_source(data));
+	data_exposed_ = false;
+}
+
+//Sets raw section data referencing "size" bytes of "source" from "offset"
+void section::set_raw_data(const data_source_holder& source, uint32_t offset, uint32_t size)
+{
+	if(!source.get() || !pe_utils::is_sum_safe(offset, size) || offset + size > source.get()->get_size())
+		throw pe_exception("Section data is out of data source bounds", pe_exception::image_section_data_not_found);
+
+	reset_views();
 	old_size_ = static_cast<size_t>(-1);
-	raw_data_ = data;
+	reset_data(0);
+	data_exposed_ = false;
+	source_ = source;
+	source_offset_ = offset;
+	source_size_ = size;
 }
 
 //Returns raw section data from file image
 const std::string& section::get_raw_data() const
 {
-	unmap_virtual();
-	return raw_data_;
+	if(!source_.get() && old_size_ == static_cast<size_t>(-1))
+		return stored_data();
+
+	return get_view(0);
 }
 
-//Returns mapped virtual section data
+//Returns virtual section data (raw data, zero-filled to aligned virtual size)
 const std::string& section::get_virtual_data(uint32_t section_alignment) const
 {
-	map_virtual(section_alignment);
-	return raw_data_;
+	//If virtual data is not larger than raw data, it is the same
+	uint32_t aligned_virtual_size = get_aligned_virtual_size(section_alignment);
+	if(!aligned_virtual_size || aligned_virtual_size <= get_raw_data_length())
+		return get_raw_data();
+
+	return get_view(section_alignment);
 }
 
 //Returns mapped virtual section data
 std::string& section::get_virtual_data(uint32_t section_alignment)
 {
+	detach_data_source();
 	map_virtual(section_alignment);
-	return raw_data_;
+	reset_views();
+	data_exposed_ = true;
+	return unique_data();
+}
+
+//Returns view of virtual section data (raw data, zero-filled to aligned virtual size)
+section_data_view section::get_virtual_view(uint32_t section_alignment) const
+{
+	uint32_t raw_length = get_raw_data_length();
+	return section_data_view(get_raw_data_ptr(), raw_length, std::max(raw_length, get_aligned_virtual_size(section_alignment)));
+}
+
+//Returns pointer to raw section data
+//Doesn't copy section data that references data source data in memory
+//Section data is loaded, if data source is not stored in memory
+const char* section::get_raw_data_ptr() const
+{
+	if(source_.get())
+	{
+		if(source_.get()->get_data())
+			return source_.get()->get_data() + source_offset_;
+
+		return get_view(0).data();
+	}
+
+	return stored_data().data();
+}
+
+//Returns length of raw section data
+uint32_t section::get_raw_data_length() const
+{
+	if(source_.get())
+		return source_size_;
+
+	//If virtual memory is mapped, raw data length is stored in old_size_
+	return static_cast<uint32_t>(old_size_ != static_cast<size_t>(-1) ? old_size_ : stored_data().length());
+}
+
+//Returns true if section data references data source (and was not copied or loaded yet)
+bool section::references_data_source() const
+{
+	if(!source_.get())
+		return false;
+
+	//Data of sources, which are not stored in memory, is loaded to raw data view once
+	if(!source_.get()->get_data())
+	{
+		for(const data_view* view = static_cast<const data_view*>(pe_atomic::load_pointer(reinterpret_cast<void* volatile*>(&views_))); view; view = view->next)
+		{
+			if(!view->alignment)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+//Copies (or loads) referenced data source bytes to section raw data
+void section::detach_data_source()
+{
+	if(source_.get())
+	{
+		std::string data;
+
+		//If section data was already loaded to raw data view, take it
+		data_view* view = views_;
+		while(view && view->alignment)
+			view = view->next;
+
+		if(view)
+		{
+			data.swap(view->data);
+			reset_views();
+		}
+		else
+		{
+			data.resize(source_size_);
+			if(source_size_)
+				source_.get()->read_data(source_offset_, &data[0], source_size_);
+		}
+
+		reset_data(new memory_data_source);
+		data_->get_string().swap(data);
+		source_.reset();
+	}
+}
+
+//Returns raw (alignment = 0) or virtual data view, makes it if needed
+const std::string& section::get_view(uint32_t alignment) const
+{
+	void* volatile* list = reinterpret_cast<void* volatile*>(&views_);
+
+	for(const data_view* view = static_cast<const data_view*>(pe_atomic::load_pointer(list)); view; view = view->next)
+	{
+		if(view->alignment == alignment)
+			return view->data;
+	}
+
+	//Make new view
+	data_view* new_view = new data_view;
+	new_view->alignment = alignment;
+
+	try
+	{
+		uint32_t raw_length = get_raw_data_length();
+		if(source_.get())
+		{
+			new_view->data.resize(raw_length);
+			if(raw_length)
+				source_.get()->read_data(source_offset_, &new_view->data[0], raw_length);
+		}
+		else
+		{
+			new_view->data.assign(stored_data(), 0, raw_length);
+		}
+
+		if(alignment && get_aligned_virtual_size(alignment) > raw_length)
+			new_view->data.resize(get_aligned_virtual_size(alignment), 0);
+	}
+	catch(...)
+	{
+		delete new_view;
+		throw;
+	}
+
+	//Add view to list, if the same view was not added by other thread
+	while(true)
+	{
+		data_view* head = static_cast<data_view*>(pe_atomic::load_pointer(list));
+		for(const data_view* view = head; view; view = view->next)
+		{
+			if(view->alignment == alignment)
+			{
+				delete new_view;
+				return view->data;
+			}
+		}
+
+		new_view->next = head;
+		if(pe_atomic::compare_and_swap_pointer(list, new_view, head))
+			return new_view->data;
+	}
+}
+
+//Deletes all views (must be called before section data is changed)
+void section::reset_views()
+{
+	data_view* view = views_;
+	views_ = 0;
+
+	while(view)
+	{
+		data_view* next = view->next;
+		delete view;
+		view = next;
+	}
+}
+
+//Helper: data of section, which has no own data
+const std::string empty_section_data;
+
+//Returns section raw/virtual data
+const std::string& section::stored_data() const
+{
+	return data_ ? data_->get_string() : empty_section_data;
+}
+
+//Returns section raw/virtual data for changing, copies it if it is shared with other sections
+std::string& section::unique_data()
+{
+	if(!data_)
+		reset_data(new memory_data_source);
+	else if(data_->is_shared())
+		reset_data(new memory_data_source(data_->get_string()));
+
+	return data_->get_string();
+}
+
+//Replaces section raw/virtual data with "data" (references it, if it is not zero)
+void section::reset_data(memory_data_source* data)
+{
+	//Reference new data first, it can be the same as current one
+	if(data)
+		data->add_ref();
+
+	if(data_)
+		data_->release();
+
+	data_ = data;
 }
 
 //Maps virtual section data
-void section::map_virtual(uint32_t section_alignment) const
+void section::map_virtual(uint32_t section_alignment)
 {
 	uint32_t aligned_virtual_size = get_aligned_virtual_size(section_alignment);
-	if(old_size_ == static_cast<size_t>(-1) && aligned_virtual_size && aligned_virtual_size > raw_data_.length())
+	if(old_size_ == static_cast<size_t>(-1) && aligned_virtual_size && aligned_virtual_size > stored_data().length())
 	{
-		old_size_ = raw_data_.length();
-		raw_data_.resize(aligned_virtual_size, 0);
+		old_size_ = stored_data().length();
+		unique_data().resize(aligned_virtual_size, 0);
 	}
 }
 
 //Unmaps virtual section data
-void section::unmap_virtual() const
+void section::unmap_virtual()
 {
 	if(old_size_ != static_cast<size_t>(-1))
 	{
-		raw_data_.resize(old_size_, 0);
+		unique_data().resize(old_size_, 0);
 		old_size_ = static_cast<size_t>(-1);
 	}
 }
@@ -201,6 +497,8 @@ const pe_win::image_section_header& section::get_raw_header() const
 //Returns raw image section header
 pe_win::image_section_header& section::get_raw_header()
 {
+	//Header can be changed, so virtual data views become incorrect
+	reset_views();
 	return header_;
 }
 
@@ -232,6 +530,7 @@ uint32_t section::get_aligned_raw_size(uint32_t file_alignment) const
 //Sets size of raw section data
 void section::set_size_of_raw_data(uint32_t size_of_raw_data)
 {
+	reset_views();
 	header_.SizeOfRawData = size_of_raw_data;
 }
 
@@ -250,6 +549,7 @@ void section::set_characteristics(uint32_t characteristics)
 //Sets section virtual size
 void section::set_virtual_size(uint32_t virtual_size)
 {
+	reset_views();
 	header_.Misc.VirtualSize = virtual_size;
 }
 
@@ -259,6 +559,150 @@ void section::set_virtual_address(uint32_t virtual_address)
 	header_.VirtualAddress = virtual_address;
 }
 
+//Constructor from raw data pointer, raw data length and virtual data size
+section_data_view::section_data_view(const char* data, uint32_t raw_length, uint32_t size)
+	:data_(data), raw_length_(std::min(raw_length, size)), size_(size)
+{}
+
+//Returns size of virtual data (including zero-filled part)
+uint32_t section_data_view::get_size() const
+{
+	return size_;
+}
+
+//Returns pointer to raw data
+const char* section_data_view::get_raw_data_ptr() const
+{
+	return data_;
+}
+
+//Returns length of raw data
+uint32_t section_data_view::get_raw_data_length() const
+{
+	return raw_length_;
+}
+
+//Returns true if "size" bytes from offset "offset" are inside of zero-filled part of data
+bool section_data_view::is_zero_filled(uint32_t offset, uint32_t size) const
+{
+	return offset >= raw_length_ && offset <= size_ && size <= size_ - offset;
+}
+
+//Copies "size" bytes from offset "offset" of virtual data to "data" (checks sizes)
+void section_data_view::read_data(uint32_t offset, char* data, uint32_t size) const
+{
+	if(offset > size_ || size > size_ - offset)
+		throw pe_exception("RVA and requested data size does not exist inside section", pe_exception::rva_not_exists);
+
+	uint32_t raw_size = offset < raw_length_ ? std::min(size, raw_length_ - offset) : 0;
+	if(raw_size)
+		memcpy(data, data_ + offset, raw_size);
+
+	memset(data + raw_size, 0, size - raw_size);
+}
+
+//Reads null-terminated string from offset "offset" of virtual data
+//Returns false if string is not null-terminated inside view
+bool section_data_view::read_string(uint32_t offset, std::string& str) const
+{
+	name_view view;
+	if(!read_string(offset, view))
+		return false;
+
+	str.assign(view.get_data(), view.get_length());
+	return true;
+}
+
+//Finds null-terminated string from offset "offset" of virtual data, doesn't copy it
+//Returns false if string is not null-terminated inside view
+bool section_data_view::read_string(uint32_t offset, name_view& str) const
+{
+	if(offset >= size_)
+		return false;
+
+	//String is placed in zero-filled part of data
+	if(offset >= raw_length_)
+	{
+		str = name_view();
+		return true;
+	}
+
+	const char* begin = data_ + offset;
+	const char* end = static_cast<const char*>(memchr(begin, 0, raw_length_ - offset));
+	if(!end)
+	{
+		//String is terminated by zero-filled part of data, if there is one
+		if(size_ == raw_length_)
+			return false;
+
+		end = data_ + raw_length_;
+	}
+
+	str = name_view(begin, static_cast<uint32_t>(end - begin));
+	return true;
+}
+
+//Default constructor (empty string)
+name_view::name_view()
+	:data_(""), length_(0)
+{}
+
+//Constructor from pointer to string and its length (without terminating zero)
+name_view::name_view(const char* data, uint32_t length)
+	:data_(data), length_(length)
+{}
+
+//Returns pointer to string (it is not null-terminated)
+const char* name_view::get_data() const
+{
+	return data_;
+}
+
+//Returns length of string
+uint32_t name_view::get_length() const
+{
+	return length_;
+}
+
+//Returns true if string is empty
+bool name_view::empty() const
+{
+	return length_ == 0;
+}
+
+//Returns copy of string
+std::string name_view::to_string() const
+{
+	return std::string(data_, length_);
+}
+
+//Compares strings
+bool name_view::operator==(const name_view& other) const
+{
+	return length_ == other.length_ && !memcmp(data_, other.data_, length_);
+}
+
+bool name_view::operator==(const std::string& other) const
+{
+	return length_ == other.length() && !memcmp(data_, other.data(), length_);
+}
+
+bool name_view::operator!=(const name_view& other) const
+{
+	return !(*this == other);
+}
+
+bool name_view::operator!=(const std::string& other) const
+{
+	return !(*this == other);
+}
+
+bool name_view::operator<(const name_view& other) const
+{
+	int result = memcmp(data_, other.data_, std::min(length_, other.length_));
+	return result < 0 || (!result && length_ < other.length_);
+}
+
 //Section by file offset finder helper (4gb max)
 section_by_raw_offset::section_by_raw_offset(uint32_t offset)
 	:offset_(offset)
@@ -270,6 +714,11 @@ bool section_by_raw_offset::operator()(const section& s) const
 		&& (s.get_pointer_to_raw_data() + s.get_size_of_raw_data() > offset_);
 }
 
+bool section_virtual_address_less::operator()(uint32_t rva, const section& s) const
+{
+	return rva < s.get_virtual_address();
+}
+
 section_ptr_finder::section_ptr_finder(const section& s)
 	:s_(s)
 {}
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include "pe_structures.h"
+#include "pe_data_source.h"
 
 namespace pe_bliss
 {
@@ -12,18 +13,113 @@ enum section_data_type
 	section_data_virtual
 };
 
+//Reference to string stored in image data (pointer and length), string is not copied
+//Valid while image exists and its data is not changed
+class name_view
+{
+public:
+	//Default constructor (empty string)
+	name_view();
+	//Constructor from pointer to string and its length (without terminating zero)
+	name_view(const char* data, uint32_t length);
+
+	//Returns pointer to string (it is not null-terminated)
+	const char* get_data() const;
+	//Returns length of string
+	uint32_t get_length() const;
+	//Returns true if string is empty
+	bool empty() const;
+	//Returns copy of string
+	std::string to_string() const;
+
+	//Compares strings
+	bool operator==(const name_view& other) const;
+	bool operator==(const std::string& other) const;
+	bool operator!=(const name_view& other) const;
+	bool operator!=(const std::string& other) const;
+	bool operator<(const name_view& other) const;
+
+private:
+	const char* data_;
+	uint32_t length_;
+};
+
+//Read-only view of virtual section data, which doesn't copy section data
+//Part of virtual data, which is not present in raw data, is treated as zero-filled,
+//but is never allocated (so huge uninitialized sections cost nothing)
+//View is valid while section data is not changed
+class section_data_view
+{
+public:
+	//Constructor from raw data pointer, raw data length and virtual data size
+	section_data_view(const char* data, uint32_t raw_length, uint32_t size);
+
+	//Returns size of virtual data (including zero-filled part)
+	uint32_t get_size() const;
+	//Returns pointer to raw data
+	const char* get_raw_data_ptr() const;
+	//Returns length of raw data
+	uint32_t get_raw_data_length() const;
+
+	//Returns true if "size" bytes from offset "offset" are inside of zero-filled part of data
+	bool is_zero_filled(uint32_t offset, uint32_t size) const;
+	//Copies "size" bytes from offset "offset" of virtual data to "data" (checks sizes)
+	void read_data(uint32_t offset, char* data, uint32_t size) const;
+	//Reads null-terminated string from offset "offset" of virtual data
+	//Returns false if string is not null-terminated inside view
+	bool read_string(uint32_t offset, std::string& str) const;
+	//Finds null-terminated string from offset "offset" of virtual data, doesn't copy it
+	//Returns false if string is not null-terminated inside view
+	bool read_string(uint32_t offset, name_view& str) const;
+
+	//Returns data of type T from offset "offset" of virtual data (checks sizes)
+	template<typename T>
+	T get(uint32_t offset) const
+	{
+		//Don't check for underflow here, comparsion is unsigned
+		if(raw_length_ >= offset + sizeof(T) && offset + sizeof(T) > offset)
+			return *reinterpret_cast<const T*>(data_ + offset);
+
+		T ret;
+		read_data(offset, reinterpret_cast<char*>(&ret), sizeof(T));
+		return ret;
+	}
+
+private:
+	const char* data_;
+	uint32_t raw_length_;
+	uint32_t size_;
+};
+
 //Class representing image section
 class section
 {
 public:
 	//Default constructor
 	section();
+	//Copy constructor
+	//Section data is not copied, it is shared until one of sections changes it
+	section(const section& other);
+	//Copy assignment operator
+	section& operator=(const section& other);
+	//Destructor
+	~section();
+
+#ifdef PE_BLISS_MOVE_SEMANTICS
+	//Move constructor
+	section(section&& other) PE_BLISS_NOEXCEPT;
+	//Move assignment operator
+	section& operator=(section&& other) PE_BLISS_NOEXCEPT;
+#endif
+
+	//Exchanges contents of two sections without copying section data
+	void swap(section& other);
 
 	//Sets the name of section (stripped to 8 characters)
 	void set_name(const std::string& name);
 
 	//Returns the name of section
-	const std::string get_name() const;
+	std::string get_name() const;
 
 	//Changes attributes of section
 	section& readable(bool readable);
@@ -45,11 +141,27 @@ public:
 	//Returns raw section data from file image
 	std::string& get_raw_data();
 	//Returns raw section data from file image
+	//Const accessors don't change section, so they can be used from several threads at once
+	//If section data references data source or virtual data is mapped, immutable copy of raw data is returned
 	const std::string& get_raw_data() const;
-	//Returns mapped virtual section data
+	//Returns virtual section data (raw data, zero-filled to aligned virtual size)
+	//Zero-filled data is an immutable copy of section data, which is made once
+	//Use get_virtual_view to read virtual data without copying
 	const std::string& get_virtual_data(uint32_t section_alignment) const;
 	//Returns mapped virtual section data
 	std::string& get_virtual_data(uint32_t section_alignment);
+	//Returns view of virtual section data (raw data, zero-filled to aligned virtual size)
+	//Neither section data nor its zero-filled part are copied
+	section_data_view get_virtual_view(uint32_t section_alignment) const;
+
+	//Returns pointer to raw section data
+	//Doesn't copy section data that references data source data in memory
+	//Section data is loaded once, if data source is not stored in memory
+	const char* get_raw_data_ptr() const;
+	//Returns length of raw section data
+	uint32_t get_raw_data_length() const;
+	//Returns true if section data references data source (and was not copied or loaded yet)
+	bool references_data_source() const;
 
 public: //Header getters
 	//Returns section virtual size
@@ -81,6 +193,9 @@ public: //Setters
 	void set_characteristics(uint32_t characteristics);
 	//Sets raw section data from file image
 	void set_raw_data(const std::string& data);
+	//Sets raw section data referencing "size" bytes of "source" from "offset"
+	//No copy is made, data is copied only when it is requested for changing
+	void set_raw_data(const data_source_holder& source, uint32_t offset, uint32_t size);
 
 public: //Setters, be careful
 	//Sets section virtual size (doesn't set internal aligned virtual size, changes only header value)
@@ -95,20 +210,58 @@ private:
 	//Section header
 	pe_win::image_section_header header_;
 
+	//Immutable copy of section data, which is made by const accessors
+	struct data_view
+	{
+		//Section alignment of virtual data (0 for raw data)
+		uint32_t alignment;
+		std::string data;
+		data_view* next;
+	};
+
 	//Maps virtual section data
-	void map_virtual(uint32_t section_alignment) const;
+	void map_virtual(uint32_t section_alignment);
 
 	//Unmaps virtual section data
-	void unmap_virtual() const;
+	void unmap_virtual();
+
+	//Copies (or loads) referenced data source bytes to section raw data
+	void detach_data_source();
+
+	//Returns raw (alignment = 0) or virtual data view, makes it if needed
+	//Views are added to list atomically, so this function can be called from several threads
+	const std::string& get_view(uint32_t alignment) const;
+	//Deletes all views (must be called before section data is changed)
+	void reset_views();
+
+	//Returns section raw/virtual data
+	const std::string& stored_data() const;
+	//Returns section raw/virtual data for changing, copies it if it is shared with other sections
+	std::string& unique_data();
+	//Replaces section raw/virtual data with "data" (references it, if it is not zero)
+	void reset_data(memory_data_source* data);
 
 	//Set flag (attribute) of section
 	section& set_flag(uint32_t flag, bool setflag);
 
 	//Old size of section (stored after mapping of virtual section memory)
-	mutable std::size_t old_size_;
+	std::size_t old_size_;
+
+	//Section raw/virtual data (zero if section has no own data)
+	//Copies of section share data until it is changed
+	memory_data_source* data_;
+	//True if reference to data was returned for changing
+	//Such data can be changed by the holder of reference, so it is never shared
+	bool data_exposed_;
+
+	//Data source, which is referenced by section raw data (if any)
+	data_source_holder source_;
+	//Offset and size of section raw data inside data source
+	uint32_t source_offset_;
+	uint32_t source_size_;
 
-	//Section raw/virtual data
-	mutable std::string raw_data_;
+	//List of section data views
+	mutable data_view* volatile views_;
 };
 
 //Section by file offset finder helper (4gb max)
@@ -122,6 +275,14 @@ private:
 	uint32_t offset_;
 };
 
+//Helper: compares RVA with section virtual address
+//Used for binary search of section by RVA
+struct section_virtual_address_less
+{
+public:
+	bool operator()(uint32_t rva, const section& s) const;
+};
+
 //Helper: finder of section* in sections list
 struct section_ptr_finder
 {
@@ -0,0 +1,391 @@
+#include <string.h>
+#include <algorithm>
+#include "pe_stream_parser.h"
+#include "pe_factory.h"
+#include "pe_data_source.h"
+#include "utils.h"
+
+namespace pe_bliss
+{
+using namespace pe_win;
+
+//Destructor
+pe_stream_parser_handler::~pe_stream_parser_handler()
+{}
+
+//Called when DOS header, PE headers and section table are received
+void pe_stream_parser_handler::on_headers(const pe_base& /*image*/)
+{}
+
+//Called when raw data of section with index "section_index" is received completely
+void pe_stream_parser_handler::on_section_data(const pe_base& /*image*/, uint16_t /*section_index*/, const std::string& /*data*/)
+{}
+
+//Called when raw debug data described by "directory" is received completely
+void pe_stream_parser_handler::on_debug_data(const pe_base& /*image*/, const image_debug_directory& /*directory*/, const std::string& /*data*/)
+{}
+
+//Data source over stored data of file
+//Reading of data, which is not stored, fails and the needed size is saved
+class pe_stream_parser::stored_data_source : public data_source
+{
+public:
+	explicit stored_data_source(std::size_t size)
+		:size_(size), required_(0)
+	{}
+
+	virtual const char* get_data() const
+	{
+		return 0;
+	}
+
+	virtual std::size_t get_size() const
+	{
+		return size_;
+	}
+
+	virtual void read_data(std::size_t offset, char* data, std::size_t size) const
+	{
+		if(offset > size_ || size > size_ - offset)
+			throw pe_exception("Error reading data source", pe_exception::error_reading_file);
+
+		//Data must be stored completely in one block
+		const data_list::value_type* block = find_data(data_, offset, size);
+		if(!block)
+		{
+			required_ = std::max(required_, offset + size);
+			throw pe_exception("Error reading data source", pe_exception::error_reading_file);
+		}
+
+		if(size)
+			memcpy(data, (*block).second.data() + (offset - (*block).first), size);
+	}
+
+	//Returns stored data list
+	data_list& get_data_list()
+	{
+		return data_;
+	}
+
+	//Returns size of data, which was needed by last failed read
+	std::size_t get_required() const
+	{
+		return required_;
+	}
+
+private:
+	std::size_t size_;
+	mutable std::size_t required_;
+	data_list data_;
+};
+
+//Returns block of "data", which contains "size" bytes at offset "offset", or zero
+const pe_stream_parser::data_list::value_type* pe_stream_parser::find_data(const data_list& data, std::size_t offset, std::size_t size)
+{
+	for(data_list::const_iterator it = data.begin(); it != data.end() && (*it).first <= offset; ++it)
+	{
+		if(offset + size <= (*it).first + (*it).second.length())
+			return &*it;
+	}
+
+	return 0;
+}
+
+//Constructor, handler (if not zero) must exist while data is fed
+pe_stream_parser::pe_stream_parser(pe_stream_parser_handler* handler, bool store_section_data)
+	:handler_(handler), position_(0), headers_required_(initial_headers_size), headers_image_(0),
+	store_section_data_(store_section_data), missed_debug_data_(false)
+{}
+
+//Destructor
+pe_stream_parser::~pe_stream_parser()
+{
+	delete headers_image_;
+}
+
+//Feeds next chunk of PE file data
+void pe_stream_parser::feed(const char* data, std::size_t size)
+{
+	if(!size)
+		return;
+
+	//Only 4gb files are supported
+	if(size > pe_utils::max_dword || !pe_utils::is_sum_safe(get_position(), static_cast<uint32_t>(size)))
+		throw pe_exception("Error reading file", pe_exception::error_reading_file);
+
+	if(headers_image_)
+	{
+		capture(data, static_cast<uint32_t>(size));
+	}
+	else
+	{
+		headers_data_.append(data, size);
+		if(headers_data_.length() >= headers_required_)
+			parse_headers(false);
+	}
+}
+
+//Returns true if PE headers were received and parsed
+bool pe_stream_parser::headers_parsed() const
+{
+	return headers_image_ != 0;
+}
+
+//Returns image with headers and section table only (sections have no data)
+const pe_base& pe_stream_parser::get_headers_image() const
+{
+	if(!headers_image_)
+		throw pe_exception("PE headers were not parsed yet", pe_exception::image_nt_headers_not_found);
+
+	return *headers_image_;
+}
+
+//Returns number of bytes fed
+uint32_t pe_stream_parser::get_position() const
+{
+	return headers_image_ ? position_ : static_cast<uint32_t>(headers_data_.length());
+}
+
+//Returns true if some raw debug data was not received
+bool pe_stream_parser::has_missed_debug_data() const
+{
+	if(missed_debug_data_)
+		return true;
+
+	for(range_list::const_iterator it = pending_.begin(); it != pending_.end(); ++it)
+	{
+		if((*it).type != data_range::range_section)
+			return true;
+	}
+
+	return false;
+}
+
+//Finishes parsing (all data is fed) and returns PE image with section and raw debug data
+pe_base pe_stream_parser::finish()
+{
+	//Headers can be smaller than requested data
+	if(!headers_image_)
+		parse_headers(true);
+
+	//Parse image from stored data, source size is the size of fed data
+	//Raw debug data is not read from source, it was captured separately
+	stored_data_source* source = new stored_data_source(position_);
+	data_source_holder holder(source);
+	source->get_data_list().swap(stored_);
+	pe_base image(pe_factory::create_pe(holder, false, store_section_data_));
+
+	if(store_section_data_)
+	{
+		//Sections reference source data, check that all of it was received
+		const section_list& sections = image.get_image_sections();
+		for(section_list::const_iterator it = sections.begin(); it != sections.end(); ++it)
+		{
+			if((*it).get_size_of_raw_data()
+				&& !find_data(source->get_data_list(), pe_utils::align_down((*it).get_pointer_to_raw_data(), image.get_file_alignment()), (*it).get_size_of_raw_data()))
+				throw pe_exception("Section data was not received", pe_exception::image_section_data_not_found);
+		}
+	}
+
+	image.set_raw_debug_data_list(debug_data_);
+	return image;
+}
+
+//Tries to parse headers from headers_data_
+void pe_stream_parser::parse_headers(bool last_chunk)
+{
+	//Size of file is not known until the last chunk is fed
+	stored_data_source* source = new stored_data_source(last_chunk ? headers_data_.length() : pe_utils::max_dword);
+	data_source_holder holder(source);
+	source->get_data_list().insert(std::make_pair(0u, headers_data_));
+
+	try
+	{
+		headers_image_ = new pe_base(pe_factory::create_pe(holder, false, false));
+	}
+	catch(const pe_exception&)
+	{
+		//If headers are incomplete, wait for more data
+		if(!last_chunk && source->get_required() > headers_data_.length())
+		{
+			headers_required_ = static_cast<uint32_t>(source->get_required());
+			return;
+		}
+
+		throw;
+	}
+
+	add_image_ranges();
+
+	if(handler_)
+		handler_->on_headers(*headers_image_);
+
+	//Store data from the beginning of file and capture it to pending ranges
+	std::string data;
+	data.swap(headers_data_);
+	stored_.insert(std::make_pair(0u, data));
+	capture(data.data(), static_cast<uint32_t>(data.length()));
+}
+
+//Adds data ranges of sections and debug directory to capture
+void pe_stream_parser::add_image_ranges()
+{
+	const pe_base& image = *headers_image_;
+	const section_list& sections = image.get_image_sections();
+
+	for(section_list::size_type i = 0; i != sections.size(); ++i)
+	{
+		data_range range;
+		range.type = data_range::range_section;
+		range.offset = pe_utils::align_down(sections[i].get_pointer_to_raw_data(), image.get_file_alignment());
+		range.size = sections[i].get_size_of_raw_data();
+		range.section_index = static_cast<uint16_t>(i);
+		add_range(range);
+	}
+
+	if(!image.has_debug())
+		return;
+
+	uint32_t rva = image.get_directory_rva(image_directory_entry_debug);
+	uint32_t size = image.get_directory_size(image_directory_entry_debug);
+
+	data_range range;
+	range.type = data_range::range_debug_directory;
+
+	if(rva < image.get_size_of_headers())
+	{
+		range.offset = rva;
+	}
+	else
+	{
+		//Debug directory is read from section raw data only
+		const section* s;
+		try
+		{
+			s = &image.section_from_rva(rva);
+		}
+		catch(const pe_exception&)
+		{
+			//Don't throw any exception here, if debug info is corrupted or incorrect
+			return;
+		}
+
+		if(rva - s->get_virtual_address() >= s->get_size_of_raw_data())
+			return;
+
+		range.offset = pe_utils::align_down(s->get_pointer_to_raw_data(), image.get_file_alignment()) + rva - s->get_virtual_address();
+		size = std::min(size, s->get_size_of_raw_data() - (rva - s->get_virtual_address()));
+	}
+
+	//Capture whole IMAGE_DEBUG_DIRECTORY structures only
+	range.size = size - size % sizeof(image_debug_directory);
+	if(pe_utils::is_sum_safe(range.offset, range.size))
+		add_range(range);
+}
+
+//Adds data range to capture
+void pe_stream_parser::add_range(data_range& range)
+{
+	if(!range.size || !pe_utils::is_sum_safe(range.offset, range.size))
+		return;
+
+	if(range.offset >= position_)
+	{
+		pending_.push_back(range);
+		return;
+	}
+
+	//Range was already fed, try to find it in stored data
+	const data_list::value_type* block = find_data(stored_, range.offset, range.size);
+	if(block)
+	{
+		range.data.assign((*block).second, range.offset - (*block).first, range.size);
+		range_received(range);
+		return;
+	}
+
+	//Data was dropped and can't be received
+	if(range.type != data_range::range_section)
+		missed_debug_data_ = true;
+}
+
+//Captures chunk of data at current position to pending ranges
+void pe_stream_parser::capture(const char* data, uint32_t size)
+{
+	uint32_t end = position_ + size;
+
+	//Ranges added while processing received ranges are checked, too
+	for(range_list::size_type i = 0; i < pending_.size();)
+	{
+		data_range& range = pending_[i];
+
+		//Ranges are filled sequentially
+		uint32_t begin = range.offset + static_cast<uint32_t>(range.data.length());
+		if(begin >= position_ && begin < end)
+			range.data.append(data + (begin - position_), std::min(end, range.offset + range.size) - begin);
+
+		if(range.data.length() == range.size)
+		{
+			data_range received;
+			std::swap(received.data, range.data);
+			received.type = range.type;
+			received.offset = range.offset;
+			received.size = range.size;
+			received.section_index = range.section_index;
+			received.directory = range.directory;
+			pending_.erase(pending_.begin() + i);
+			range_received(received);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	position_ = end;
+}
+
+//Processes completely received data range
+void pe_stream_parser::range_received(data_range& range)
+{
+	switch(range.type)
+	{
+	case data_range::range_section:
+		if(handler_)
+			handler_->on_section_data(*headers_image_, range.section_index, range.data);
+
+		if(store_section_data_)
+			(*stored_.insert(std::make_pair(range.offset, std::string()))).second.swap(range.data);
+		break;
+
+	case data_range::range_debug_directory:
+		//Capture raw data of some debug info types (as pe_base does)
+		for(uint32_t pos = 0; pos < range.size; pos += sizeof(image_debug_directory))
+		{
+			const image_debug_directory& directory = *reinterpret_cast<const image_debug_directory*>(range.data.data() + pos);
+			if(!directory.PointerToRawData)
+				break;
+
+			if((directory.Type == image_debug_type_codeview
+				|| directory.Type == image_debug_type_misc
+				|| directory.Type == image_debug_type_coff)
+				&& directory.SizeOfData)
+			{
+				data_range debug_data;
+				debug_data.type = data_range::range_debug_data;
+				debug_data.offset = directory.PointerToRawData;
+				debug_data.size = directory.SizeOfData;
+				debug_data.directory = directory;
+				add_range(debug_data);
+			}
+		}
+		break;
+
+	case data_range::range_debug_data:
+		debug_data_.insert(std::make_pair(range.offset, range.data));
+		if(handler_)
+			handler_->on_debug_data(*headers_image_, range.directory, range.data);
+		break;
+	}
+}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "pe_base.h"
+#include "pe_structures.h"
+
+namespace pe_bliss
+{
+//Receives events of incremental PE parser
+//Default implementations do nothing
+class pe_stream_parser_handler
+{
+public:
+	virtual ~pe_stream_parser_handler();
+
+	//Called when DOS header, PE headers and section table are received
+	//Image sections have no data, overlay information is not available yet
+	virtual void on_headers(const pe_base& image);
+	//Called when raw data of section with index "section_index" is received completely
+	virtual void on_section_data(const pe_base& image, uint16_t section_index, const std::string& data);
+	//Called when raw debug data described by "directory" is received completely
+	virtual void on_debug_data(const pe_base& image, const pe_win::image_debug_directory& directory, const std::string& data);
+};
+
+//Incremental (push-style) PE parser
+//PE file data is fed by chunks in file order, so it can be read from pipes or network
+//Parser emits headers, section data and raw debug data as soon as they are received completely
+//Only headers, section data and raw debug data are stored, the rest of data (overlay, for example) is dropped
+//Raw debug data, which is placed in file before debug directory and outside of sections, can't be received
+class pe_stream_parser
+{
+public:
+	//Constructor, handler (if not zero) must exist while data is fed
+	//If store_section_data = false, section data is only passed to handler and is not kept,
+	//so memory usage doesn't depend on size of file; finish() returns image without section data then
+	explicit pe_stream_parser(pe_stream_parser_handler* handler = 0, bool store_section_data = true);
+	//Destructor
+	~pe_stream_parser();
+
+	//Feeds next chunk of PE file data
+	//Throws an exception, if PE headers are incorrect
+	void feed(const char* data, std::size_t size);
+
+	//Returns true if PE headers were received and parsed
+	bool headers_parsed() const;
+	//Returns image with headers and section table only (sections have no data)
+	//Throws an exception, if headers were not parsed yet
+	const pe_base& get_headers_image() const;
+	//Returns number of bytes fed
+	uint32_t get_position() const;
+	//Returns true if some raw debug data was not received (see above)
+	//Image returned by finish() doesn't have such data, as if it was not read by pe_base
+	bool has_missed_debug_data() const;
+
+	//Finishes parsing (all data is fed) and returns PE image with section and raw debug data
+	//Throws an exception, if PE file is incorrect or incomplete (including section data, which was not received)
+	//Image is equal to image read by pe_factory::create_pe, except raw debug data, which was missed
+	pe_base finish();
+
+private:
+	//Size of data, which is requested first to parse headers
+	static const uint32_t initial_headers_size = 0x1000;
+
+	//File data range, which is captured while data is fed
+	struct data_range
+	{
+		enum range_type
+		{
+			range_section,
+			range_debug_directory,
+			range_debug_data
+		};
+
+		range_type type;
+		uint32_t offset;
+		uint32_t size;
+		std::string data;
+		uint16_t section_index;
+		pe_win::image_debug_directory directory;
+	};
+
+	typedef std::vector<data_range> range_list;
+	//Stored data of file (offset - data)
+	typedef std::multimap<uint32_t, std::string> data_list;
+
+	//Returns block of "data", which contains "size" bytes at offset "offset", or zero
+	static const data_list::value_type* find_data(const data_list& data, std::size_t offset, std::size_t size);
+
+	//Data source over stored data of file
+	class stored_data_source;
+
+	pe_stream_parser_handler* handler_;
+	//Number of bytes fed (after headers are parsed)
+	uint32_t position_;
+	//Data from the beginning of file (until headers are parsed)
+	std::string headers_data_;
+	//Size of data needed to try parsing headers again
+	uint32_t headers_required_;
+	pe_base* headers_image_;
+	bool store_section_data_;
+	range_list pending_;
+	//Headers and section data
+	data_list stored_;
+	//Raw debug data (PointerToRawData - data)
+	pe_base::debug_data_list debug_data_;
+	bool missed_debug_data_;
+
+	//Tries to parse headers from headers_data_
+	//If last_chunk = false, incomplete headers are not treated as error
+	void parse_headers(bool last_chunk);
+	//Adds data ranges of sections and debug directory to capture
+	void add_image_ranges();
+	//Adds data range to capture
+	//If range was already fed, its data is taken from stored data (if any)
+	void add_range(data_range& range);
+	//Captures chunk of data at current position to pending ranges
+	void capture(const char* data, uint32_t size);
+	//Processes completely received data range
+	void range_received(data_range& range);
+
+	pe_stream_parser(const pe_stream_parser&);
+	pe_stream_parser& operator=(const pe_stream_parser&);
+};
+}
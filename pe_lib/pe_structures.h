@@ -6,6 +6,21 @@
 #define PE_BLISS_WINDOWS
 #endif
 
+//Move constructors and move assignment operators are compiled, if compiler supports rvalue references
+//Define PE_BLISS_NO_MOVE_SEMANTICS to build library without them
+#if !defined(PE_BLISS_NO_MOVE_SEMANTICS) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600))
+#define PE_BLISS_MOVE_SEMANTICS
+#endif
+
+//Move operations must not throw, otherwise standard containers copy elements instead of moving them
+#ifdef PE_BLISS_MOVE_SEMANTICS
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define PE_BLISS_NOEXCEPT throw()
+#else
+#define PE_BLISS_NOEXCEPT noexcept
+#endif
+#endif
+
 namespace pe_bliss
 {
 //Enumeration of PE types
@@ -0,0 +1,157 @@
+#include "pe_threads.h"
+#include "pe_exception.h"
+#include "pe_structures.h"
+
+#ifdef PE_BLISS_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace pe_bliss
+{
+pe_mutex::pe_mutex()
+{
+#ifdef PE_BLISS_WINDOWS
+	CRITICAL_SECTION* cs = new CRITICAL_SECTION;
+	InitializeCriticalSection(cs);
+	mutex_ = cs;
+#else
+	pthread_mutex_t* mutex = new pthread_mutex_t;
+	if(pthread_mutex_init(mutex, 0))
+	{
+		delete mutex;
+		throw pe_exception("Cannot create mutex", pe_exception::unknown_error);
+	}
+
+	mutex_ = mutex;
+#endif
+}
+
+pe_mutex::~pe_mutex()
+{
+#ifdef PE_BLISS_WINDOWS
+	DeleteCriticalSection(static_cast<CRITICAL_SECTION*>(mutex_));
+	delete static_cast<CRITICAL_SECTION*>(mutex_);
+#else
+	pthread_mutex_destroy(static_cast<pthread_mutex_t*>(mutex_));
+	delete static_cast<pthread_mutex_t*>(mutex_);
+#endif
+}
+
+void pe_mutex::lock()
+{
+#ifdef PE_BLISS_WINDOWS
+	EnterCriticalSection(static_cast<CRITICAL_SECTION*>(mutex_));
+#else
+	pthread_mutex_lock(static_cast<pthread_mutex_t*>(mutex_));
+#endif
+}
+
+void pe_mutex::unlock()
+{
+#ifdef PE_BLISS_WINDOWS
+	LeaveCriticalSection(static_cast<CRITICAL_SECTION*>(mutex_));
+#else
+	pthread_mutex_unlock(static_cast<pthread_mutex_t*>(mutex_));
+#endif
+}
+
+pe_lock::pe_lock(pe_mutex& mutex)
+	:mutex_(mutex)
+{
+	mutex_.lock();
+}
+
+pe_lock::~pe_lock()
+{
+	mutex_.unlock();
+}
+
+//Returns value of pointer "target"
+void* pe_atomic::load_pointer(void* volatile* target)
+{
+#ifdef PE_BLISS_WINDOWS
+	return InterlockedCompareExchangePointer(target, 0, 0);
+#elif defined(__ATOMIC_ACQUIRE)
+	return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#else
+	//Barrier after load orders following reads of published data
+	void* value = *target;
+	__sync_synchronize();
+	return value;
+#endif
+}
+
+//Sets "target" to "exchange", if it is equal to "comparand"
+bool pe_atomic::compare_and_swap_pointer(void* volatile* target, void* exchange, void* comparand)
+{
+#ifdef PE_BLISS_WINDOWS
+	return InterlockedCompareExchangePointer(target, exchange, comparand) == comparand;
+#else
+	return __sync_bool_compare_and_swap(target, comparand, exchange);
+#endif
+}
+
+//Starts thread
+pe_thread::pe_thread(thread_function function, void* arg)
+	:function_(function), arg_(arg), handle_(0)
+{
+#ifdef PE_BLISS_WINDOWS
+	handle_ = CreateThread(0, 0, &thread_proc, this, 0, 0);
+	if(!handle_)
+		throw pe_exception("Cannot create thread", pe_exception::unknown_error);
+#else
+	pthread_t* thread = new pthread_t;
+	if(pthread_create(thread, 0, &thread_proc, this))
+	{
+		delete thread;
+		throw pe_exception("Cannot create thread", pe_exception::unknown_error);
+	}
+
+	handle_ = thread;
+#endif
+}
+
+//Waits for thread to finish
+void pe_thread::join()
+{
+	if(!handle_)
+		return;
+
+#ifdef PE_BLISS_WINDOWS
+	WaitForSingleObject(handle_, INFINITE);
+	CloseHandle(handle_);
+#else
+	pthread_join(*static_cast<pthread_t*>(handle_), 0);
+	delete static_cast<pthread_t*>(handle_);
+#endif
+
+	handle_ = 0;
+}
+
+#ifdef PE_BLISS_WINDOWS
+unsigned long __stdcall pe_thread::thread_proc(void* thread)
+#else
+void* pe_thread::thread_proc(void* thread)
+#endif
+{
+	pe_thread* t = static_cast<pe_thread*>(thread);
+	t->function_(t->arg_);
+	return 0;
+}
+
+//Returns number of logical processors (at least 1)
+unsigned int pe_thread::get_processor_count()
+{
+#ifdef PE_BLISS_WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? static_cast<unsigned int>(count) : 1;
+#endif
+}
+}
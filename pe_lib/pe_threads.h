@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include "pe_structures.h"
+
+namespace pe_bliss
+{
+//Simple portable threading primitives used by library
+
+//Non-recursive mutex
+class pe_mutex
+{
+public:
+	pe_mutex();
+	~pe_mutex();
+
+	void lock();
+	void unlock();
+
+private:
+	//Platform-dependent mutex object
+	void* mutex_;
+
+	pe_mutex(const pe_mutex&);
+	pe_mutex& operator=(const pe_mutex&);
+};
+
+//Locks mutex while exists
+class pe_lock
+{
+public:
+	explicit pe_lock(pe_mutex& mutex);
+	~pe_lock();
+
+private:
+	pe_mutex& mutex_;
+
+	pe_lock(const pe_lock&);
+	pe_lock& operator=(const pe_lock&);
+};
+
+//Atomic operations for publishing of lazily created data
+class pe_atomic
+{
+public:
+	//Returns value of pointer "target" (acquire: data published by pointer is visible after load)
+	static void* load_pointer(void* volatile* target);
+	//Sets "target" to "exchange", if it is equal to "comparand" (full memory barrier)
+	//Returns true if value was changed
+	static bool compare_and_swap_pointer(void* volatile* target, void* exchange, void* comparand);
+};
+
+//Thread, which runs function with argument
+//Thread must be joined before destruction
+class pe_thread
+{
+public:
+	typedef void (*thread_function)(void* arg);
+
+public:
+	//Starts thread
+	pe_thread(thread_function function, void* arg);
+	//Waits for thread to finish
+	void join();
+
+	//Returns number of logical processors (at least 1)
+	static unsigned int get_processor_count();
+
+private:
+	thread_function function_;
+	void* arg_;
+	//Platform-dependent thread handle
+	void* handle_;
+
+	static
+#ifdef PE_BLISS_WINDOWS
+	unsigned long __stdcall
+#else
+	void*
+#endif
+	thread_proc(void* thread);
+
+	pe_thread(const pe_thread&);
+	pe_thread& operator=(const pe_thread&);
+};
+}
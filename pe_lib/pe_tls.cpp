@@ -128,7 +128,7 @@ void tls_info::set_raw_data(const std::string& data)
 }
 
 //If image does not have TLS, throws an exception
-const tls_info get_tls_info(const pe_base& pe)
+tls_info get_tls_info(const pe_base& pe)
 {
 	return pe.get_pe_type() == pe_type_32
 		? get_tls_info_base<pe_types_class_32>(pe)
@@ -136,7 +136,7 @@ const tls_info get_tls_info(const pe_base& pe)
 }
 
 //TLS Rebuilder
-const image_directory rebuild_tls(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start, bool write_tls_callbacks, bool write_tls_data, tls_data_expand_type expand, bool save_to_pe_header, bool auto_strip_last_section)
+image_directory rebuild_tls(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start, bool write_tls_callbacks, bool write_tls_data, tls_data_expand_type expand, bool save_to_pe_header, bool auto_strip_last_section)
 {
 	return pe.get_pe_type() == pe_type_32
 		? rebuild_tls_base<pe_types_class_32>(pe, info, tls_section, offset_from_section_start, write_tls_callbacks, write_tls_data, expand, save_to_pe_header, auto_strip_last_section)
@@ -146,7 +146,7 @@ const image_directory rebuild_tls(pe_base& pe, const tls_info& info, section& tl
 //Get TLS info
 //If image does not have TLS, throws an exception
 template<typename PEClassType>
-const tls_info get_tls_info_base(const pe_base& pe)
+tls_info get_tls_info_base(const pe_base& pe)
 {
 	tls_info ret;
 
@@ -189,9 +189,10 @@ const tls_info get_tls_info_base(const pe_base& pe)
 	if(tls_directory_data.StartAddressOfRawData && tls_directory_data.StartAddressOfRawData != tls_directory_data.EndAddressOfRawData)
 	{
 		//Read and save TLS RAW data
-		ret.set_raw_data(std::string(
-			pe.section_data_from_va(static_cast<typename PEClassType::BaseSize>(tls_directory_data.StartAddressOfRawData), section_data_virtual, true),
-			static_cast<uint32_t>(tls_directory_data.EndAddressOfRawData - tls_directory_data.StartAddressOfRawData)));
+		std::string raw_data(static_cast<uint32_t>(tls_directory_data.EndAddressOfRawData - tls_directory_data.StartAddressOfRawData), 0);
+		pe.read_data_from_rva(pe.va_to_rva(static_cast<typename PEClassType::BaseSize>(tls_directory_data.StartAddressOfRawData)),
+			&raw_data[0], static_cast<uint32_t>(raw_data.length()), true);
+		ret.set_raw_data(raw_data);
 	}
 
 	//If file has TLS callbacks
@@ -226,7 +227,7 @@ const tls_info get_tls_info_base(const pe_base& pe)
 //auto_strip_last_section - if true and TLS are placed in the last section, it will be automatically stripped
 //Note/TODO: TLS Callbacks array is not DWORD-aligned (seems to work on WinXP - Win7)
 template<typename PEClassType>
-const image_directory rebuild_tls_base(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start, bool write_tls_callbacks, bool write_tls_data, tls_data_expand_type expand, bool save_to_pe_header, bool auto_strip_last_section)
+image_directory rebuild_tls_base(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start, bool write_tls_callbacks, bool write_tls_data, tls_data_expand_type expand, bool save_to_pe_header, bool auto_strip_last_section)
 {
 	//Check that tls_section is attached to this PE image
 	if(!pe.section_attached(tls_section))
@@ -83,10 +83,10 @@ enum tls_data_expand_type
 
 //Get TLS info
 //If image does not have TLS, throws an exception
-const tls_info get_tls_info(const pe_base& pe);
+tls_info get_tls_info(const pe_base& pe);
 
 template<typename PEClassType>
-const tls_info get_tls_info_base(const pe_base& pe);
+tls_info get_tls_info_base(const pe_base& pe);
 	
 //Rebuilder of TLS structures
 //If write_tls_callbacks = true, TLS callbacks VAs will be written to their place
@@ -94,8 +94,8 @@ const tls_info get_tls_info_base(const pe_base& pe);
 //If you have chosen to rewrite raw data, only (EndAddressOfRawData - StartAddressOfRawData) bytes will be written, not the full length of string
 //representing raw data content
 //auto_strip_last_section - if true and TLS are placed in the last section, it will be automatically stripped
-const image_directory rebuild_tls(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start = 0, bool write_tls_callbacks = true, bool write_tls_data = true, tls_data_expand_type expand = tls_data_expand_raw, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_tls(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start = 0, bool write_tls_callbacks = true, bool write_tls_data = true, tls_data_expand_type expand = tls_data_expand_raw, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 
 template<typename PEClassType>
-const image_directory rebuild_tls_base(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start = 0, bool write_tls_callbacks = true, bool write_tls_data = true, tls_data_expand_type expand = tls_data_expand_raw, bool save_to_pe_header = true, bool auto_strip_last_section = true);
+image_directory rebuild_tls_base(pe_base& pe, const tls_info& info, section& tls_section, uint32_t offset_from_section_start = 0, bool write_tls_callbacks = true, bool write_tls_data = true, tls_data_expand_type expand = tls_data_expand_raw, bool save_to_pe_header = true, bool auto_strip_last_section = true);
 }
@@ -12,31 +12,31 @@ resource_bitmap_reader::resource_bitmap_reader(const pe_resource_viewer& res)
 {}
 
 //Returns bitmap data by name and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_bitmap_reader::get_bitmap_by_name(const std::wstring& name, uint32_t index) const
+std::string resource_bitmap_reader::get_bitmap_by_name(const std::wstring& name, uint32_t index) const
 {
 	return create_bitmap(res_.get_resource_data_by_name(pe_resource_viewer::resource_bitmap, name, index).get_data());
 }
 
 //Returns bitmap data by name and language (minimum checks of format correctness)
-const std::string resource_bitmap_reader::get_bitmap_by_name(uint32_t language, const std::wstring& name) const
+std::string resource_bitmap_reader::get_bitmap_by_name(uint32_t language, const std::wstring& name) const
 {
 	return create_bitmap(res_.get_resource_data_by_name(language, pe_resource_viewer::resource_bitmap, name).get_data());
 }
 
 //Returns bitmap data by ID and language (minimum checks of format correctness)
-const std::string resource_bitmap_reader::get_bitmap_by_id_lang(uint32_t language, uint32_t id) const
+std::string resource_bitmap_reader::get_bitmap_by_id_lang(uint32_t language, uint32_t id) const
 {
 	return create_bitmap(res_.get_resource_data_by_id(language, pe_resource_viewer::resource_bitmap, id).get_data());
 }
 
 //Returns bitmap data by ID and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_bitmap_reader::get_bitmap_by_id(uint32_t id, uint32_t index) const
+std::string resource_bitmap_reader::get_bitmap_by_id(uint32_t id, uint32_t index) const
 {
 	return create_bitmap(res_.get_resource_data_by_id(pe_resource_viewer::resource_bitmap, id, index).get_data());
 }
 
 //Helper function of creating bitmap header
-const std::string resource_bitmap_reader::create_bitmap(const std::string& resource_data)
+std::string resource_bitmap_reader::create_bitmap(const std::string& resource_data)
 {
 	//Create bitmap file header
 	bitmapfileheader header = {0};
@@ -58,7 +58,7 @@ uint16_t resource_cursor_icon_reader::format_icon_headers(std::string& ico_data,
 }
 
 //Returns single icon data by ID and language (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_single_icon_by_id_lang(uint32_t language, uint32_t id) const
+std::string resource_cursor_icon_reader::get_single_icon_by_id_lang(uint32_t language, uint32_t id) const
 {
 	//Get icon headers
 	std::string icon_data(lookup_icon_group_data_by_icon(id, language));
@@ -68,7 +68,7 @@ const std::string resource_cursor_icon_reader::get_single_icon_by_id_lang(uint32
 }
 
 //Returns single icon data by ID and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_single_icon_by_id(uint32_t id, uint32_t index) const
+std::string resource_cursor_icon_reader::get_single_icon_by_id(uint32_t id, uint32_t index) const
 {
 	pe_resource_viewer::resource_language_list languages(res_.list_resource_languages(pe_resource_viewer::resource_icon, id));
 	if(languages.size() <= index)
@@ -82,7 +82,7 @@ const std::string resource_cursor_icon_reader::get_single_icon_by_id(uint32_t id
 }
 
 //Returns icon data by name and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_icon_by_name(const std::wstring& name, uint32_t index) const
+std::string resource_cursor_icon_reader::get_icon_by_name(const std::wstring& name, uint32_t index) const
 {
 	std::string ret;
 
@@ -103,7 +103,7 @@ const std::string resource_cursor_icon_reader::get_icon_by_name(const std::wstri
 }
 
 //Returns icon data by name and language (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_icon_by_name(uint32_t language, const std::wstring& name) const
+std::string resource_cursor_icon_reader::get_icon_by_name(uint32_t language, const std::wstring& name) const
 {
 	std::string ret;
 
@@ -124,7 +124,7 @@ const std::string resource_cursor_icon_reader::get_icon_by_name(uint32_t languag
 }
 
 //Returns icon data by ID and language (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_icon_by_id_lang(uint32_t language, uint32_t id) const
+std::string resource_cursor_icon_reader::get_icon_by_id_lang(uint32_t language, uint32_t id) const
 {
 	std::string ret;
 
@@ -145,7 +145,7 @@ const std::string resource_cursor_icon_reader::get_icon_by_id_lang(uint32_t lang
 }
 
 //Returns icon data by ID and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_icon_by_id(uint32_t id, uint32_t index) const
+std::string resource_cursor_icon_reader::get_icon_by_id(uint32_t id, uint32_t index) const
 {
 	std::string ret;
 
@@ -211,7 +211,7 @@ bool resource_cursor_icon_reader::check_icon_presence(const std::string& icon_gr
 }
 
 //Looks up icon group by icon id and returns full icon headers if found
-const std::string resource_cursor_icon_reader::lookup_icon_group_data_by_icon(uint32_t icon_id, uint32_t language) const
+std::string resource_cursor_icon_reader::lookup_icon_group_data_by_icon(uint32_t icon_id, uint32_t language) const
 {
 	std::string icon_header_data;
 
@@ -244,7 +244,7 @@ const std::string resource_cursor_icon_reader::lookup_icon_group_data_by_icon(ui
 }
 
 //Returns single cursor data by ID and language (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_single_cursor_by_id_lang(uint32_t language, uint32_t id) const
+std::string resource_cursor_icon_reader::get_single_cursor_by_id_lang(uint32_t language, uint32_t id) const
 {
 	std::string raw_cursor_data(res_.get_resource_data_by_id(language, pe_resource_viewer::resource_cursor, id).get_data());
 	//Get cursor headers
@@ -255,7 +255,7 @@ const std::string resource_cursor_icon_reader::get_single_cursor_by_id_lang(uint
 }
 
 //Returns single cursor data by ID and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_single_cursor_by_id(uint32_t id, uint32_t index) const
+std::string resource_cursor_icon_reader::get_single_cursor_by_id(uint32_t id, uint32_t index) const
 {
 	pe_resource_viewer::resource_language_list languages(res_.list_resource_languages(pe_resource_viewer::resource_cursor, id));
 	if(languages.size() <= index)
@@ -327,7 +327,7 @@ uint16_t resource_cursor_icon_reader::format_cursor_headers(std::string& cur_dat
 }
 
 //Returns cursor data by name and language (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_cursor_by_name(uint32_t language, const std::wstring& name) const
+std::string resource_cursor_icon_reader::get_cursor_by_name(uint32_t language, const std::wstring& name) const
 {
 	std::string ret;
 
@@ -348,7 +348,7 @@ const std::string resource_cursor_icon_reader::get_cursor_by_name(uint32_t langu
 }
 
 //Returns cursor data by name and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_cursor_by_name(const std::wstring& name, uint32_t index) const
+std::string resource_cursor_icon_reader::get_cursor_by_name(const std::wstring& name, uint32_t index) const
 {
 	std::string ret;
 
@@ -369,7 +369,7 @@ const std::string resource_cursor_icon_reader::get_cursor_by_name(const std::wst
 }
 
 //Returns cursor data by ID and language (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_cursor_by_id_lang(uint32_t language, uint32_t id) const
+std::string resource_cursor_icon_reader::get_cursor_by_id_lang(uint32_t language, uint32_t id) const
 {
 	std::string ret;
 
@@ -390,7 +390,7 @@ const std::string resource_cursor_icon_reader::get_cursor_by_id_lang(uint32_t la
 }
 
 //Returns cursor data by ID and index in language directory (instead of language) (minimum checks of format correctness)
-const std::string resource_cursor_icon_reader::get_cursor_by_id(uint32_t id, uint32_t index) const
+std::string resource_cursor_icon_reader::get_cursor_by_id(uint32_t id, uint32_t index) const
 {
 	std::string ret;
 
@@ -466,7 +466,7 @@ bool resource_cursor_icon_reader::check_cursor_presence(const std::string& curso
 }
 
 //Looks up cursor group by cursor id and returns full cursor headers if found
-const std::string resource_cursor_icon_reader::lookup_cursor_group_data_by_cursor(uint32_t cursor_id, uint32_t language, const std::string& raw_cursor_data) const
+std::string resource_cursor_icon_reader::lookup_cursor_group_data_by_cursor(uint32_t cursor_id, uint32_t language, const std::string& raw_cursor_data) const
 {
 	std::string cursor_header_data;
 
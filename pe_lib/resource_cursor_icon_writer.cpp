@@ -103,7 +103,7 @@ void resource_cursor_icon_writer::add_icon(const std::string& icon_file, const r
 }
 
 //Returns free icon or cursor ID list depending on icon_place_mode
-const std::vector<uint16_t> resource_cursor_icon_writer::get_icon_or_cursor_free_id_list(pe_resource_viewer::resource_type type, icon_place_mode mode, uint32_t count)
+std::vector<uint16_t> resource_cursor_icon_writer::get_icon_or_cursor_free_id_list(pe_resource_viewer::resource_type type, icon_place_mode mode, uint32_t count)
 {
 	//Search for available icon/cursor IDs
 	std::vector<uint16_t> icon_cursor_id_list;
@@ -10,7 +10,7 @@ resource_message_list_reader::resource_message_list_reader(const pe_resource_vie
 {}
 
 //Helper function of parsing message list table
-const resource_message_list resource_message_list_reader::parse_message_list(const std::string& resource_data)
+resource_message_list resource_message_list_reader::parse_message_list(const std::string& resource_data)
 {
 	resource_message_list ret;
 
@@ -97,13 +97,13 @@ const resource_message_list resource_message_list_reader::parse_message_list(con
 }
 
 //Returns message table data by ID and index in language directory (instead of language)
-const resource_message_list resource_message_list_reader::get_message_table_by_id(uint32_t id, uint32_t index) const
+resource_message_list resource_message_list_reader::get_message_table_by_id(uint32_t id, uint32_t index) const
 {
 	return parse_message_list(res_.get_resource_data_by_id(pe_resource_viewer::resource_message_table, id, index).get_data());
 }
 
 //Returns message table data by ID and language
-const resource_message_list resource_message_list_reader::get_message_table_by_id_lang(uint32_t language, uint32_t id) const
+resource_message_list resource_message_list_reader::get_message_table_by_id_lang(uint32_t language, uint32_t id) const
 {
 	return parse_message_list(res_.get_resource_data_by_id(language, pe_resource_viewer::resource_message_table, id).get_data());
 }
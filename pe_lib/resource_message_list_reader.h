@@ -14,13 +14,13 @@ public:
 	resource_message_list_reader(const pe_resource_viewer& res);
 
 	//Returns message table data by ID and language
-	const resource_message_list get_message_table_by_id_lang(uint32_t language, uint32_t id) const;
+	resource_message_list get_message_table_by_id_lang(uint32_t language, uint32_t id) const;
 	//Returns message table data by ID and index in language directory (instead of language)
-	const resource_message_list get_message_table_by_id(uint32_t id, uint32_t index = 0) const;
+	resource_message_list get_message_table_by_id(uint32_t id, uint32_t index = 0) const;
 
 	//Helper function of parsing message list table
 	//resource_data - raw message table resource data
-	static const resource_message_list parse_message_list(const std::string& resource_data);
+	static resource_message_list parse_message_list(const std::string& resource_data);
 
 private:
 	const pe_resource_viewer& res_;
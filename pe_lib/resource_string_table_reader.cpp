@@ -8,19 +8,19 @@ resource_string_table_reader::resource_string_table_reader(const pe_resource_vie
 {}
 
 //Returns string table data by ID and index in language directory (instead of language)
-const resource_string_list resource_string_table_reader::get_string_table_by_id(uint32_t id, uint32_t index) const
+resource_string_list resource_string_table_reader::get_string_table_by_id(uint32_t id, uint32_t index) const
 {
 	return parse_string_list(id, res_.get_resource_data_by_id(pe_resource_viewer::resource_string, id, index).get_data());
 }
 
 //Returns string table data by ID and language
-const resource_string_list resource_string_table_reader::get_string_table_by_id_lang(uint32_t language, uint32_t id) const
+resource_string_list resource_string_table_reader::get_string_table_by_id_lang(uint32_t language, uint32_t id) const
 {
 	return parse_string_list(id, res_.get_resource_data_by_id(language, pe_resource_viewer::resource_string, id).get_data());
 }
 
 //Helper function of parsing string list table
-const resource_string_list resource_string_table_reader::parse_string_list(uint32_t id, const std::string& resource_data)
+resource_string_list resource_string_table_reader::parse_string_list(uint32_t id, const std::string& resource_data)
 {
 	resource_string_list ret;
 
@@ -63,7 +63,7 @@ const resource_string_list resource_string_table_reader::parse_string_list(uint3
 }
 
 //Returns string from string table by ID and language
-const std::wstring resource_string_table_reader::get_string_by_id_lang(uint32_t language, uint16_t id) const
+std::wstring resource_string_table_reader::get_string_by_id_lang(uint32_t language, uint16_t id) const
 {
 	//List strings by string table id and language
 	const resource_string_list strings(get_string_table_by_id_lang(language, (id >> 4) + 1));
@@ -75,7 +75,7 @@ const std::wstring resource_string_table_reader::get_string_by_id_lang(uint32_t
 }
 
 //Returns string from string table by ID and index in language directory (instead of language)
-const std::wstring resource_string_table_reader::get_string_by_id(uint16_t id, uint32_t index) const
+std::wstring resource_string_table_reader::get_string_by_id(uint16_t id, uint32_t index) const
 {
 	//List strings by string table id and index
 	const resource_string_list strings(get_string_table_by_id((id >> 4) + 1, index));
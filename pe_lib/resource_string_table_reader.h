@@ -17,13 +17,13 @@ public:
 
 public:
 	//Returns string table data by ID and language
-	const resource_string_list get_string_table_by_id_lang(uint32_t language, uint32_t id) const;
+	resource_string_list get_string_table_by_id_lang(uint32_t language, uint32_t id) const;
 	//Returns string table data by ID and index in language directory (instead of language)
-	const resource_string_list get_string_table_by_id(uint32_t id, uint32_t index = 0) const;
+	resource_string_list get_string_table_by_id(uint32_t id, uint32_t index = 0) const;
 	//Returns string from string table by ID and language
-	const std::wstring get_string_by_id_lang(uint32_t language, uint16_t id) const;
+	std::wstring get_string_by_id_lang(uint32_t language, uint16_t id) const;
 	//Returns string from string table by ID and index in language directory (instead of language)
-	const std::wstring get_string_by_id(uint16_t id, uint32_t index = 0) const;
+	std::wstring get_string_by_id(uint16_t id, uint32_t index = 0) const;
 
 private:
 	const pe_resource_viewer& res_;
@@ -31,6 +31,6 @@ private:
 	//Helper function of parsing string list table
 	//Id of resource is needed to calculate string IDs correctly
 	//resource_data is raw string table resource data
-	static const resource_string_list parse_string_list(uint32_t id, const std::string& resource_data);
+	static resource_string_list parse_string_list(uint32_t id, const std::string& resource_data);
 };
 }
@@ -58,7 +58,7 @@ void resource_version_info_reader::throw_incorrect_version_info()
 //file_version_info: versions and file info
 //lang_string_values_map: map of version info strings with encodings
 //translation_values_map: map of translations
-const file_version_info resource_version_info_reader::get_version_info(lang_string_values_map& string_values, translation_values_map& translations, const std::string& resource_data) const
+file_version_info resource_version_info_reader::get_version_info(lang_string_values_map& string_values, translation_values_map& translations, const std::string& resource_data) const
 {
 	//Fixed file version info
 	file_version_info ret;
@@ -255,7 +255,7 @@ const file_version_info resource_version_info_reader::get_version_info(lang_stri
 //file_version info: versions and file info
 //lang_string_values_map: map of version info strings with encodings
 //translation_values_map: map of translations
-const file_version_info resource_version_info_reader::get_version_info_by_lang(lang_string_values_map& string_values, translation_values_map& translations, uint32_t language) const
+file_version_info resource_version_info_reader::get_version_info_by_lang(lang_string_values_map& string_values, translation_values_map& translations, uint32_t language) const
 {
 	const std::string& resource_data = res_.get_root_directory() //Type directory
 		.entry_by_id(pe_resource_viewer::resource_version)
@@ -273,7 +273,7 @@ const file_version_info resource_version_info_reader::get_version_info_by_lang(l
 //file_version_info: versions and file info
 //lang_string_values_map: map of version info strings with encodings
 //translation_values_map: map of translations
-const file_version_info resource_version_info_reader::get_version_info(lang_string_values_map& string_values, translation_values_map& translations, uint32_t index) const
+file_version_info resource_version_info_reader::get_version_info(lang_string_values_map& string_values, translation_values_map& translations, uint32_t index) const
 {
 	const resource_directory::entry_list& entries = res_.get_root_directory() //Type directory
 		.entry_by_id(pe_resource_viewer::resource_version)
@@ -23,7 +23,7 @@ std::streamoff pe_utils::get_file_size(std::istream& file)
 }
 
 #ifndef PE_BLISS_WINDOWS
-const u16string pe_utils::to_ucs2(const std::wstring& str)
+u16string pe_utils::to_ucs2(const std::wstring& str)
 {
 	u16string ret;
 	if(str.empty())
@@ -49,7 +49,7 @@ const u16string pe_utils::to_ucs2(const std::wstring& str)
 	return ret;
 }
 
-const std::wstring pe_utils::from_ucs2(const u16string& str)
+std::wstring pe_utils::from_ucs2(const u16string& str)
 {
 	std::wstring ret;
 	if(str.empty())
@@ -69,8 +69,8 @@ public:
 	
 #ifndef PE_BLISS_WINDOWS
 public:
-	static const u16string to_ucs2(const std::wstring& str);
-	static const std::wstring from_ucs2(const u16string& str);
+	static u16string to_ucs2(const std::wstring& str);
+	static std::wstring from_ucs2(const u16string& str);
 #endif
 
 private:
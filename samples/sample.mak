@@ -15,7 +15,7 @@ clean:
 	rm -f $(OUTDIR)$(NAME)
 
 $(NAME): main.o
-	$(CXX) -Wall $^ -lpebliss -L../../lib -o $(NAME)
+	$(CXX) -Wall $^ -lpebliss -L../../lib -pthread -o $(NAME)
 
 main.o: $(LIBPATH)
 
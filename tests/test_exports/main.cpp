@@ -1,5 +1,7 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <list>
 #include <pe_bliss.h>
 #include "test.h"
 #ifdef PE_BLISS_WINDOWS
@@ -76,6 +78,216 @@ void test_exports(const export_info& info, const exported_functions_list& export
 	PE_TEST(exported_ordinal_exists(0xA, exports), "exported_ordinal_exists test 2", test_level_normal);
 	PE_TEST(!exported_ordinal_exists(0x1, exports), "exported_ordinal_exists test 3", test_level_normal);
 	PE_TEST(!exported_ordinal_exists(0x9, exports), "exported_ordinal_exists test 4", test_level_normal);
+
+	export_index index(exports);
+	PE_TEST(index.find_by_name("MsgBoxA") && index.find_by_name("MsgBoxA")->get_ordinal() == 7, "Export index test 1", test_level_normal);
+	PE_TEST(index.find_by_name("dll_func1") && !index.find_by_name("dll_func2") && !index.find_by_name("USER32.MessageBoxA"), "Export index test 2", test_level_normal);
+	PE_TEST(index.find_by_ordinal(0xA) && index.find_by_ordinal(0xA)->get_rva() == exports[3].get_rva(), "Export index test 3", test_level_normal);
+	PE_TEST(!index.find_by_ordinal(0x1) && !index.find_by_ordinal(0x9) && !index.find_by_ordinal(0xFFFF), "Export index test 4", test_level_normal);
+
+	uint32_t rva = 0;
+	uint16_t ordinal = 0;
+	PE_TEST(find_exported_function(image, "dll_func1", rva, ordinal) && rva == exports[0].get_rva() && ordinal == 5, "find_exported_function test 1", test_level_normal);
+	PE_TEST(find_exported_function(image, "MsgBoxA", rva, ordinal) && rva == exports[2].get_rva() && ordinal == 7, "find_exported_function test 2", test_level_normal);
+	PE_TEST(!find_exported_function(image, "dll_func2", rva, ordinal) && !find_exported_function(image, "", rva, ordinal), "find_exported_function test 3", test_level_normal);
+	PE_TEST(find_exported_function(image, 0xA) == exports[3].get_rva() && !find_exported_function(image, 0x9) && !find_exported_function(image, 0x1), "find_exported_function test 4", test_level_normal);
+
+	exported_function_view_list views;
+	PE_TEST_EXCEPTION(views = get_exported_function_views(image), "get_exported_function_views test", test_level_critical);
+	PE_TEST(views.size() == exports.size(), "Export views test 1", test_level_critical);
+	PE_TEST(views[0].get_name() == "dll_func1" && views[0].get_name().get_length() == 9, "Export views test 2", test_level_normal);
+	PE_TEST(views[2].is_forwarded() && views[2].get_forwarded_name() == "USER32.MessageBoxA", "Export views test 3", test_level_normal);
+	PE_TEST(!views[3].has_name() && views[3].get_name().empty(), "Export views test 4", test_level_normal);
+
+	bool views_equal = true;
+	for(size_t i = 0; i != views.size(); ++i)
+	{
+		exported_function func(views[i].to_exported_function());
+		views_equal = views_equal && func.get_ordinal() == exports[i].get_ordinal() && func.get_rva() == exports[i].get_rva()
+			&& func.has_name() == exports[i].has_name() && func.is_forwarded() == exports[i].is_forwarded()
+			&& (!func.has_name() || (func.get_name() == exports[i].get_name() && func.get_name_ordinal() == exports[i].get_name_ordinal()))
+			&& (!func.is_forwarded() || func.get_forwarded_name() == exports[i].get_forwarded_name());
+	}
+
+	PE_TEST(views_equal, "Export views test 5", test_level_normal);
+}
+
+void test_import_resolver(const pe_base& image, const exported_functions_list& exports, const export_info& info)
+{
+	import_resolver resolver;
+	PE_TEST_EXCEPTION(resolver.add_module(image), "Import resolver test 1", test_level_critical);
+	std::size_t test_dll = 0;
+	PE_TEST(resolver.get_module_count() == 1 && resolver.find_module("TEST_DLL", test_dll) && resolver.get_module_name(test_dll) == "test_dll.dll", "Import resolver test 2", test_level_normal);
+
+	//Incorrect export directory is reported by add_module, module is not added
+	pe_base broken(image);
+	broken.set_directory_rva(pe_win::image_directory_entry_export, broken.get_size_of_image() - 4);
+	PE_TEST_EXPECT_EXCEPTION(resolver.add_module("broken.dll", broken), pe_exception::incorrect_export_directory, "Import resolver test 20", test_level_normal);
+	PE_TEST(resolver.get_module_count() == 1 && !resolver.find_module("broken.dll", test_dll) && resolver.find_module("test_dll.dll", test_dll), "Import resolver test 21", test_level_normal);
+
+	imported_function by_name;
+	by_name.set_name("dll_func1");
+	resolved_import result(resolver.resolve("Test_Dll.dll", by_name));
+	PE_TEST(result.is_resolved() && result.get_module_index() == test_dll && result.get_rva() == exports[0].get_rva() && result.get_ordinal() == 5 && !result.get_forwarder_count(), "Import resolver test 3", test_level_normal);
+
+	//Only one hint is index of name in export name pointer table
+	uint32_t hits = 0;
+	for(uint16_t hint = 0; hint != info.get_number_of_names() + 1; ++hint)
+	{
+		by_name.set_hint(hint);
+		result = resolver.resolve("test_dll.dll", by_name);
+		if(result.is_resolved() && result.get_rva() == exports[0].get_rva() && result.is_resolved_by_hint())
+			++hits;
+	}
+
+	PE_TEST(hits == 1, "Import resolver test 4", test_level_normal);
+
+	imported_function by_ordinal;
+	by_ordinal.set_ordinal(0xA);
+	result = resolver.resolve("test_dll.dll", by_ordinal);
+	PE_TEST(result.is_resolved() && result.get_rva() == exports[3].get_rva(), "Import resolver test 5", test_level_normal);
+
+	by_ordinal.set_ordinal(0x9);
+	PE_TEST(resolver.resolve("test_dll.dll", by_ordinal).get_status() == resolved_import::function_not_found, "Import resolver test 6", test_level_normal);
+	PE_TEST(resolver.resolve("missing.dll", by_ordinal).get_status() == resolved_import::module_not_found, "Import resolver test 7", test_level_normal);
+
+	//MsgBoxA is forwarded to USER32.MessageBoxA
+	imported_function forwarded;
+	forwarded.set_name("MsgBoxA");
+	result = resolver.resolve("test_dll.dll", forwarded);
+	PE_TEST(result.get_status() == resolved_import::module_not_found && result.get_forwarder_count() == 1, "Import resolver test 8", test_level_normal);
+
+	resolver.add_module("USER32", image);
+	result = resolver.resolve("test_dll.dll", forwarded);
+	PE_TEST(result.get_status() == resolved_import::function_not_found && result.get_forwarder_count() == 1, "Import resolver test 9", test_level_normal);
+
+	//Forwarders chain: chain.MsgBoxA -> TEST_DLL.dll_func1, chain.dll_func1 -> TEST_DLL.#10
+	pe_base chain(image);
+	exported_functions_list chain_exports(exports);
+	chain_exports[0].set_forwarded_name("TEST_DLL.#10");
+	chain_exports[2].set_forwarded_name("TEST_DLL.dll_func1");
+	PE_TEST_EXCEPTION(rebuild_exports(chain, info, chain_exports, chain.section_from_directory(pe_win::image_directory_entry_export), 0, true, false), "Import resolver test 10", test_level_critical);
+	std::size_t chain_index = resolver.add_module("chain.dll", chain);
+
+	result = resolver.resolve("chain.dll", forwarded);
+	PE_TEST(result.is_resolved() && result.get_module_index() == test_dll && result.get_rva() == exports[0].get_rva() && result.get_forwarder_count() == 1, "Import resolver test 11", test_level_normal);
+	result = resolver.resolve("chain.dll", by_name);
+	PE_TEST(result.is_resolved() && result.get_module_index() == test_dll && result.get_rva() == exports[3].get_rva(), "Import resolver test 12", test_level_normal);
+	PE_TEST(resolver.get_module_name(chain_index) == "chain.dll", "Import resolver test 13", test_level_normal);
+
+	//Forwarders loop: loop.MsgBoxA -> LOOP2.dll_func1 -> LOOP.MsgBoxA
+	pe_base loop(image);
+	exported_functions_list loop_exports(exports);
+	loop_exports[0].set_forwarded_name("LOOP.MsgBoxA");
+	loop_exports[2].set_forwarded_name("LOOP2.dll_func1");
+	PE_TEST_EXCEPTION(rebuild_exports(loop, info, loop_exports, loop.section_from_directory(pe_win::image_directory_entry_export), 0, true, false), "Import resolver test 14", test_level_critical);
+	resolver.add_module("loop", loop);
+	resolver.add_module("loop2", loop);
+
+	result = resolver.resolve("loop.dll", forwarded);
+	PE_TEST(result.get_status() == resolved_import::forwarder_loop, "Import resolver test 15", test_level_normal);
+
+	//Too long forwarders chain: deep0.MsgBoxA -> DEEP1.MsgBoxA -> ... -> DEEP40.MsgBoxA -> TEST_DLL.dll_func1
+	//Results, which were cut because of chain length, must not be cached
+	std::list<pe_base> deep;
+	for(uint32_t i = 0; i <= 40; ++i)
+	{
+		deep.push_back(image);
+		std::stringstream name, forwarded_name;
+		name << "deep" << i;
+		if(i == 40)
+			forwarded_name << "TEST_DLL.dll_func1";
+		else
+			forwarded_name << "DEEP" << (i + 1) << ".MsgBoxA";
+
+		exported_functions_list deep_exports(exports);
+		deep_exports[2].set_forwarded_name(forwarded_name.str());
+		rebuild_exports(deep.back(), info, deep_exports, deep.back().section_from_directory(pe_win::image_directory_entry_export), 0, true, false);
+		resolver.add_module(name.str(), deep.back());
+	}
+
+	result = resolver.resolve("deep0.dll", forwarded);
+	PE_TEST(result.get_status() == resolved_import::forwarder_loop, "Import resolver test 18", test_level_normal);
+	result = resolver.resolve("deep20.dll", forwarded);
+	PE_TEST(result.is_resolved() && result.get_module_index() == test_dll && result.get_forwarder_count() == 21, "Import resolver test 19", test_level_normal);
+
+	//All imports of image are resolved, only USER32 library was added
+	resolved_imports_list results;
+	PE_TEST_EXCEPTION(results = resolver.resolve(image), "Import resolver test 16", test_level_critical);
+
+	imported_functions_list imports(get_imported_functions(image));
+	std::size_t count = 0;
+	bool statuses_correct = true;
+	for(imported_functions_list::const_iterator it = imports.begin(); it != imports.end(); ++it)
+	{
+		bool module_added = resolver.find_module((*it).get_name(), test_dll);
+		for(std::size_t i = 0; i != (*it).get_imported_functions().size() && count + i < results.size(); ++i)
+			statuses_correct = statuses_correct && module_added == (results[count + i].get_status() != resolved_import::module_not_found);
+
+		count += (*it).get_imported_functions().size();
+	}
+
+	PE_TEST(results.size() == count && statuses_correct, "Import resolver test 17", test_level_normal);
+}
+
+void test_api_hash(const pe_base& image, const exported_functions_list& exports)
+{
+	//Known hashes
+	PE_TEST(api_hash_table::hash(api_hash_table::hash_ror13, "LoadLibraryA", 12) == 0xEC0E4E8E, "API hash test 1", test_level_normal);
+	PE_TEST(api_hash_table::hash(api_hash_table::hash_ror13_module, "LoadLibraryA", 13, "kernel32.dll", 12) == 0x0726774C, "API hash test 2", test_level_normal);
+	PE_TEST(api_hash_table::hash(api_hash_table::hash_crc32, "123456789", 9) == 0xCBF43926, "API hash test 3", test_level_normal);
+	PE_TEST(api_hash_table::hash(api_hash_table::hash_crc32c, "123456789", 9) == 0xE3069283, "API hash test 4", test_level_normal);
+	PE_TEST(api_hash_table::hash(api_hash_table::hash_djb2, "a", 1) == 177670, "API hash test 5", test_level_normal);
+	PE_TEST(api_hash_table::hash(api_hash_table::hash_fnv1a, "a", 1) == 0xE40C292C, "API hash test 6", test_level_normal);
+
+	std::size_t named = 0;
+	for(exported_functions_list::const_iterator it = exports.begin(); it != exports.end(); ++it)
+		named += (*it).has_name() ? 1 : 0;
+
+	api_hash_table table(api_hash_table::hash_ror13 | api_hash_table::hash_crc32 | api_hash_table::hash_djb2);
+	PE_TEST_EXCEPTION(table.add_module(image), "API hash test 7", test_level_critical);
+	PE_TEST(table.get_module_count() == 1 && table.get_module_name(0) == "test_dll.dll" && table.get_hash_count() == named * 3, "API hash test 8", test_level_normal);
+	table.finalize();
+
+	uint32_t crc = api_hash_table::hash(api_hash_table::hash_crc32, "dll_func1", 9);
+	api_hash_match_list matches(table.find(crc));
+	PE_TEST(matches.size() == 1 && matches[0].get_algorithm() == api_hash_table::hash_crc32 && matches[0].get_ordinal() == 5
+		&& std::string(table.get_function_name(matches[0].get_name_offset())) == "dll_func1", "API hash test 9", test_level_normal);
+	PE_TEST(table.find(api_hash_table::hash(api_hash_table::hash_fnv1a, "dll_func1", 9)).empty(), "API hash test 10", test_level_normal);
+
+	//Second module has the same names, so each hash is found twice
+	PE_TEST(table.add_module("copy.dll", exports) == 1 && table.get_hash_count() == named * 6, "API hash test 11", test_level_normal);
+	PE_TEST_EXPECT_EXCEPTION(table.find(crc), pe_exception::unknown_error, "API hash test 14", test_level_normal);
+	table.finalize();
+
+	std::vector<uint32_t> hashes;
+	hashes.push_back(api_hash_table::hash(api_hash_table::hash_ror13, "MsgBoxA", 7));
+	hashes.push_back(0);
+	hashes.push_back(crc);
+	hashes.push_back(api_hash_table::hash(api_hash_table::hash_djb2, "dll_func1", 9));
+	matches = table.find(hashes);
+
+	bool batch_correct = matches.size() == 6;
+	for(api_hash_match_list::const_iterator it = matches.begin(); it != matches.end(); ++it)
+	{
+		batch_correct = batch_correct && (*it).get_hash() == hashes[(*it).get_query_index()]
+			&& std::string(table.get_function_name((*it).get_name_offset())) == ((*it).get_query_index() == 0 ? "MsgBoxA" : "dll_func1");
+	}
+
+	PE_TEST(batch_correct && matches[0].get_module_index() != matches[1].get_module_index(), "API hash test 12", test_level_normal);
+
+	//Modules are added by batch, table is sorted once
+	api_hash_table batch_table(api_hash_table::hash_crc32);
+	for(uint32_t i = 0; i != 8; ++i)
+		batch_table.add_module("copy.dll", exports);
+
+	batch_table.finalize();
+	matches = batch_table.find(crc);
+	bool modules_correct = matches.size() == 8;
+	for(std::size_t i = 0; i != matches.size(); ++i)
+		modules_correct = modules_correct && matches[i].get_module_index() == i;
+
+	PE_TEST(modules_correct && batch_table.get_hash_count() == named * 8, "API hash test 13", test_level_normal);
 }
 
 int main(int argc, char* argv[])
@@ -92,6 +304,8 @@ int main(int argc, char* argv[])
 	export_info info;
 	PE_TEST_EXCEPTION(exports = get_exported_functions(image, info), "Exports Parser test 1", test_level_critical);
 	test_exports(info, exports, image);
+	test_import_resolver(image, exports, info);
+	test_api_hash(image, exports);
 
 	PE_TEST_EXCEPTION(rebuild_exports(image, info, exports, image.section_from_directory(pe_win::image_directory_entry_export), 0, true, true), "Exports Rebuilder test 1", test_level_critical);
 	PE_TEST_EXCEPTION(exports = get_exported_functions(image, info), "Exports Parser test 2", test_level_critical);
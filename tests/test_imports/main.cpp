@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include <pe_bliss.h>
 #include "test.h"
 #ifdef PE_BLISS_WINDOWS
@@ -50,6 +51,47 @@ void compare_imports(const imported_functions_list& imports, const imported_func
 	}
 }
 
+//Searches for imported function, stops enumeration when function is found
+class import_finder : public import_visitor
+{
+public:
+	import_finder(const char* library_name, const char* function_name, bool skip_other_libraries)
+		:library_name_(library_name), function_name_(function_name), skip_other_libraries_(skip_other_libraries),
+		found_(false), library_count_(0), function_count_(0), thunk_rva_(0)
+	{}
+
+	virtual library_action on_library(const import_library_view& library)
+	{
+		++library_count_;
+		return skip_other_libraries_ && library.get_name() != library_name_ ? skip_functions : visit_functions;
+	}
+
+	virtual bool on_function(const import_library_view& library, const imported_function_view& func, uint32_t thunk_rva)
+	{
+		++function_count_;
+		if(library.get_name() == library_name_ && func.get_name() == function_name_)
+		{
+			found_ = true;
+			thunk_rva_ = thunk_rva;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool found() const { return found_; }
+	size_t get_library_count() const { return library_count_; }
+	size_t get_function_count() const { return function_count_; }
+	uint32_t get_thunk_rva() const { return thunk_rva_; }
+
+private:
+	std::string library_name_, function_name_;
+	bool skip_other_libraries_;
+	bool found_;
+	size_t library_count_, function_count_;
+	uint32_t thunk_rva_;
+};
+
 int main(int argc, char* argv[])
 {
 	PE_TEST_START
@@ -84,6 +126,186 @@ int main(int argc, char* argv[])
 		PE_TEST(kernel32.get_rva_to_original_iat() == 0x00022428, "Imports test 7", test_level_normal);
 		PE_TEST(user32.get_imported_functions().at(0).get_hint() == 0x219, "Imports test 8", test_level_normal);
 	}
+
+	{
+		//Views reference image data, so they are checked before image is changed
+		imported_functions_view_list views;
+		PE_TEST_EXCEPTION(views = get_imported_function_views(image), "get_imported_function_views test", test_level_critical);
+		PE_TEST(views.size() == imports.size(), "Import views test 1", test_level_critical);
+		PE_TEST(views[0].get_name() == "USER32.dll" && views[1].get_name() == std::string("KERNEL32.dll"), "Import views test 2", test_level_normal);
+
+		imported_functions_list materialized;
+		for(size_t i = 0; i != views.size(); ++i)
+			materialized.push_back(views[i].to_import_library());
+
+		compare_imports(imports, materialized);
+	}
+
+	{
+		flat_import_table table;
+		PE_TEST_EXCEPTION(get_imported_functions(image, table), "Flat import table test 1", test_level_critical);
+		PE_TEST(table.get_library_count() == imports.size()
+			&& table.get_library_function_count(0) == user32.get_imported_functions().size()
+			&& table.get_function_count() == user32.get_imported_functions().size() + kernel32.get_imported_functions().size(),
+			"Flat import table test 2", test_level_critical);
+		PE_TEST(std::string(table.get_library_name(1)) == "KERNEL32.dll" && table.get_library_first_function(1) == table.get_library_function_count(0), "Flat import table test 3", test_level_normal);
+
+		std::size_t index = 0;
+		PE_TEST(table.find_function("MessageBoxW", index) && index == 0 && table.get_function_library(index) == 0, "Flat import table test 4", test_level_normal);
+		PE_TEST(table.get_thunk_rva(index) == user32.get_rva_to_iat() && table.get_hint(index) == user32.get_imported_functions().at(0).get_hint(), "Flat import table test 5", test_level_normal);
+		PE_TEST(!table.find_function("NotImportedFunction", index), "Flat import table test 6", test_level_normal);
+
+		compare_imports(imports, table.to_imported_functions_list());
+	}
+
+	{
+		import_finder finder("USER32.dll", "MessageBoxW", false);
+		PE_TEST_EXCEPTION(enumerate_imports(image, finder), "Import visitor test 1", test_level_critical);
+		PE_TEST(finder.found() && finder.get_library_count() == 1 && finder.get_function_count() == 1 && finder.get_thunk_rva() == user32.get_rva_to_iat(), "Import visitor test 2", test_level_normal);
+
+		import_finder missing_finder("KERNEL32.dll", "NotImportedFunction", true);
+		PE_TEST_EXCEPTION(enumerate_imports(image, missing_finder), "Import visitor test 3", test_level_critical);
+		PE_TEST(!missing_finder.found() && missing_finder.get_library_count() == imports.size()
+			&& missing_finder.get_function_count() == kernel32.get_imported_functions().size(), "Import visitor test 4", test_level_normal);
+	}
+
+	{
+		dependency_graph graph;
+		PE_TEST_EXCEPTION(graph.add_image("Image.EXE", image), "Dependency graph test 1", test_level_critical);
+
+		uint32_t image_id = graph.get_module_id("image.exe");
+		uint32_t user32_id = graph.get_module_id("user32.dll");
+		uint32_t kernel32_id = graph.get_module_id("KERNEL32.DLL");
+		std::vector<uint32_t> dependencies(graph.get_dependencies(image_id));
+		PE_TEST(graph.get_image_count() == 1 && dependencies.size() == 2
+			&& std::find(dependencies.begin(), dependencies.end(), user32_id) != dependencies.end()
+			&& std::find(dependencies.begin(), dependencies.end(), kernel32_id) != dependencies.end(), "Dependency graph test 2", test_level_normal);
+
+		dependency_graph::edge edge;
+		uint32_t message_box_id = 0;
+		PE_TEST(graph.find_edge(image_id, user32_id, edge) && edge.get_image_count() == 1
+			&& graph.get_names().find("MessageBoxW", message_box_id)
+			&& std::find(edge.get_functions().begin(), edge.get_functions().end(), message_box_id) != edge.get_functions().end(), "Dependency graph test 3", test_level_normal);
+		PE_TEST(graph.get_names().get(image_id) == "image.exe", "Dependency graph test 4", test_level_normal);
+
+		//The same image as user32.dll: image.exe -> user32.dll -> (user32.dll, kernel32.dll)
+		graph.add_image("user32.dll", image);
+		PE_TEST(graph.get_dependencies(image_id, true).size() == 2 && graph.get_dependencies(user32_id).size() == 2, "Dependency graph test 5", test_level_normal);
+		PE_TEST(graph.get_dependents(kernel32_id).size() == 2 && graph.get_dependents(user32_id, true).size() == 2
+			&& graph.get_dependents(image_id, true).empty(), "Dependency graph test 6", test_level_normal);
+
+		graph.add_image("image.exe", image);
+		PE_TEST(graph.find_edge(image_id, kernel32_id, edge) && edge.get_image_count() == 2 && graph.get_edges().size() == 4, "Dependency graph test 7", test_level_normal);
+
+		std::vector<std::string> paths;
+		paths.push_back(argv[1]);
+		paths.push_back(std::string(argv[1]) + ".does_not_exist");
+
+		dependency_graph scanned;
+		PE_TEST_EXCEPTION(scanned.scan(paths, 2), "Dependency graph test 8", test_level_critical);
+		PE_TEST(scanned.get_image_count() == 1 && scanned.get_error_count() == 1 && scanned.get_edges().size() == 2, "Dependency graph test 9", test_level_normal);
+
+		//Image with incorrect import directory doesn't change graph
+		pe_base broken(image);
+		broken.set_directory_rva(pe_win::image_directory_entry_import, broken.get_size_of_image() - 4);
+		std::size_t names_count = graph.get_names().size();
+		PE_TEST_EXPECT_EXCEPTION(graph.add_image("broken.exe", broken), pe_exception::rva_not_exists, "Dependency graph test 10", test_level_normal);
+		uint32_t broken_id = 0;
+		PE_TEST(graph.get_names().size() == names_count && !graph.get_names().find("broken.exe", broken_id)
+			&& graph.get_image_count() == 3 && graph.get_edges().size() == 4, "Dependency graph test 11", test_level_normal);
+	}
+
+	{
+		PE_TEST(get_ordinal_name("WS2_32.dll", 115) && std::string(get_ordinal_name("WS2_32.dll", 115)) == "WSAStartup", "Ordinal names test 1", test_level_normal);
+		PE_TEST(get_ordinal_name("wsock32", 500) && std::string(get_ordinal_name("wsock32", 500)) == "WEP", "Ordinal names test 2", test_level_normal);
+		PE_TEST(get_ordinal_name("OleAut32.DLL", 443) && std::string(get_ordinal_name("OleAut32.DLL", 443)) == "UnRegisterTypeLibForUser"
+			&& get_ordinal_name("oleaut32.dll", 2) && std::string(get_ordinal_name("oleaut32.dll", 2)) == "SysAllocString", "Ordinal names test 3", test_level_normal);
+		PE_TEST(!get_ordinal_name("ws2_32.dll", 100) && !get_ordinal_name("ws2_32.dll", 0) && !get_ordinal_name("ws2_32.dll", 667)
+			&& !get_ordinal_name("kernel32.dll", 1) && !get_ordinal_name("ws2_32.dl", 1) && !get_ordinal_name("ws2_32x.dll", 1), "Ordinal names test 4", test_level_normal);
+
+		imported_functions_list ordinal_imports(1);
+		ordinal_imports[0].set_name("WS2_32.dll");
+		imported_function func;
+		func.set_ordinal(115);
+		ordinal_imports[0].add_import(func);
+		func.set_ordinal(1000);
+		ordinal_imports[0].add_import(func);
+		func.set_name("connect");
+		func.set_ordinal(0);
+		ordinal_imports[0].add_import(func);
+
+		PE_TEST(set_ordinal_names(ordinal_imports) == 1, "Ordinal names test 5", test_level_normal);
+		const import_library::imported_list& named = ordinal_imports[0].get_imported_functions();
+		PE_TEST(named.size() == 3 && named[0].get_name() == "WSAStartup" && named[0].get_ordinal() == 115
+			&& !named[1].has_name() && named[2].get_name() == "connect", "Ordinal names test 6", test_level_normal);
+	}
+
+	{
+		md5_hash md5;
+		PE_TEST(md5.finalize() == "d41d8cd98f00b204e9800998ecf8427e", "Imphash test 1", test_level_normal);
+		md5.reset();
+		md5.update("abc", 3);
+		PE_TEST(md5.finalize() == "900150983cd24fb0d6963f7d28e17f72", "Imphash test 2", test_level_normal);
+
+		//Data, which is added by parts crossing block boundaries
+		std::string data(1000, 'a');
+		md5.reset();
+		for(std::size_t i = 0; i < data.length(); i += 7)
+			md5.update(data.data() + i, std::min<std::size_t>(7, data.length() - i));
+		PE_TEST(md5.finalize() == "cabe45dcc9ae5b66ba86600cca6b8ba8", "Imphash test 3", test_level_normal);
+
+		//Imphash string built from parsed imports
+		std::string imphash_string;
+		for(imported_functions_list::const_iterator lib = imports.begin(); lib != imports.end(); ++lib)
+		{
+			std::string library_name((*lib).get_name());
+			std::transform(library_name.begin(), library_name.end(), library_name.begin(), ::tolower);
+			std::string::size_type dot = library_name.rfind('.');
+			if(dot != std::string::npos && (library_name.substr(dot) == ".dll" || library_name.substr(dot) == ".ocx" || library_name.substr(dot) == ".sys"))
+				library_name.erase(dot);
+
+			const import_library::imported_list& funcs = (*lib).get_imported_functions();
+			for(import_library::imported_list::const_iterator func = funcs.begin(); func != funcs.end(); ++func)
+			{
+				std::string func_name((*func).get_name());
+				std::transform(func_name.begin(), func_name.end(), func_name.begin(), ::tolower);
+				imphash_string += (imphash_string.empty() ? "" : ",") + library_name + "." + func_name;
+			}
+		}
+
+		md5.reset();
+		md5.update(imphash_string.data(), imphash_string.length());
+		std::string imphash;
+		PE_TEST_EXCEPTION(imphash = get_imphash(image), "Imphash test 4", test_level_critical);
+		PE_TEST(imphash == md5.finalize(), "Imphash test 5", test_level_normal);
+
+		uint8_t digest[md5_hash::digest_size];
+		md5.reset();
+		md5.update(imphash_string.data(), imphash_string.length());
+		md5.finalize(digest);
+		uint8_t image_digest[md5_hash::digest_size];
+		PE_TEST(get_imphash(image, image_digest) && std::equal(digest, digest + md5_hash::digest_size, image_digest), "Imphash test 6", test_level_normal);
+
+		//Functions imported by ordinal are named by ordinal names database or "ord<ordinal>"
+		imported_functions_list ordinal_imports(1);
+		ordinal_imports[0].set_name("WS2_32.dll");
+		imported_function func;
+		func.set_iat_va(1);
+		func.set_ordinal(115);
+		ordinal_imports[0].add_import(func);
+		func.set_ordinal(1000);
+		ordinal_imports[0].add_import(func);
+		func.set_name("connect");
+		ordinal_imports[0].add_import(func);
+
+		pe_base ordinal_image(image);
+		section s;
+		s.get_raw_data().resize(1);
+		import_rebuilder_settings settings;
+		settings.save_iat_and_original_iat_rvas(false);
+		PE_TEST_EXCEPTION(rebuild_imports(ordinal_image, ordinal_imports, ordinal_image.add_section(s), settings), "Imphash test 7", test_level_critical);
+		PE_TEST(get_imphash(ordinal_image) == "09cd6bd7fec193dc6140c8e96ba5c449", "Imphash test 8", test_level_normal);
+	}
 	
 	
 	imported_functions_list new_imports;
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <pe_bliss.h>
 #include <pe_bliss_resources.h>
 #include "test.h"
@@ -62,6 +63,64 @@ int main(int argc, char* argv[])
 	PE_TEST_EXCEPTION(res.add_resource("res data 3", L"ROOT", 12345, 1049, 456, 12345), "Resource Manager test 30", test_level_normal);
 	PE_TEST(res.get_resource_data_by_id(1049, L"ROOT", 12345).get_data() == "res data 3", "Resource Manager test 31", test_level_normal);
 
+	{
+		//Many resources are added in reverse order, so directories are searched by entry index
+		bool ok = true;
+		for(uint32_t id = 1000; id != 0; --id)
+		{
+			std::stringstream ss;
+			ss << "bulk " << id;
+			res.add_resource(ss.str(), pe_resource_viewer::resource_string, id, 1033);
+			res.add_resource(ss.str() + " ru", pe_resource_viewer::resource_string, id, 1049);
+		}
+
+		PE_TEST(res.get_resource_count(pe_resource_viewer::resource_string) == 1000, "Resource Manager index test 1", test_level_normal);
+		PE_TEST(res.get_resource_data_by_id(1033, pe_resource_viewer::resource_string, 1).get_data() == "bulk 1"
+			&& res.get_resource_data_by_id(1049, pe_resource_viewer::resource_string, 777).get_data() == "bulk 777 ru", "Resource Manager index test 2", test_level_normal);
+
+		//Replaced data stays at place of previous data
+		res.add_resource("replaced", pe_resource_viewer::resource_string, 500, 1049);
+		PE_TEST(res.get_resource_data_by_id(1049, pe_resource_viewer::resource_string, 500).get_data() == "replaced"
+			&& res.list_resource_languages(pe_resource_viewer::resource_string, 500).size() == 2, "Resource Manager index test 3", test_level_normal);
+
+		//Removal shifts indexed entries
+		for(uint32_t id = 2; id <= 1000; id += 2)
+			ok = res.remove_resource(pe_resource_viewer::resource_string, id) && ok;
+
+		for(uint32_t id = 1; id <= 1000; id += 2)
+			ok = res.remove_resource(pe_resource_viewer::resource_string, id, 1049) && ok;
+
+		PE_TEST(ok && res.get_resource_count(pe_resource_viewer::resource_string) == 500
+			&& !res.remove_resource(pe_resource_viewer::resource_string, 2)
+			&& res.get_resource_data_by_id(1033, pe_resource_viewer::resource_string, 999).get_data() == "bulk 999"
+			&& res.list_resource_languages(pe_resource_viewer::resource_string, 999).size() == 1, "Resource Manager index test 4", test_level_normal);
+
+		//Direct changes of entry list drop index
+		resource_directory& strings = const_cast<resource_directory_entry&>(root.entry_by_id(pe_resource_viewer::resource_string)).get_resource_directory();
+		strings.get_entry_list().erase(strings.get_entry_list().begin());
+		res.add_resource("new", pe_resource_viewer::resource_string, 2000, 1033);
+		PE_TEST(res.get_resource_count(pe_resource_viewer::resource_string) == 500
+			&& res.get_resource_data_by_id(1033, pe_resource_viewer::resource_string, 2000).get_data() == "new"
+			&& res.get_resource_data_by_id(1033, pe_resource_viewer::resource_string, 997).get_data() == "bulk 997", "Resource Manager index test 5", test_level_normal);
+
+		//Rebuilder sorts added entries
+		section s;
+		s.get_raw_data().resize(1);
+		PE_TEST_EXCEPTION(rebuild_resources(image, root, image.add_section(s), 0, true, true), "Resource Manager index test 6", test_level_critical);
+		resource_directory rebuilt_root;
+		PE_TEST_EXCEPTION(rebuilt_root = get_resources(image), "Resource Manager index test 7", test_level_critical);
+
+		pe_resource_viewer rebuilt(rebuilt_root);
+		pe_resource_viewer::resource_id_list ids(rebuilt.list_resource_ids(pe_resource_viewer::resource_string));
+		bool sorted = ids.size() == 500;
+		for(std::size_t i = 1; i < ids.size(); ++i)
+			sorted = sorted && ids[i - 1] < ids[i];
+
+		PE_TEST(sorted && ids.back() == 2000
+			&& rebuilt.get_resource_data_by_id(1033, pe_resource_viewer::resource_string, 3).get_data() == "bulk 3"
+			&& rebuilt.get_resource_data_by_id(1049, L"ROOT", 12345).get_data() == "res data 3", "Resource Manager index test 8", test_level_normal);
+	}
+
 	PE_TEST_END
 
 	return 0;
@@ -47,6 +47,32 @@ int main(int argc, char* argv[])
 	
 	PE_TEST_EXCEPTION(root = get_resources(image), "Resource Directory Parser test 1", test_level_critical);
 	test_resources(root);
+
+	{
+		//Resource data is read from image on first use
+		resource_directory lazy_root;
+		PE_TEST_EXCEPTION(lazy_root = get_resources(image, false), "Lazy resources test 1", test_level_critical);
+		const resource_data_entry& lazy_data = lazy_root.get_entry_list()[1].get_resource_directory().get_entry_list()[1].get_resource_directory().get_entry_list()[0].get_data_entry();
+		const resource_data_entry& data = root.get_entry_list()[1].get_resource_directory().get_entry_list()[1].get_resource_directory().get_entry_list()[0].get_data_entry();
+		PE_TEST(lazy_data.references_image() && !data.references_image() && lazy_data.get_size() == data.get_size() && lazy_data.get_rva() != 0, "Lazy resources test 2", test_level_normal);
+
+		section_data_view view(lazy_data.get_data_view());
+		PE_TEST(view.get_size() == data.get_size() && view.get_raw_data_length() == data.get_size()
+			&& std::string(view.get_raw_data_ptr(), view.get_raw_data_length()) == data.get_data(), "Lazy resources test 3", test_level_normal);
+		test_resources(lazy_root);
+
+		//Tree, which references image, is rebuilt to its copy
+		pe_base lazy_image(image);
+		PE_TEST_EXCEPTION(lazy_root = get_resources(lazy_image, false), "Lazy resources test 4", test_level_critical);
+		section s;
+		s.get_raw_data().resize(1);
+		PE_TEST_EXCEPTION(rebuild_resources(lazy_image, lazy_root, lazy_image.add_section(s), 0, true, true), "Lazy resources test 5", test_level_critical);
+
+		resource_directory lazy_copy(lazy_root);
+		PE_TEST(lazy_copy.get_entry_list()[1].get_resource_directory().get_entry_list()[1].get_resource_directory().get_entry_list()[0].get_data_entry().get_data() == data.get_data(), "Lazy resources test 6", test_level_normal);
+		PE_TEST_EXCEPTION(lazy_root = get_resources(lazy_image, false), "Lazy resources test 7", test_level_critical);
+		test_resources(lazy_root);
+	}
 	
 	section s;
 	s.get_raw_data().resize(1);
@@ -83,6 +109,147 @@ int main(int argc, char* argv[])
 	resource_directory& cursor_root = root.get_entry_list()[0].get_resource_directory();
 	PE_TEST(cursor_root.entry_by_name(L"test entry").get_data_entry().get_data() == "alala", "Resource named entry test", test_level_normal);
 
+	{
+		//Resources are found without parsing resource directory
+		const resource_data_entry& data = root.get_entry_list()[1].get_resource_directory().get_entry_list()[1].get_resource_directory().get_entry_list()[0].get_data_entry();
+		resource_data_entry found;
+		PE_TEST(find_resource(image, pe_resource_viewer::resource_bitmap, 102, 1049, found) && found.references_image()
+			&& found.get_codepage() == data.get_codepage() && found.get_data() == data.get_data(), "Resource path lookup test 1", test_level_normal);
+		PE_TEST(find_resource(image, pe_resource_viewer::resource_bitmap, 102, found) && found.get_data() == data.get_data(), "Resource path lookup test 2", test_level_normal);
+		PE_TEST(!find_resource(image, pe_resource_viewer::resource_bitmap, 102, 1033, found)
+			&& !find_resource(image, pe_resource_viewer::resource_bitmap, 100, found)
+			&& !find_resource(image, 12345, 102, found)
+			&& !find_resource(image, pe_resource_viewer::resource_bitmap, L"test", found), "Resource path lookup test 3", test_level_normal);
+
+		//Named entry, which has data instead of languages directory
+		PE_TEST(!find_resource(image, root.get_entry_list()[0].get_id(), L"test entry", found), "Resource path lookup test 4", test_level_normal);
+
+		//Named types and names
+		const wchar_t* names[] = {L"ZETA", L"ALPHA", L"MYTYPE", L"BETA", L"MYTYPE2"};
+		for(std::size_t i = 0; i != sizeof(names) / sizeof(names[0]); ++i)
+		{
+			resource_directory languages;
+			resource_directory_entry language;
+			language.set_id(1033);
+			language.add_data_entry(resource_data_entry(std::string("data ") + static_cast<char>('0' + i), 0));
+			languages.add_resource_directory_entry(language);
+
+			resource_directory resource_names;
+			resource_directory_entry resource_name;
+			resource_name.set_name(names[(i + 1) % (sizeof(names) / sizeof(names[0]))]);
+			resource_name.add_resource_directory(languages);
+			resource_names.add_resource_directory_entry(resource_name);
+
+			resource_directory_entry type;
+			type.set_name(names[i]);
+			type.add_resource_directory(resource_names);
+			root.add_resource_directory_entry(type);
+		}
+
+		PE_TEST_EXCEPTION(rebuild_resources(image, root, new_resource_section, 12, true, true), "Resource path lookup test 5", test_level_critical);
+		PE_TEST(find_resource(image, L"MYTYPE", L"BETA", 1033, found) && found.get_data() == "data 2"
+			&& find_resource(image, L"ZETA", L"ALPHA", found) && found.get_data() == "data 0"
+			&& find_resource(image, L"MYTYPE2", L"ZETA", found) && found.get_data() == "data 4", "Resource path lookup test 6", test_level_normal);
+		PE_TEST(!find_resource(image, L"MYTYPE", L"ALPHA", found) && !find_resource(image, L"MYTYP", L"BETA", found)
+			&& find_resource(image, pe_resource_viewer::resource_bitmap, 102, 1049, found) && found.get_data() == data.get_data(), "Resource path lookup test 7", test_level_normal);
+	}
+
+	{
+		//Flat directory built from tree and read from image
+		flat_resource_directory flat(root);
+		flat_resource_directory image_flat;
+		PE_TEST_EXCEPTION(get_resources(image, image_flat), "Flat resources test 1", test_level_critical);
+		PE_TEST(flat.get_node_count() == image_flat.get_node_count() && flat.get_child_count(0) == root.get_entry_list().size(), "Flat resources test 2", test_level_normal);
+
+		uint32_t bitmap = 0, bitmap_102 = 0, data = 0;
+		PE_TEST(image_flat.find_child(0, pe_resource_viewer::resource_bitmap, bitmap) && image_flat.find_child(bitmap, 102, bitmap_102)
+			&& image_flat.find_child(bitmap_102, 1049, data) && image_flat.includes_data(data)
+			&& image_flat.get_codepage(data) == 0x4E4 && image_flat.get_data_size(data) == 0x4EE8
+			&& image_flat.get_data(data).substr(0, 5) == std::string("\x28\0\0\0\x4f", 5), "Flat resources test 3", test_level_normal);
+
+		//Named children go before ID children and are sorted
+		uint32_t type = 0, name = 0;
+		PE_TEST(image_flat.is_named(1) && image_flat.get_name(1) == L"ALPHA" && !image_flat.is_named(image_flat.get_child_count(0))
+			&& image_flat.find_data(L"MYTYPE", L"BETA", 1033, data) && image_flat.get_data(data) == "data 2"
+			&& image_flat.find_child(0, L"ZETA", type) && image_flat.find_child(type, L"ALPHA", name) && !image_flat.includes_data(name), "Flat resources test 4", test_level_normal);
+		PE_TEST(!image_flat.find_data(L"MYTYPE", L"ALPHA", 1033, data) && !image_flat.find_child(0, L"ZZZ", type) && !image_flat.find_child(0, 12345, type)
+			&& !image_flat.find_data(root.get_entry_list()[0].get_id(), L"test entry", 0, data), "Flat resources test 5", test_level_normal);
+
+		//Copy and conversion back to tree
+		flat_resource_directory flat_copy(image_flat);
+		PE_TEST(flat_copy.get_node_count() == image_flat.get_node_count() && flat_copy.find_data(L"MYTYPE2", L"ZETA", 1033, data) && flat_copy.get_data(data) == "data 4", "Flat resources test 6", test_level_normal);
+
+		resource_directory tree(flat_copy.to_resource_directory());
+		PE_TEST(tree.get_entry_list().size() == root.get_entry_list().size()
+			&& tree.entry_by_name(L"MYTYPE").get_resource_directory().entry_by_name(L"BETA").get_resource_directory().entry_by_id(1033).get_data_entry().get_data() == "data 2", "Flat resources test 7", test_level_normal);
+		PE_TEST(tree.entry_by_id(pe_resource_viewer::resource_bitmap).get_resource_directory().entry_by_id(102).get_resource_directory().entry_by_id(1049).get_data_entry().get_data()
+			== std::string(image_flat.get_data_ptr(image_flat.get_first_child(bitmap_102)), image_flat.get_data_size(image_flat.get_first_child(bitmap_102))), "Flat resources test 8", test_level_normal);
+	}
+
+	{
+		//Identical data and names are stored once
+		resource_directory dup_root(root);
+		const wchar_t* names[] = {L"SAME", L"OTHER", L"SAME"};
+		for(std::size_t i = 0; i != sizeof(names) / sizeof(names[0]); ++i)
+		{
+			resource_directory languages;
+			uint32_t ids[] = {1049, 1033, 1031};
+			for(std::size_t j = 0; j != sizeof(ids) / sizeof(ids[0]); ++j)
+			{
+				resource_directory_entry language;
+				language.set_id(ids[j]);
+				language.add_data_entry(resource_data_entry(std::string(1000, 'x') + (j == 2 ? "y" : ""), j == 1 ? 1251 : 0));
+				languages.add_resource_directory_entry(language);
+			}
+
+			resource_directory resource_names;
+			resource_directory_entry resource_name;
+			resource_name.set_name(names[(i + 1) % (sizeof(names) / sizeof(names[0]))]);
+			resource_name.add_resource_directory(languages);
+			resource_names.add_resource_directory_entry(resource_name);
+
+			resource_directory_entry type;
+			type.set_name(names[i]);
+			type.add_resource_directory(resource_names);
+			dup_root.add_resource_directory_entry(type);
+		}
+
+		pe_base full_image(image), dup_image(image);
+		resource_directory full_root(dup_root);
+		section s;
+		s.get_raw_data().resize(1);
+		image_directory full_dir, dup_dir;
+		PE_TEST_EXCEPTION(full_dir = rebuild_resources(full_image, full_root, full_image.add_section(s), 0, true, true), "Resource dedup test 1", test_level_critical);
+		PE_TEST_EXCEPTION(dup_dir = rebuild_resources(dup_image, dup_root, dup_image.add_section(s), 0, true, true, true), "Resource dedup test 2", test_level_critical);
+		PE_TEST(dup_dir.get_size() + 6000 < full_dir.get_size(), "Resource dedup test 3", test_level_normal);
+
+		resource_directory dup_parsed;
+		PE_TEST_EXCEPTION(dup_parsed = get_resources(dup_image, false), "Resource dedup test 4", test_level_critical);
+		PE_TEST(dup_parsed.get_entry_list().size() == root.get_entry_list().size() + 3
+			&& dup_parsed.entry_by_id(pe_resource_viewer::resource_bitmap).get_resource_directory().entry_by_id(102).get_resource_directory().entry_by_id(1049).get_data_entry().get_data()
+			== root.entry_by_id(pe_resource_viewer::resource_bitmap).get_resource_directory().entry_by_id(102).get_resource_directory().entry_by_id(1049).get_data_entry().get_data(), "Resource dedup test 5", test_level_normal);
+
+		//Entries with the same data share it
+		const resource_directory& same = dup_parsed.entry_by_name(L"SAME").get_resource_directory().entry_by_name(L"OTHER").get_resource_directory();
+		const resource_directory& other = dup_parsed.entry_by_name(L"OTHER").get_resource_directory().entry_by_name(L"SAME").get_resource_directory();
+		PE_TEST(same.get_entry_list().size() == 3 && same.entry_by_id(1049).get_data_entry().get_rva() == other.entry_by_id(1049).get_data_entry().get_rva()
+			&& same.entry_by_id(1033).get_data_entry().get_rva() == same.entry_by_id(1049).get_data_entry().get_rva()
+			&& same.entry_by_id(1031).get_data_entry().get_rva() != same.entry_by_id(1049).get_data_entry().get_rva(), "Resource dedup test 6", test_level_normal);
+		PE_TEST(same.entry_by_id(1033).get_data_entry().get_codepage() == 1251 && same.entry_by_id(1049).get_data_entry().get_codepage() == 0
+			&& same.entry_by_id(1031).get_data_entry().get_data() == std::string(1000, 'x') + "y"
+			&& same.entry_by_id(1033).get_data_entry().get_data() == std::string(1000, 'x'), "Resource dedup test 7", test_level_normal);
+
+		//Tree, which references image, is rebuilt to the same image
+		section s2;
+		s2.get_raw_data().resize(1);
+		PE_TEST_EXCEPTION(rebuild_resources(dup_image, dup_parsed, dup_image.add_section(s2), 5, true, true, true), "Resource dedup test 8", test_level_critical);
+		resource_directory dup_reparsed;
+		PE_TEST_EXCEPTION(dup_reparsed = get_resources(dup_image), "Resource dedup test 9", test_level_critical);
+		PE_TEST(dup_reparsed.get_entry_list().size() == dup_root.get_entry_list().size()
+			&& dup_reparsed.entry_by_name(L"SAME").get_resource_directory().entry_by_name(L"OTHER").get_resource_directory().entry_by_id(1031).get_data_entry().get_data() == std::string(1000, 'x') + "y"
+			&& dup_reparsed.entry_by_name(L"MYTYPE").get_resource_directory().entry_by_name(L"BETA").get_resource_directory().entry_by_id(1033).get_data_entry().get_data() == "data 2", "Resource dedup test 10", test_level_normal);
+	}
+
 	PE_TEST_END
 
 	return 0;
@@ -8,6 +8,96 @@
 
 using namespace pe_bliss;
 
+//Counts events of incremental PE parser
+class counting_handler : public pe_stream_parser_handler
+{
+public:
+	counting_handler()
+		:headers(0), sections(0), debug_data(0)
+	{}
+
+	virtual void on_headers(const pe_base& /*image*/)
+	{
+		++headers;
+	}
+
+	virtual void on_section_data(const pe_base& image, uint16_t section_index, const std::string& data)
+	{
+		if(image.get_image_sections().at(section_index).get_size_of_raw_data() == data.length())
+			++sections;
+	}
+
+	virtual void on_debug_data(const pe_base& /*image*/, const pe_win::image_debug_directory& directory, const std::string& data)
+	{
+		if(directory.SizeOfData == data.length())
+			++debug_data;
+	}
+
+	int headers, sections, debug_data;
+};
+
+//Counts scanned images and errors
+class counting_scan_callback : public pe_scan_callback
+{
+public:
+	counting_scan_callback()
+		:images(0), errors(0), imports(0)
+	{}
+
+	virtual void on_image(std::size_t /*index*/, const std::string& /*path*/, pe_base& image)
+	{
+		std::size_t count = get_imported_functions(image).size();
+
+		pe_lock lock(mutex);
+		++images;
+		imports += count;
+	}
+
+	virtual void on_error(std::size_t /*index*/, const std::string& /*path*/, const pe_exception& /*error*/)
+	{
+		pe_lock lock(mutex);
+		++errors;
+	}
+
+	pe_mutex mutex;
+	std::size_t images, errors, imports;
+};
+
+//Reads shared constant image from several threads
+struct concurrent_reader
+{
+	const pe_base* image;
+	std::size_t imports;
+	std::string virtual_data;
+	bool ok;
+
+	static void run(void* arg)
+	{
+		concurrent_reader& reader = *static_cast<concurrent_reader*>(arg);
+		try
+		{
+			for(int i = 0; i != 20; ++i)
+			{
+				reader.imports = get_imported_functions(*reader.image).size();
+
+				const section_list& sections = reader.image->get_image_sections();
+				reader.virtual_data.clear();
+				for(section_list::const_iterator it = sections.begin(); it != sections.end(); ++it)
+				{
+					reader.virtual_data += (*it).get_virtual_data(reader.image->get_section_alignment());
+					reader.virtual_data += (*it).get_raw_data();
+				}
+			}
+
+			reader.ok = true;
+		}
+		catch(const pe_exception&)
+		{
+			reader.ok = false;
+		}
+	}
+};
+
 int main(int argc, char* argv[])
 {
 	PE_TEST_START
@@ -230,6 +320,24 @@ int main(int argc, char* argv[])
 	PE_TEST(image->section_from_file_offset(0x401).get_name() == ".text", "Section test 4", test_level_normal);
 	PE_TEST(image->rva_from_section_offset(image->get_image_sections().at(0), 0x5) == 0x1005, "Section test 5", test_level_normal);
 
+	{
+		const section_list& sections = image->get_image_sections();
+		bool found = true;
+		for(section_list::const_iterator it = sections.begin(); it != sections.end(); ++it)
+		{
+			uint32_t last_rva = (*it).get_virtual_address() + (*it).get_aligned_virtual_size(image->get_section_alignment()) - 1;
+			found = found && &image->section_from_rva((*it).get_virtual_address()) == &*it && &image->section_from_rva(last_rva) == &*it;
+		}
+
+		PE_TEST(found, "Section by RVA test 1", test_level_normal);
+		PE_TEST_EXPECT_EXCEPTION(image->section_from_rva(image->get_size_of_image() + 0x1000), pe_exception::no_section_found, "Section by RVA test 2", test_level_normal);
+
+		//Sections are searched even if section list is not sorted
+		pe_base unsorted_image(*image);
+		std::swap(unsorted_image.get_image_sections().front(), unsorted_image.get_image_sections().back());
+		PE_TEST(unsorted_image.section_from_rva(0x1000).get_name() == ".text", "Section by RVA test 3", test_level_normal);
+	}
+
 	{
 		const section& s = image->get_image_sections().at(0);
 		PE_TEST(image->section_data_length_from_rva(s.get_virtual_address() + 123, section_data_raw, false) == s.get_raw_data().size(), "Section test 6", test_level_normal);
@@ -379,6 +487,51 @@ int main(int argc, char* argv[])
 		PE_TEST(!s.empty(), "Section class test 12", test_level_normal);
 	}
 
+	{
+		//Section data is exchanged without copying
+		section first, second;
+		first.set_raw_data(std::string(0x1000, 'a'));
+		first.set_name(".first");
+		const char* data = first.get_raw_data_ptr();
+		second.swap(first);
+		PE_TEST(second.get_raw_data_ptr() == data && second.get_name() == ".first" && first.empty(), "Section swap test", test_level_normal);
+
+#ifdef PE_BLISS_MOVE_SEMANTICS
+		section moved(std::move(second));
+		PE_TEST(moved.get_raw_data_ptr() == data && moved.get_name() == ".first", "Section move test", test_level_normal);
+#endif
+	}
+
+	{
+		//Copies of image share section data until it is changed
+		pe_base clone(*image);
+		section& first = clone.get_image_sections().at(0);
+		PE_TEST(first.get_raw_data_ptr() == image->get_image_sections().at(0).get_raw_data_ptr(), "Copy-on-write test 1", test_level_normal);
+
+		first.get_raw_data()[0] = ~image->get_image_sections().at(0).get_raw_data_ptr()[0];
+		PE_TEST(first.get_raw_data_ptr() != image->get_image_sections().at(0).get_raw_data_ptr()
+			&& first.get_raw_data()[0] != image->get_image_sections().at(0).get_raw_data_ptr()[0], "Copy-on-write test 2", test_level_normal);
+
+		//Section, which data can be changed through returned reference, doesn't share data
+		section copy(first);
+		PE_TEST(copy.get_raw_data_ptr() != first.get_raw_data_ptr() && copy.get_raw_data() == first.get_raw_data(), "Copy-on-write test 3", test_level_normal);
+	}
+
+	{
+		//Huge zero-filled part of virtual data is not allocated
+		section s;
+		s.set_raw_data(std::string("abc\0def", 7));
+		s.set_virtual_size(0x40000000);
+		section_data_view view(s.get_virtual_view(0x1000));
+		PE_TEST(view.get_size() == 0x40000000 && view.get_raw_data_length() == 7, "Virtual view test 1", test_level_normal);
+		PE_TEST(view.get<uint32_t>(4) == 0x00666564 && view.get<uint32_t>(0x3FFFFFFC) == 0, "Virtual view test 2", test_level_normal);
+
+		std::string str;
+		PE_TEST(view.read_string(0, str) && str == "abc" && view.read_string(4, str) && str == "def", "Virtual view test 3", test_level_normal);
+		PE_TEST(view.is_zero_filled(7, 0x3FFFFFF9) && !view.is_zero_filled(6, 2), "Virtual view test 4", test_level_normal);
+		PE_TEST_EXPECT_EXCEPTION(view.get<uint32_t>(0x3FFFFFFE), pe_exception::rva_not_exists, "Virtual view test 5", test_level_normal);
+	}
+
 	{
 		section s;
 		PE_TEST_EXPECT_EXCEPTION(image->prepare_section(s), pe_exception::zero_section_sizes, "Prepare Section test 1", test_level_normal);
@@ -490,6 +643,239 @@ int main(int argc, char* argv[])
 		PE_TEST(new_pe_after_rebuild->get_number_of_sections() == 0, "Empty PE Read test 2", test_level_normal);
 	}
 
+	{
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		pe_base original_image(pe_factory::create_pe(original_file));
+
+		std::auto_ptr<pe_base> mapped_image;
+		PE_TEST_EXCEPTION(mapped_image.reset(new pe_base(pe_factory::create_pe_mapped(argv[1]))), "Mapped PE creation test", test_level_critical);
+		PE_TEST(mapped_image->get_number_of_sections() == original_image.get_number_of_sections(), "Mapped PE test 1", test_level_critical);
+
+		const section_list& mapped_sections = mapped_image->get_image_sections();
+		const section_list& original_sections = original_image.get_image_sections();
+		for(section_list::size_type i = 0; i != mapped_sections.size(); ++i)
+		{
+			PE_TEST(mapped_sections[i].references_data_source(), "Mapped PE test 2", test_level_normal);
+			PE_TEST(mapped_sections[i].get_raw_data_length() == original_sections[i].get_raw_data().length()
+				&& !memcmp(mapped_sections[i].get_raw_data_ptr(), original_sections[i].get_raw_data().data(), mapped_sections[i].get_raw_data_length()), "Mapped PE test 3", test_level_normal);
+		}
+
+		PE_TEST(get_imported_functions(*mapped_image).size() == get_imported_functions(original_image).size(), "Mapped PE test 4", test_level_normal);
+		PE_TEST(mapped_sections[0].references_data_source(), "Mapped PE test 5", test_level_normal);
+
+		//Copy of section data is made when section data is requested for modification
+		mapped_image->get_image_sections()[0].get_raw_data();
+		PE_TEST(!mapped_sections[0].references_data_source(), "Mapped PE test 6", test_level_normal);
+		PE_TEST(mapped_sections[0].get_raw_data() == original_sections[0].get_raw_data(), "Mapped PE test 7", test_level_normal);
+	}
+
+	{
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		std::string file_data((std::istreambuf_iterator<char>(original_file)), std::istreambuf_iterator<char>());
+
+		//Caller's holder keeps the source, images only add references
+		data_source_holder source(new memory_data_source(file_data));
+		{
+			pe_base image(pe_factory::create_pe(source));
+			PE_TEST(source.get()->is_shared() && image.get_image_sections()[0].references_data_source(), "Data source PE test 1", test_level_normal);
+			pe_base headers_image(pe_factory::create_pe(source, false, false));
+		}
+
+		PE_TEST(!source.get()->is_shared(), "Data source PE test 2", test_level_normal);
+		PE_TEST_EXPECT_EXCEPTION(pe_factory::create_pe(data_source_holder()), pe_exception::error_reading_file, "Data source PE test 3", test_level_normal);
+	}
+
+	{
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		pe_base original_image(pe_factory::create_pe(original_file));
+
+		std::ifstream lazy_file(argv[1], std::ios::in | std::ios::binary);
+		std::auto_ptr<pe_base> lazy_image;
+		PE_TEST_EXCEPTION(lazy_image.reset(new pe_base(pe_factory::create_pe_lazy(lazy_file, false))), "Lazy PE creation test", test_level_critical);
+		PE_TEST(lazy_image->get_number_of_sections() == original_image.get_number_of_sections(), "Lazy PE test 1", test_level_critical);
+
+		const section_list& lazy_sections = lazy_image->get_image_sections();
+		const section_list& original_sections = original_image.get_image_sections();
+		for(section_list::size_type i = 0; i != lazy_sections.size(); ++i)
+		{
+			PE_TEST(lazy_sections[i].references_data_source()
+				&& lazy_sections[i].get_raw_data_length() == original_sections[i].get_raw_data().length(), "Lazy PE test 2", test_level_normal);
+		}
+
+		//Only section with import directory is loaded
+		PE_TEST(get_imported_functions(*lazy_image).size() == get_imported_functions(original_image).size(), "Lazy PE test 3", test_level_normal);
+		PE_TEST(lazy_sections[0].references_data_source(), "Lazy PE test 4", test_level_normal);
+		PE_TEST(!lazy_image->section_from_directory(pe_win::image_directory_entry_import).references_data_source(), "Lazy PE test 5", test_level_normal);
+
+		for(section_list::size_type i = 0; i != lazy_sections.size(); ++i)
+		{
+			PE_TEST(lazy_sections[i].get_raw_data() == original_sections[i].get_raw_data()
+				&& !lazy_sections[i].references_data_source(), "Lazy PE test 6", test_level_normal);
+		}
+	}
+
+	{
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		pe_base original_image(pe_factory::create_pe(original_file));
+
+		std::ifstream headers_file(argv[1], std::ios::in | std::ios::binary);
+		std::auto_ptr<pe_base> headers_image;
+		PE_TEST_EXCEPTION(headers_image.reset(new pe_base(pe_factory::create_pe_headers(headers_file))), "Headers PE creation test", test_level_critical);
+		PE_TEST(headers_image->get_pe_type() == original_image.get_pe_type()
+			&& headers_image->get_machine() == original_image.get_machine()
+			&& headers_image->get_subsystem() == original_image.get_subsystem()
+			&& headers_image->get_ep() == original_image.get_ep()
+			&& headers_image->get_size_of_image() == original_image.get_size_of_image()
+			&& headers_image->get_directory_rva(pe_win::image_directory_entry_import) == original_image.get_directory_rva(pe_win::image_directory_entry_import)
+			&& headers_image->has_overlay() == original_image.has_overlay(), "Headers PE test 1", test_level_normal);
+		PE_TEST(headers_image->get_number_of_sections() == original_image.get_number_of_sections(), "Headers PE test 2", test_level_critical);
+
+		const section_list& headers_sections = headers_image->get_image_sections();
+		const section_list& original_sections = original_image.get_image_sections();
+		for(section_list::size_type i = 0; i != headers_sections.size(); ++i)
+		{
+			PE_TEST(headers_sections[i].get_name() == original_sections[i].get_name()
+				&& headers_sections[i].get_size_of_raw_data() == original_sections[i].get_size_of_raw_data()
+				&& headers_sections[i].empty() && !headers_sections[i].references_data_source(), "Headers PE test 3", test_level_normal);
+		}
+	}
+
+	{
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		pe_base original_image(pe_factory::create_pe(original_file));
+
+		//Feed file by small chunks
+		std::ifstream stream_file(argv[1], std::ios::in | std::ios::binary);
+		counting_handler handler;
+		pe_stream_parser parser(&handler);
+		char buf[777];
+		while(stream_file.read(buf, sizeof(buf)) || stream_file.gcount())
+			PE_TEST_EXCEPTION(parser.feed(buf, static_cast<std::size_t>(stream_file.gcount())), "Stream parser feed test", test_level_critical);
+
+		PE_TEST(parser.headers_parsed() && handler.headers == 1, "Stream parser test 1", test_level_critical);
+		PE_TEST(handler.sections == original_image.get_number_of_sections(), "Stream parser test 2", test_level_normal);
+		PE_TEST(static_cast<std::size_t>(handler.debug_data) == original_image.get_raw_debug_data_list().size(), "Stream parser test 3", test_level_normal);
+
+		std::auto_ptr<pe_base> stream_image;
+		PE_TEST_EXCEPTION(stream_image.reset(new pe_base(parser.finish())), "Stream parser finish test", test_level_critical);
+		PE_TEST(stream_image->get_number_of_sections() == original_image.get_number_of_sections()
+			&& stream_image->has_overlay() == original_image.has_overlay()
+			&& stream_image->get_full_headers_data() == original_image.get_full_headers_data()
+			&& stream_image->get_raw_debug_data_list() == original_image.get_raw_debug_data_list(), "Stream parser test 4", test_level_normal);
+
+		const section_list& stream_sections = stream_image->get_image_sections();
+		const section_list& original_sections = original_image.get_image_sections();
+		for(section_list::size_type i = 0; i != stream_sections.size(); ++i)
+			PE_TEST(stream_sections[i].get_raw_data() == original_sections[i].get_raw_data(), "Stream parser test 5", test_level_normal);
+
+		PE_TEST(get_imported_functions(*stream_image).size() == get_imported_functions(original_image).size(), "Stream parser test 6", test_level_normal);
+
+		pe_stream_parser incomplete_parser;
+		PE_TEST_EXCEPTION(incomplete_parser.feed(original_image.get_full_headers_data().data(), original_image.get_full_headers_data().length()), "Stream parser incomplete data test 1", test_level_normal);
+		PE_TEST_EXPECT_EXCEPTION(incomplete_parser.finish(), pe_exception::section_incorrect_addr_or_size, "Stream parser incomplete data test 2", test_level_normal);
+
+		//Section data is only passed to handler
+		PE_TEST(!parser.has_missed_debug_data(), "Stream parser test 7", test_level_normal);
+		counting_handler headers_handler;
+		pe_stream_parser headers_parser(&headers_handler, false);
+		std::string file_data(original_image.get_full_headers_data());
+		for(section_list::size_type i = 0; i != original_sections.size(); ++i)
+		{
+			file_data.resize(pe_utils::align_down(original_sections[i].get_pointer_to_raw_data(), original_image.get_file_alignment()), 0);
+			file_data += original_sections[i].get_raw_data();
+		}
+
+		for(std::size_t pos = 0; pos < file_data.length(); pos += 100)
+			headers_parser.feed(file_data.data() + pos, std::min<std::size_t>(100, file_data.length() - pos));
+
+		pe_base headers_image(headers_parser.finish());
+		PE_TEST(headers_handler.sections == original_image.get_number_of_sections()
+			&& headers_image.get_number_of_sections() == original_image.get_number_of_sections()
+			&& headers_image.get_image_sections()[0].empty()
+			&& headers_image.get_raw_debug_data_list().size() == static_cast<std::size_t>(headers_handler.debug_data), "Stream parser test 8", test_level_normal);
+	}
+
+	{
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		pe_base original_image(pe_factory::create_pe(original_file));
+
+		std::vector<std::string> paths(50, argv[1]);
+		paths[25] = "nonexistent_file.exe";
+
+		counting_scan_callback callback;
+		PE_TEST_EXCEPTION(pe_factory::scan(paths, callback, 4), "Scan test 1", test_level_normal);
+		PE_TEST(callback.images == 49 && callback.errors == 1, "Scan test 2", test_level_normal);
+		PE_TEST(callback.imports == 49 * get_imported_functions(original_image).size(), "Scan test 3", test_level_normal);
+
+		//Default error handler stops scanning
+		class default_scan_callback : public pe_scan_callback
+		{
+		public:
+			virtual void on_image(std::size_t, const std::string&, pe_base&)
+			{}
+		} default_callback;
+
+		PE_TEST_EXPECT_EXCEPTION(pe_factory::scan(paths, default_callback), pe_exception::error_reading_file, "Scan test 4", test_level_normal);
+
+		//Exception type of callback is kept
+		class throwing_scan_callback : public pe_scan_callback
+		{
+		public:
+			virtual void on_image(std::size_t, const std::string&, pe_base&)
+			{
+				throw std::bad_alloc();
+			}
+		} throwing_callback;
+
+		bool bad_alloc_caught = false;
+		try
+		{
+			pe_factory::scan(paths, throwing_callback, 4);
+		}
+		catch(const std::bad_alloc&)
+		{
+			bad_alloc_caught = true;
+		}
+		catch(...)
+		{
+		}
+
+		PE_TEST(bad_alloc_caught, "Scan test 5", test_level_normal);
+	}
+
+	{
+		//Constant image is shared between threads without locking
+		std::ifstream lazy_file(argv[1], std::ios::in | std::ios::binary);
+		const pe_base shared_image(pe_factory::create_pe_lazy(lazy_file, false));
+
+		concurrent_reader readers[4];
+		std::vector<pe_thread*> threads;
+		for(int i = 0; i != 4; ++i)
+		{
+			readers[i].image = &shared_image;
+			readers[i].ok = false;
+			threads.push_back(new pe_thread(&concurrent_reader::run, &readers[i]));
+		}
+
+		for(int i = 0; i != 4; ++i)
+		{
+			threads[i]->join();
+			delete threads[i];
+		}
+
+		std::ifstream original_file(argv[1], std::ios::in | std::ios::binary);
+		pe_base original_image(pe_factory::create_pe(original_file));
+		concurrent_reader expected;
+		expected.image = &original_image;
+		concurrent_reader::run(&expected);
+
+		bool ok = expected.ok;
+		for(int i = 0; i != 4; ++i)
+			ok = ok && readers[i].ok && readers[i].imports == expected.imports && readers[i].virtual_data == expected.virtual_data;
+
+		PE_TEST(ok, "Concurrent readers test", test_level_normal);
+	}
+
 	PE_TEST_END
 
 	return 0;